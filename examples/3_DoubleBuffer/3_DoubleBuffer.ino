@@ -11,6 +11,15 @@
  Please note that double buffering isn't a silver bullet, and may still result in flickering 
  if you end up 'flipping' the buffer quicker than the physical HUB75 refresh output rate. 
 
+ If the drawing routine must never wait on the panel, set mxconfig.triple_buff = true; instead.
+ flipDMABuffer() then queues the finished frame and hands back a third buffer to draw into straight
+ away, for the cost of a third framebuffer (see MatrixPanel_I2S_DMA::printMemoryReport()).
+
+ Each buffer only holds what was drawn into it, which is why this example clears and redraws the
+ whole screen every frame. Build with -DUSE_DIRTY_TRACKING and flipDMABuffer() copies the changed
+ pixels across, so the back buffer starts off holding the frame just shown and only what moves
+ needs to be drawn.
+
  Refer to the runtime debug output to see, i.e:
 
 [  2103][I][ESP32-HUB75-MatrixPanel-I2S-DMA.cpp:85] setupDMA(): [I2S-DMA] Minimum visual refresh rate (scan rate from panel top to bottom) requested: 60 Hz
@@ -87,10 +96,9 @@ void loop()
 {
 
   // Flip all future drawPixel calls to write to the back buffer which is NOT being displayed.
-  display->flipDMABuffer(); 
-
-  // SUPER IMPORTANT: Wait at least long enough to ensure that a "frame" has been displayed on the LED Matrix Panel before the next flip!
-  delay(1000/display->calculated_refresh_rate);  
+  // SUPER IMPORTANT: The buffer we get back may still be going out to the LED Matrix Panel, wait = true blocks
+  // until the DMA has finished with it. Use display->isBackBufferFree() instead to do other work in the meantime.
+  display->flipDMABuffer(true); 
 
   // Now clear the back-buffer we are drawing to.
   display->clearScreen();   
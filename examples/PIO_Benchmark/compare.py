@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Compare two runs of the PIO_Benchmark firmware (or of testing/host_bench)
+
+Each run is either the captured serial output of the firmware, from which the JSON between the
+BENCH_JSON_BEGIN / BENCH_JSON_END lines is taken, or a JSON file.
+
+    python3 compare.py before.log after.log [--threshold 5] [--fail]
+
+Prints the change of every benchmark in both runs (CPU cycles if both have them, otherwise time) and of
+the memory begin() used, marking changes beyond the threshold. With --fail the exit code is 1 if anything
+got slower or used more memory by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+
+    begin = text.find("BENCH_JSON_BEGIN")
+    if begin >= 0:
+        end = text.find("BENCH_JSON_END", begin)
+        if end < 0:
+            sys.exit(f"{path}: BENCH_JSON_END not found, the capture is incomplete")
+        text = text[begin + len("BENCH_JSON_BEGIN"):end]
+
+    try:
+        return json.loads(text)
+    except json.JSONDecodeError as e:
+        sys.exit(f"{path}: not a benchmark run ({e})")
+
+
+def by_name(entries):
+    return {e["name"]: e for e in entries}
+
+
+def change(before, after):
+    if before == 0:
+        return 0.0 if after == 0 else float("inf")
+    return (after - before) * 100.0 / before
+
+
+def mark(pct, threshold):
+    if pct > threshold:
+        return "  worse"
+    if pct < -threshold:
+        return "  better"
+    return ""
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two benchmark runs")
+    parser.add_argument("before")
+    parser.add_argument("after")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent change to flag (default 5)")
+    parser.add_argument("--fail", action="store_true", help="exit with 1 if anything is worse by more than the threshold")
+    args = parser.parse_args()
+
+    a = load(args.before)
+    b = load(args.after)
+    worse = 0
+
+    ca, cb = a.get("context", {}), b.get("context", {})
+    for key in sorted(set(ca) | set(cb)):
+        if key not in ("date", "executable") and ca.get(key) != cb.get(key):
+            print(f"note: {key} differs: {ca.get(key)!r} -> {cb.get(key)!r}")
+
+    ba, bb = by_name(a.get("benchmarks", [])), by_name(b.get("benchmarks", []))
+    names = [n for n in ba if n in bb]
+    width = max([len(n) for n in names] + [9])
+
+    print(f"\n{'Benchmark':<{width}} {'before':>14} {'after':>14} {'change':>9}")
+    for name in names:
+        ra, rb = ba[name], bb[name]
+        if "cycles" in ra and "cycles" in rb:
+            va, vb, unit = ra["cycles"], rb["cycles"], "cyc"
+        else:
+            va, vb, unit = ra["real_time"], rb["real_time"], ra.get("time_unit", "ns")
+
+        pct = change(va, vb)
+        worse += pct > args.threshold
+        print(f"{name:<{width}} {va:>10.1f} {unit:<3} {vb:>10.1f} {unit:<3} {pct:>+8.1f}%{mark(pct, args.threshold)}")
+
+    for name in ba:
+        if name not in bb:
+            print(f"{name}: only in {args.before}")
+    for name in bb:
+        if name not in ba:
+            print(f"{name}: only in {args.after}")
+
+    ma, mb = by_name(a.get("memory", [])), by_name(b.get("memory", []))
+    names = [n for n in ma if n in mb]
+    if names:
+        width = max(len(n) for n in names)
+        print(f"\n{'Memory used by begin()':<{width}} {'internal':>19} {'dma':>19} {'psram':>19}")
+        for name in names:
+            line = f"{name:<{width}}"
+            marks = []
+            for key in ("internal_used", "dma_used", "psram_used"):
+                va, vb = ma[name].get(key, 0), mb[name].get(key, 0)
+                line += f" {va:>8} -> {vb:>8}"
+                pct = change(va, vb)
+                if pct > args.threshold:
+                    worse += 1
+                if mark(pct, args.threshold):
+                    marks.append(key.replace("_used", "") + mark(pct, args.threshold)[1:])
+            flagged = ("  " + ", ".join(marks)) if marks else ""  # one per column, e.g. "internal better, psram worse"
+            if ma[name].get("begin_ok", True) != mb[name].get("begin_ok", True):
+                flagged += "  begin() " + ("now fails" if ma[name].get("begin_ok", True) else "now succeeds")
+                worse += ma[name].get("begin_ok", True)
+            print(line + flagged)
+
+    return 1 if (args.fail and worse) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
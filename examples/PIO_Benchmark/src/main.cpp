@@ -0,0 +1,306 @@
+// On-target benchmark of the library: runs the same set of operations for a few panel setups and prints the
+// CPU cycles they take, as CSV while it runs and as one JSON document at the end (between the
+// BENCH_JSON_BEGIN / BENCH_JSON_END lines), along with the heap the library took in begin().
+//
+// Capture the serial output of two builds (e.g. master and a branch) and compare them with compare.py,
+// refer to the README. The panel does not need to be connected, but the pins must be free.
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <esp_idf_version.h>
+#include "xtensa/core-macros.h"
+
+#include <string>
+#include <vector>
+
+#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include <ESP32-HUB75-VirtualMatrixPanel_T.hpp>
+
+// Each setup is begin()'d in turn, with the library's default pins for the chip
+struct bench_setup_t
+{
+  uint16_t width, height, chain;
+  uint8_t depth;
+  bool double_buff;
+};
+
+static const bench_setup_t setups[] = {
+  {64, 32, 1, 8, false},
+  {64, 32, 1, 8, true},
+  {64, 64, 1, 8, true},
+  {64, 32, 2, 4, true},
+  {64, 32, 2, 8, true},
+  {64, 32, 2, 12, false},
+};
+
+#define FLIPS 20 // flips timed per setup
+
+struct bench_result_t
+{
+  std::string name;
+  uint32_t iterations;
+  double cycles;           // per iteration
+  double ns;               // per iteration
+  double items_per_second;
+  double max_ns;           // flip latency only, otherwise 0
+};
+
+struct bench_memory_t
+{
+  std::string name;
+  bool ok;
+  size_t internal_used, dma_used, psram_used;   // by begin()
+  size_t internal_free, internal_largest, iram_free, psram_free;
+  size_t library_bytes;                         // getMemoryReport().total_bytes
+  int refresh_rate;
+};
+
+static std::vector<bench_result_t> results;
+static std::vector<bench_memory_t> memory;
+static uint32_t cpu_mhz;
+
+static volatile uint32_t frames_seen = 0;
+static volatile int64_t frame_end_us = 0;
+
+static void IRAM_ATTR onFrame(void *)
+{
+  frame_end_us = esp_timer_get_time();
+  frames_seen = frames_seen + 1;
+}
+
+static std::string setupName(const bench_setup_t &s)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%ux%u/chain:%u/depth:%u/%s", s.width, s.height, s.chain, s.depth, s.double_buff ? "double" : "single");
+  return buf;
+}
+
+static void record(const char *op, const bench_setup_t &s, uint32_t iterations, uint32_t cycles, uint32_t items_per_op, double max_ns = 0)
+{
+  bench_result_t r;
+  r.name = std::string(op) + "/" + setupName(s);
+  r.iterations = iterations;
+  r.cycles = (double)cycles / iterations;
+  r.ns = r.cycles * 1000.0 / cpu_mhz;
+  r.items_per_second = items_per_op * 1e9 / r.ns;
+  r.max_ns = max_ns;
+
+  Serial.printf("csv,%s,%u,%.1f,%.1f,%.0f\n", r.name.c_str(), r.iterations, r.cycles, r.ns, r.items_per_second);
+  results.push_back(r);
+}
+
+// Times 'iterations' calls of fn(i), after one to warm up the caches
+template <typename F>
+static void bench(const char *op, const bench_setup_t &s, uint32_t iterations, uint32_t items_per_op, F fn)
+{
+  fn(0);
+
+  uint32_t start = XTHAL_GET_CCOUNT();
+  for (uint32_t i = 0; i < iterations; i++)
+    fn(i);
+  uint32_t cycles = XTHAL_GET_CCOUNT() - start;
+
+  record(op, s, iterations, cycles, items_per_op);
+}
+
+static void runSetup(const bench_setup_t &s)
+{
+  HUB75_I2S_CFG cfg(s.width, s.height, s.chain);
+  cfg.setPixelColorDepthBits(s.depth);
+  cfg.double_buff = s.double_buff;
+
+  bench_memory_t m = {};
+  m.name = setupName(s);
+  m.library_bytes = MatrixPanel_I2S_DMA::getMemoryReport(cfg).total_bytes;
+
+  const size_t internal_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  const size_t dma_before = heap_caps_get_free_size(MALLOC_CAP_DMA);
+  const size_t psram_before = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+  MatrixPanel_I2S_DMA *panel = new MatrixPanel_I2S_DMA(cfg);
+  m.ok = panel->begin();
+
+  m.internal_used = internal_before - heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  m.dma_used = dma_before - heap_caps_get_free_size(MALLOC_CAP_DMA);
+  m.psram_used = psram_before - heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+  m.internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  m.internal_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  m.iram_free = heap_caps_get_free_size(MALLOC_CAP_EXEC);
+  m.psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+  m.refresh_rate = panel->calculated_refresh_rate;
+  memory.push_back(m);
+
+  Serial.printf("csv_mem,%s,%d,%u,%u,%u,%u,%u,%u,%u,%u,%d\n", m.name.c_str(), m.ok, m.internal_used, m.dma_used, m.psram_used,
+                m.internal_free, m.internal_largest, m.iram_free, m.psram_free, m.library_bytes, m.refresh_rate);
+
+  if (!m.ok)
+  {
+    Serial.printf("# %s: begin() failed, skipped\n", m.name.c_str());
+    delete panel;
+    return;
+  }
+
+  const int w = s.width * s.chain;
+  const int h = s.height;
+  const uint32_t pixels = w * h;
+
+  // per pixel fill, the whole frame a pixel at a time
+  bench("fill_pixel", s, 4, pixels, [&](uint32_t i) {
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < w; x++)
+        panel->drawPixelRGB888(x, y, x + i, y, x ^ y);
+  });
+
+  bench("fill_screen", s, 20, pixels, [&](uint32_t i) { panel->fillScreenRGB888(i * 8, 128, 255 - i * 8); });
+
+  // full frame push from an RGB888 frame in RAM
+  uint8_t *rgb = (uint8_t *)malloc(pixels * 3);
+  if (rgb != nullptr)
+  {
+    for (uint32_t p = 0; p < pixels * 3; p++)
+      rgb[p] = p * 7;
+
+    bench("push_frame", s, 10, pixels, [&](uint32_t) { panel->pushFrameRGB888(rgb); });
+    free(rgb);
+  }
+
+  bench("brightness", s, 20, 1, [&](uint32_t i) { panel->setBrightness8((i & 1) ? 64 : 192); });
+
+  // the chain as a virtual display, the panels side by side
+  {
+    VirtualMatrixPanel_T<CHAIN_TOP_RIGHT_DOWN> virt(1, s.chain, s.width, s.height);
+    virt.setDisplay(*panel);
+
+    bench("virtual_pixel", s, 4, pixels, [&](uint32_t i) {
+      for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+          virt.drawPixel(x, y, (uint16_t)(x * 31 + y + i));
+    });
+  }
+
+  if (s.double_buff)
+  {
+    // cost of the call itself, then the time from a flip to the end of the frame the DMA moves over to the new buffer
+    // at, and the time flipDMABuffer(true) blocks for
+    panel->setFrameCallback(onFrame);
+
+    uint32_t flip_cycles = 0;
+    int64_t latency_total = 0, latency_max = 0;
+    int flips = 0;
+
+    for (int i = 0; i < FLIPS; i++)
+    {
+      panel->fillScreenRGB888(i * 10, 0, 0);
+      panel->waitBackBufferFree();
+
+      const uint32_t seen = frames_seen;
+      const int64_t t0 = esp_timer_get_time();
+      const uint32_t c0 = XTHAL_GET_CCOUNT();
+      panel->flipDMABuffer();
+      flip_cycles += XTHAL_GET_CCOUNT() - c0;
+
+      while (frames_seen == seen && esp_timer_get_time() - t0 < 100000)
+        ;
+
+      if (frames_seen == seen)
+        continue; // no end of frame interrupt
+
+      const int64_t latency = frame_end_us - t0;
+      latency_total += latency;
+      latency_max = (latency > latency_max) ? latency : latency_max;
+      flips++;
+    }
+
+    record("flip", s, FLIPS, flip_cycles, 1);
+
+    if (flips)
+    {
+      const uint32_t cycles = latency_total * cpu_mhz / flips;
+      record("flip_to_frame", s, 1, cycles, 1, latency_max * 1000.0);
+    }
+
+    const uint32_t c0 = XTHAL_GET_CCOUNT();
+    for (int i = 0; i < FLIPS; i++)
+      panel->flipDMABuffer(true);
+    record("flip_wait", s, FLIPS, XTHAL_GET_CCOUNT() - c0, 1);
+
+    panel->setFrameCallback(nullptr);
+  }
+
+  delete panel;
+}
+
+static void printJSON()
+{
+  Serial.println("BENCH_JSON_BEGIN");
+  Serial.println("{\n  \"context\": {");
+  Serial.printf("    \"chip\": \"%s\",\n", ESP.getChipModel());
+  Serial.printf("    \"cpu_mhz\": %u,\n", cpu_mhz);
+  Serial.printf("    \"psram_bytes\": %u,\n", ESP.getPsramSize());
+  Serial.printf("    \"idf_version\": \"%s\",\n", esp_get_idf_version());
+  Serial.printf("    \"build_flags\": \"");
+#ifdef SPIRAM_DMA_BUFFER
+  Serial.print("SPIRAM_DMA_BUFFER ");
+#endif
+#ifdef USE_BITPLANE_LUT
+  Serial.print("USE_BITPLANE_LUT ");
+#endif
+#ifdef USE_DIRTY_TRACKING
+  Serial.print("USE_DIRTY_TRACKING ");
+#endif
+#ifdef NO_CIE1931
+  Serial.print("NO_CIE1931 ");
+#endif
+#ifdef NO_FAST_FUNCTIONS
+  Serial.print("NO_FAST_FUNCTIONS ");
+#endif
+  Serial.printf("\",\n    \"pixel_color_depth_bits\": %d\n  },\n  \"benchmarks\": [\n", PIXEL_COLOR_DEPTH_BITS);
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const bench_result_t &r = results[i];
+    Serial.printf("    {\"name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %u, \"real_time\": %.1f, \"cpu_time\": %.1f, "
+                  "\"time_unit\": \"ns\", \"cycles\": %.1f, \"items_per_second\": %.0f, \"max_time\": %.1f}%s\n",
+                  r.name.c_str(), r.iterations, r.ns, r.ns, r.cycles, r.items_per_second, r.max_ns,
+                  (i + 1 < results.size()) ? "," : "");
+  }
+
+  Serial.println("  ],\n  \"memory\": [");
+
+  for (size_t i = 0; i < memory.size(); i++)
+  {
+    const bench_memory_t &m = memory[i];
+    Serial.printf("    {\"name\": \"%s\", \"begin_ok\": %s, \"internal_used\": %u, \"dma_used\": %u, \"psram_used\": %u, "
+                  "\"internal_free\": %u, \"internal_largest_block\": %u, \"iram_free\": %u, \"psram_free\": %u, "
+                  "\"library_bytes\": %u, \"refresh_rate\": %d}%s\n",
+                  m.name.c_str(), m.ok ? "true" : "false", m.internal_used, m.dma_used, m.psram_used, m.internal_free,
+                  m.internal_largest, m.iram_free, m.psram_free, m.library_bytes, m.refresh_rate,
+                  (i + 1 < memory.size()) ? "," : "");
+  }
+
+  Serial.println("  ]\n}");
+  Serial.println("BENCH_JSON_END");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(1000);
+
+  cpu_mhz = getCpuFrequencyMhz();
+
+  Serial.printf("# %s, %u MHz, %u bytes PSRAM, ESP-IDF %s\n", ESP.getChipModel(), cpu_mhz, ESP.getPsramSize(), esp_get_idf_version());
+  Serial.println("csv,name,iterations,cycles,ns,items_per_second");
+  Serial.println("csv_mem,name,begin_ok,internal_used,dma_used,psram_used,internal_free,internal_largest_block,iram_free,psram_free,library_bytes,refresh_rate");
+
+  for (const bench_setup_t &s : setups)
+    runSetup(s);
+
+  printJSON();
+}
+
+void loop()
+{
+  delay(1000);
+}
@@ -1,4 +1,6 @@
 #include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include <string.h>
+#include <algorithm>
 
 #if defined(SPIRAM_DMA_BUFFER)
 // Sprite_TM saves the day again...
@@ -10,10 +12,27 @@
  * when used in tight loops while method from struct could be flushed out of instruction cache between
  * loop cycles do NOT forget about buff_id param if using this.
  */
-// #define getRowDataPtr(row, _dpth, buff_id) &(dma_buff.rowBits[row]->data[_dpth * dma_buff.rowBits[row]->width + buff_id*(dma_buff.rowBits[row]->width * dma_buff.rowBits[row]->colour_depth)])
+// #define getRowDataPtr(row, _dpth, buff_id) &(dma_buff.rowBits[row].data[_dpth * dma_buff.rowBits[row].width + buff_id*(dma_buff.rowBits[row].width * dma_buff.rowBits[row].colour_depth)])
 
 // BufferID is now ignored, seperate global pointer pointer!
-#define getRowDataPtr(row, _dpth) &(fb->rowBits[row]->data[_dpth * fb->rowBits[row]->width])
+#if defined(SPIRAM_DMA_BUFFER)
+// the bitplanes may be split over SRAM and PSRAM, see HUB75_I2S_CFG::psram_placement
+#define getRowDataPtr(row, _dpth) (fb->rowBits[row].getDataPtr(_dpth))
+#else
+#define getRowDataPtr(row, _dpth) &(fb->rowBits[row].data[_dpth * fb->rowBits[row].width])
+#endif
+
+#if defined(SPIRAM_DMA_BUFFER)
+/* Writes the bitplanes of a whole row back from the CPU cache, the run(s) of them that are in PSRAM that is */
+static inline void writeBackRow(rowBitStruct &_row)
+{
+  if (_row.split > 0 && _row.lo_psram)
+    Cache_WriteBack_Addr((uint32_t)(uintptr_t)_row.data, _row.getColorDepthSize(true) * _row.split);
+
+  if (_row.split < _row.colour_depth && _row.hi_psram)
+    Cache_WriteBack_Addr((uint32_t)(uintptr_t)_row.data_hi, _row.getColorDepthSize(true) * (_row.colour_depth - _row.split));
+}
+#endif
 
 /* We need to update the correct uint16_t in the rowBitStruct array, that gets sent out in parallel
  * 16 bit parallel mode - Save the calculated value to the bitplane memory in reverse order to account for I2S Tx FIFO mode1 ordering
@@ -25,6 +44,120 @@
 #define ESP32_TX_FIFO_POSITION_ADJUST(x_coord) x_coord
 #endif
 
+/* Where pixel x is in a DMA row: its column in the row as scrollHorizontal() left it, FIFO adjusted */
+#define DMA_COLUMN(x_coord) ESP32_TX_FIFO_POSITION_ADJUST(hscrollColumn(x_coord))
+
+/* scrollHorizontal(): the columns at the end of a row with control bits of their own (the SM5266P row select takes 16),
+ * and the most columns hscrollControlBits() moves them along by in one go */
+#define HSCROLL_TAIL_COLUMNS 16
+#define HSCROLL_MAX_STEP 16
+
+/* Number of pixels the row based functions brightness compensate in one go before
+ * walking the bitplanes. Kept small as the working set lives on the stack.
+ */
+#define ROW_ENCODE_CHUNK_PIXELS 32
+
+/* Two DMA words as one 32 bit word, for going over the colour bits of two columns of a bitplane at a time (fadeFrame(), dimFrame()).
+ * The bitplanes are arrays of 16 bit words, so they are read through a type that may alias them, and only when 32 bit aligned.
+ */
+typedef uint32_t __attribute__((__may_alias__)) colour_pair_t;
+#define COLOUR_PAIR_RGB ((colour_pair_t)(ESP32_I2S_DMA_STORAGE_TYPE)~BITMASK_RGB12_CLEAR * 0x10001u)
+
+/* The colour bits of bitplane 'src' (black if nullptr) over those of bitplane 'dst', the control bits of 'dst' staying as they are */
+static inline void copyColourBits(ESP32_I2S_DMA_STORAGE_TYPE *dst, const ESP32_I2S_DMA_STORAGE_TYPE *src, size_t width)
+{
+  size_t x = 0;
+
+  if ((((uintptr_t)dst | (uintptr_t)src) & 3) == 0)
+  {
+    colour_pair_t *d = (colour_pair_t *)dst;
+    const colour_pair_t *s = (const colour_pair_t *)src;
+
+    if (s)
+      for (; x + 1 < width; x += 2, d++, s++)
+        *d = (*d & ~COLOUR_PAIR_RGB) | (*s & COLOUR_PAIR_RGB);
+    else
+      for (; x + 1 < width; x += 2, d++)
+        *d &= ~COLOUR_PAIR_RGB;
+  }
+
+  for (; x < width; x++)
+    dst[x] = (dst[x] & BITMASK_RGB12_CLEAR) | (src ? src[x] & ~BITMASK_RGB12_CLEAR : 0);
+}
+
+/* dimFrame() of word 'i' of every bitplane of a row, T being a DMA word or a pair of them and 'rgb' its colour bits.
+ * The colour values are bit-sliced across the bitplanes: plane n holds bit n of all six (or twelve) of them, so adding one set of
+ * values to another is a ripple carry add done plane by plane, for all of them at once. (v * numerator) >> 8 is then eight
+ * halvings of a sum, with v added to it before the halvings for the bits set in 'numerator', least significant first. That keeps
+ * the sum to depth + 1 bits and is exact. Halving just moves on where the sum's least significant plane is kept.
+ */
+template <typename T>
+static inline void dimWord(T *const *planes, size_t i, uint8_t depth, uint8_t numerator, T rgb)
+{
+  T v[PIXEL_COLOR_DEPTH_BITS_MAX], any = 0;
+
+  for (uint8_t d = 0; d < depth; d++)
+  {
+    v[d] = planes[d][i] & rgb;
+    any |= v[d];
+  }
+
+  if (!any) // black stays black
+    return;
+
+  T sum[PIXEL_COLOR_DEPTH_BITS_MAX + 9] = {};
+
+  for (int bit = 0; bit < 8; bit++)
+  {
+    if (!((numerator >> bit) & 1))
+      continue;
+
+    T *acc = sum + bit, carry = 0;
+    for (uint8_t d = 0; d < depth; d++)
+    {
+      T a = acc[d], half = a ^ v[d];
+      acc[d] = half ^ carry;
+      carry = (a & v[d]) | (carry & half);
+    }
+    acc[depth] = carry;
+  }
+
+  for (uint8_t d = 0; d < depth; d++)
+    planes[d][i] = (planes[d][i] & ~rgb) | sum[8 + d];
+}
+
+/* Record that pixels [x0, x1) of DMA row 'row' of the back buffer were drawn to, so flipDMABuffer()
+ * can bring the next back buffer up to date with just those pixels (see syncBackBuffer()), and so
+ * commit() knows what to write back from the cache to a PSRAM DMA buffer.
+ */
+#if defined(USE_DIRTY_TRACKING) && defined(SPIRAM_DMA_BUFFER)
+#define MARK_DIRTY(row, x0, x1) fb->markDirty(row, x0, x1), fb->unflushed[row].merge(x0, x1)
+#elif defined(USE_DIRTY_TRACKING)
+#define MARK_DIRTY(row, x0, x1) fb->markDirty(row, x0, x1)
+#elif defined(SPIRAM_DMA_BUFFER)
+#define MARK_DIRTY(row, x0, x1) fb->unflushed[row].merge(x0, x1)
+#else
+#define MARK_DIRTY(row, x0, x1) do {} while (0)
+#endif
+
+/* Start of a drawing (or reading back) call. With USE_DIRTY_TRACKING the back buffer may still be waiting to be brought
+ * up to date with the frame flipped to the front (see finishBackBufferSync()), that has to happen before it's touched.
+ */
+#ifdef USE_DIRTY_TRACKING
+#define DRAW_BEGIN() finishBackBufferSync()
+#else
+#define DRAW_BEGIN()
+#endif
+
+/* End of a drawing call. Without double buffering there is no flipDMABuffer() to commit() the
+ * changes to a PSRAM DMA buffer, so write them back now, once per call rather than once per word.
+ */
+#if defined(SPIRAM_DMA_BUFFER)
+#define DRAW_DONE() if (!m_cfg.double_buff) commit()
+#else
+#define DRAW_DONE()
+#endif
+
 
 
 
@@ -94,43 +227,311 @@
  * (input * 257), then shifted down to the target bit depth with rounding.
  */
 
-bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
+/* Bitplane encoding of a pixel.
+ * DO_BITPLANE_ENCODE() takes the colour in the red/green/blue variables, BITPLANE_RGB_BITS(idx) then returns
+ * its B,G,R bits for colour depth bitplane 'idx' in the R1G1B1 position. The BITPLANE_CHUNK_* helpers keep the
+ * encoded values of a run of pixels around for the row based functions.
+ * With USE_BITPLANE_LUT the encoding is three lookups in bitplane_lut[][], built by buildBitplaneLUT() in begin().
+ */
+#ifdef USE_BITPLANE_LUT
+  #define DO_BITPLANE_ENCODE()                                                                        \
+    bitplane_lut_t rgb_planes = bitplane_lut[0][red] | bitplane_lut[1][green] | bitplane_lut[2][blue];
+
+  #define BITPLANE_RGB_BITS(_idx) ((uint16_t)(rgb_planes >> (3 * (_idx))) & 0x7)
+
+  #define BITPLANE_CHUNK_DECL(_name) bitplane_lut_t _name[ROW_ENCODE_CHUNK_PIXELS]
+  #define BITPLANE_CHUNK_STORE(_name, _i) _name[_i] = rgb_planes
+  #define BITPLANE_CHUNK_BITS(_name, _i, _idx) ((uint16_t)(_name[_i] >> (3 * (_idx))) & 0x7)
+#else
+  #define DO_BITPLANE_ENCODE() DO_BRIGHTNESS_COMPENSATION()
+
+  #define BITPLANE_RGB_BITS(_idx) \
+    ((uint16_t)((((blue_val >> (_idx)) & 1) << 2) | (((green_val >> (_idx)) & 1) << 1) | ((red_val >> (_idx)) & 1)))
+
+  #define BITPLANE_CHUNK_DECL(_name) uint16_t _name[ROW_ENCODE_CHUNK_PIXELS][3]
+  #define BITPLANE_CHUNK_STORE(_name, _i) _name[_i][0] = red_val, _name[_i][1] = green_val, _name[_i][2] = blue_val
+  #define BITPLANE_CHUNK_BITS(_name, _i, _idx) \
+    ((uint16_t)((((_name[_i][2] >> (_idx)) & 1) << 2) | (((_name[_i][1] >> (_idx)) & 1) << 1) | ((_name[_i][0] >> (_idx)) & 1)))
+#endif
+
+/* Allocates '_rows' rows of '_row_bytes' each as an arena: one memory block for all of them if the heap allows,
+ * otherwise as few blocks (each holding a run of whole rows) as the heap fragmentation requires.
+ * The blocks are added to '_blocks' and a pointer to each row to '_row_ptrs'. Returns false if the rows don't fit.
+ */
+static bool allocateRowArena(std::vector<ESP32_I2S_DMA_STORAGE_TYPE *> &_blocks, std::vector<ESP32_I2S_DMA_STORAGE_TYPE *> &_row_ptrs, const size_t _rows, const size_t _row_bytes, const uint32_t _caps, const size_t _align)
+{
+  const size_t _row_stride = (_row_bytes + _align - 1) & ~(_align - 1);
+
+  _row_ptrs.reserve(_rows);
+
+  // Grab the whole frame in one block if possible, else as many whole rows as the largest free block can take, and so on.
+  while (_row_ptrs.size() < _rows)
+  {
+    size_t _rows_left = _rows - _row_ptrs.size();
+    size_t _rows_fit = heap_caps_get_largest_free_block(_caps) / _row_stride;
+    _rows_fit = (_rows_fit > _rows_left) ? _rows_left : _rows_fit;
+
+    ESP32_I2S_DMA_STORAGE_TYPE *_block = nullptr;
+
+    // the largest free block may not be fully usable once alignment is taken into account, so back off a row at a time
+    while (_rows_fit > 0)
+    {
+      if (_align > 4)
+        _block = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_aligned_alloc(_align, _rows_fit * _row_stride, _caps);
+      else
+        _block = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_malloc(_rows_fit * _row_stride, _caps);
+
+      if (_block != nullptr)
+        break;
+
+      --_rows_fit;
+    }
+
+    if (_block == nullptr)
+    {
+      ESP_LOGE("I2S-DMA", "Could only allocate %u of %u rows of %u bytes.", (unsigned int)_row_ptrs.size(), (unsigned int)_rows, (unsigned int)_row_bytes);
+      return false;
+    }
+
+    ESP_LOGD("I2S-DMA", "Allocated memory block of %u rows at %p.", (unsigned int)_rows_fit, _block);
+
+    _blocks.push_back(_block);
+
+    for (size_t i = 0; i < _rows_fit; i++)
+      _row_ptrs.push_back(_block + i * (_row_stride / sizeof(ESP32_I2S_DMA_STORAGE_TYPE)));
+  }
+
+  return true;
+}
+
+bool frameStruct::allocate(const size_t _width, const uint8_t _depth, const uint8_t _rows, const uint8_t _sram_planes, const bool _sram_msb)
+{
+  release();
+
+  const size_t _plane_bytes = _width * sizeof(ESP32_I2S_DMA_STORAGE_TYPE);
+  std::vector<ESP32_I2S_DMA_STORAGE_TYPE *> _lo, _hi;
+
+#if defined(SPIRAM_DMA_BUFFER)
+  const uint32_t _psram_caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+  const size_t _psram_align = 64; // GDMA PSRAM transfers must be 64 byte aligned, so is every row
+  const uint32_t _sram_caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+  const size_t _sram_align = 64; // the GDMA channel is set up for 64 byte bursts for PSRAM, keep the SRAM rows to that too
+
+  // bitplanes [0, _split) go in the 'lo' run, [_split, _depth) in the 'hi' one
+  uint8_t _sram = (_sram_planes > _depth) ? _depth : _sram_planes;
+  uint8_t _split = (_sram == 0 || _sram == _depth) ? _depth : (_sram_msb ? _depth - _sram : _sram);
+  bool _lo_psram = (_sram == _depth) ? false : (_sram == 0 || _sram_msb);
+  bool _hi_psram = !_lo_psram;
+
+  bool _ok = allocateRowArena(blocks, _lo, _rows, _split * _plane_bytes, _lo_psram ? _psram_caps : _sram_caps, _lo_psram ? _psram_align : _sram_align);
+  if (_ok && _split < _depth)
+    _ok = allocateRowArena(blocks, _hi, _rows, (_depth - _split) * _plane_bytes, _hi_psram ? _psram_caps : _sram_caps, _hi_psram ? _psram_align : _sram_align);
+#else
+  (void)_sram_planes; // no PSRAM to place the other bitplanes in
+  (void)_sram_msb;
+
+  // DMA linked list buffer address pointer must be word-aligned
+  bool _ok = allocateRowArena(blocks, _lo, _rows, _depth * _plane_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA, 4);
+#endif
+
+  if (!_ok)
+  {
+    release();
+    return false;
+  }
+
+  rowBits.reserve(_rows);
+  for (size_t i = 0; i < _rows; i++)
+  {
+    rowBits.emplace_back(_width, _depth, _lo[i]);
+
+#if defined(SPIRAM_DMA_BUFFER)
+    rowBits.back().split = _split;
+    rowBits.back().data_hi = _hi.empty() ? nullptr : _hi[i];
+    rowBits.back().lo_psram = _lo_psram;
+    rowBits.back().hi_psram = _hi_psram;
+#endif
+  }
+
+  rows = _rows;
+
+#ifdef USE_DIRTY_TRACKING
+  dirty.assign(_rows, rowSpan());
+  stale.assign(_rows, rowSpan());
+#endif
+
+#if defined(SPIRAM_DMA_BUFFER)
+  unflushed.assign(_rows, rowSpan());
+#endif
+
+  return true;
+}
+
+void frameStruct::release()
+{
+  rowBits.clear();
+  rows = 0;
+
+#ifdef USE_DIRTY_TRACKING
+  dirty.clear();
+  stale.clear();
+#endif
+
+#if defined(SPIRAM_DMA_BUFFER)
+  unflushed.clear();
+#endif
+
+  for (auto _block : blocks)
+    heap_caps_free(_block);
+
+  blocks.clear();
+}
+
+int MatrixPanel_I2S_DMA::calculateLsbMsbTransitionBit(const HUB75_I2S_CFG &cfg, int &refresh_rate, bool log)
+{
+  const uint32_t pixels_per_row = cfg.mx_width * cfg.chain_length;
+  const uint32_t rows_per_frame = cfg.mx_height / MATRIX_ROWS_IN_PARALLEL;
+
+  int transition_bit = HUB75Planner::transitionBit(pixels_per_row, rows_per_frame, cfg.getPixelColorDepthBits(), cfg.i2sspeed, cfg.min_refresh_rate, refresh_rate);
+
+  if (log)
+  {
+    for (int i = 0; i <= transition_bit; i++)
+      ESP_LOGW("I2S-DMA", "lsbMsbTransitionBit of %d gives %d Hz refresh rate.", i, HUB75Planner::refreshRate(pixels_per_row, rows_per_frame, cfg.getPixelColorDepthBits(), cfg.i2sspeed, i));
+  }
+
+  return transition_bit;
+}
+
+int MatrixPanel_I2S_DMA::calculateDMADescriptorsPerRow(size_t row_bytes_1cdepth, uint8_t colour_depth, int transition_bit, uint8_t split_plane)
+{
+  return HUB75Planner::descriptorsPerRow(row_bytes_1cdepth, colour_depth, transition_bit, split_plane, DMA_MAX);
+}
+
+MatrixPanel_I2S_DMA::memory_report_t MatrixPanel_I2S_DMA::getMemoryReport(const HUB75_I2S_CFG &cfg)
+{
+  HUB75Planner::plan_t plan = HUB75Planner::plan(cfg, DMA_MAX, sizeof(HUB75_DMA_DESCRIPTOR_T));
+
+  memory_report_t report;
+
+  report.framebuffers = plan.framebuffers;
+  report.framebuffer_bytes = plan.framebuffer_bytes;
+  report.dma_descriptors = plan.dma_descriptors;
+  report.dma_descriptor_bytes = plan.dma_descriptor_bytes;
+  report.total_bytes = plan.total_bytes;
+
+  return report;
+}
+
+#if defined(SPIRAM_DMA_BUFFER)
+uint8_t MatrixPanel_I2S_DMA::calculateSramPlanes(const HUB75_I2S_CFG &cfg)
+{
+  if (cfg.psram_placement == HUB75_I2S_CFG::PSRAM_ALL_PLANES)
+    return 0;
+
+  memory_report_t report = getMemoryReport(cfg);
+
+  const size_t frame_plane_bytes = report.framebuffer_bytes / cfg.getPixelColorDepthBits(); // one bitplane of all the rows
+
+  // the DMA descriptors live in internal RAM as well, the report allows for the rows being split in two runs
+  size_t sram_needed = report.framebuffers * report.dma_descriptor_bytes + PSRAM_PLACEMENT_SRAM_RESERVE;
+  size_t sram_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+
+  if (sram_free <= sram_needed)
+    return 0;
+
+  size_t planes = (sram_free - sram_needed) / (frame_plane_bytes * report.framebuffers);
+
+  return (planes > cfg.getPixelColorDepthBits()) ? cfg.getPixelColorDepthBits() : planes;
+}
+#endif
+
+void MatrixPanel_I2S_DMA::printMemoryReport(const HUB75_I2S_CFG &cfg)
+{
+  memory_report_t report = getMemoryReport(cfg);
+
+  ESP_LOGI("I2S-DMA", "Memory required for %d x %d px, %d bit colour depth:", cfg.mx_width * cfg.chain_length, cfg.mx_height, cfg.getPixelColorDepthBits());
+  ESP_LOGI("I2S-DMA", "  %d framebuffer(s) of %u bytes", report.framebuffers, (unsigned int)report.framebuffer_bytes);
+  ESP_LOGI("I2S-DMA", "  %d x %u DMA descriptors of %u bytes", report.framebuffers, (unsigned int)report.dma_descriptors, (unsigned int)sizeof(HUB75_DMA_DESCRIPTOR_T));
+  ESP_LOGI("I2S-DMA", "  Total: %u bytes (single buffer: %u, double buffer: %u, triple buffer: %u)", (unsigned int)report.total_bytes,
+           (unsigned int)(1 * (report.framebuffer_bytes + report.dma_descriptor_bytes)),
+           (unsigned int)(2 * (report.framebuffer_bytes + report.dma_descriptor_bytes)),
+           (unsigned int)(3 * (report.framebuffer_bytes + report.dma_descriptor_bytes)));
+}
+
+bool MatrixPanel_I2S_DMA::setupDMA()
 {
-  
   /***
    * Step 0: Allocate basic DMA framebuffer memory for the data we send out in parallel to the HUB75 panel.
    *         Colour depth is the only consideration.
    * 
    */
-  ESP_LOGI("I2S-DMA", "Free heap: %d", heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
-  ESP_LOGI("I2S-DMA", "Free SPIRAM: %d", heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+  ESP_LOGI("I2S-DMA", "Free heap: %u", (unsigned int)heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+  ESP_LOGI("I2S-DMA", "Free SPIRAM: %u", (unsigned int)heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+
+  if (m_cfg.hscroll)
+  {
+#if defined(SPIRAM_DMA_BUFFER)
+    ESP_LOGE("I2S-DMA", "hscroll can't be used with SPIRAM_DMA_BUFFER.");
+    return false;
+#else
+    // a pass over a bitplane is never more than two descriptors, and they have to stay word aligned on the ESP32 / S2
+    if (PIXELS_PER_ROW * sizeof(ESP32_I2S_DMA_STORAGE_TYPE) > DMA_MAX || (PIXELS_PER_ROW % HSCROLL_STEP))
+    {
+      ESP_LOGE("I2S-DMA", "hscroll needs rows of at most %d pixels, and a multiple of %d.", (int)(DMA_MAX / sizeof(ESP32_I2S_DMA_STORAGE_TYPE)), HSCROLL_STEP);
+      return false;
+    }
+#endif
+  }
+
+  hscroll_offset = 0;
+  vscroll_offset = 0;
+  vscroll_row = 0;
 
   size_t allocated_fb_memory = 0;
 
-  int fbs_required = (m_cfg.double_buff) ? 2 : 1;
+  int fbs_required = (m_cfg.triple_buff) ? 3 : (m_cfg.double_buff) ? 2 : 1;
 
-  for (int fb = 0; fb < (fbs_required); fb++)
-  {
-    frame_buffer[fb].rowBits.reserve(ROWS_PER_FRAME);
+  uint8_t sram_planes = 0;
+  bool sram_msb = true;
 
-    for (int malloc_num = 0; malloc_num < ROWS_PER_FRAME; malloc_num++)
-    {
-      auto ptr = std::make_shared<rowBitStruct>(PIXELS_PER_ROW, m_cfg.getPixelColorDepthBits());
+#if defined(SPIRAM_DMA_BUFFER)
+  // Hybrid placement: the bitplanes that fit go to internal SRAM, the rest to PSRAM. See HUB75_I2S_CFG::psram_placement
+  sram_planes = calculateSramPlanes(m_cfg);
+  sram_msb = (m_cfg.psram_placement != HUB75_I2S_CFG::PSRAM_MSB_PLANES);
 
-      if (ptr->data == nullptr) {
+  if (m_cfg.psram_placement != HUB75_I2S_CFG::PSRAM_ALL_PLANES)
+    ESP_LOGI("I2S-DMA", "Placing the %d %s significant bitplane(s) of %d in internal SRAM, the rest in PSRAM.", sram_planes, sram_msb ? "most" : "least", m_cfg.getPixelColorDepthBits());
+#endif
 
-        ESP_LOGE("I2S-DMA", "CRITICAL ERROR: Not enough memory for requested colour depth of %d bits! Please reduce pixel_color_depth_bits value.\r\n", m_cfg.getPixelColorDepthBits());
+  for (int fb = 0; fb < (fbs_required); fb++)
+  {
+    if (!frame_buffer[fb].allocate(PIXELS_PER_ROW, m_cfg.getPixelColorDepthBits(), ROWS_PER_FRAME, sram_planes, sram_msb))
+    {
+      // all or nothing, don't leave the other buffer hanging around
+      for (int _fb = 0; _fb < fbs_required; _fb++)
+        frame_buffer[_fb].release();
 
-        return false;
-        // TODO: should we release all previous rowBitStructs here???
+      // internal SRAM is more fragmented than it looked, try again with one bitplane less there
+      if (sram_planes > 0)
+      {
+        ESP_LOGW("I2S-DMA", "Could not place %d bitplane(s) in internal SRAM, retrying with %d.", sram_planes, sram_planes - 1);
+        --sram_planes;
+        allocated_fb_memory = 0;
+        fb = -1;
+        continue;
       }
 
-      allocated_fb_memory += ptr->getColorDepthSize(false); // byte required to display all colour depths for the two parallel rows
-      frame_buffer[fb].rowBits.emplace_back(ptr); // save new rowBitStruct pointer into rows vector
-      ++frame_buffer[fb].rows;
+      ESP_LOGE("I2S-DMA", "CRITICAL ERROR: Not enough memory for requested colour depth of %d bits! Please reduce pixel_color_depth_bits value.\r\n", m_cfg.getPixelColorDepthBits());
+
+      return false;
     }
+
+    allocated_fb_memory += frame_buffer[fb].rowBits[0].getColorDepthSize(false) * ROWS_PER_FRAME; // byte required to display all colour depths for all the parallel rows
+
+    ESP_LOGI("I2S-DMA", "DMA BCM framebuffer %d allocated in %u memory block(s).", fb, (unsigned int)frame_buffer[fb].blocks.size());
   }
-  ESP_LOGI("I2S-DMA", "Allocating %d bytes memory for DMA BCM framebuffer(s).", allocated_fb_memory);
+  ESP_LOGI("I2S-DMA", "Allocating %u bytes memory for DMA BCM framebuffer(s).", (unsigned int)allocated_fb_memory);
 
 
   /***
@@ -141,46 +542,31 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
    */  
    
 //#define FORCE_COLOR_DEPTH 1   
+
+  if (active_colour_depth == 0 || active_colour_depth > m_cfg.getPixelColorDepthBits())
+    active_colour_depth = m_cfg.getPixelColorDepthBits();
   
 #if !defined(FORCE_COLOR_DEPTH)
 
   ESP_LOGI("I2S-DMA", "Minimum visual refresh rate (scan rate from panel top to bottom) requested: %d Hz", m_cfg.min_refresh_rate);
 
-  while (1)
-  {
-    int psPerClock = 1000000000000UL / m_cfg.i2sspeed;
-    int nsPerLatch = ((PIXELS_PER_ROW + CLKS_DURING_LATCH) * psPerClock) / 1000; // time per row
-
-    // add time to shift out LSBs + LSB-MSB transition bit - this ignores fractions...
-    int nsPerRow = m_cfg.getPixelColorDepthBits() * nsPerLatch;
-
-    // Now add the time for the remaining bit depths
-    for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) {
-      //nsPerRow += (1 << (i - lsbMsbTransitionBit - 1)) * (m_cfg.getPixelColorDepthBits() - i) * nsPerLatch;
-	  nsPerRow += (1 << (i - lsbMsbTransitionBit - 1)) *  nsPerLatch;
-	}
-
-    int nsPerFrame = nsPerRow * ROWS_PER_FRAME;
-    int actualRefreshRate = 1000000000UL / (nsPerFrame);
-    calculated_refresh_rate = actualRefreshRate;
-
-    ESP_LOGW("I2S-DMA", "lsbMsbTransitionBit of %d gives %d Hz refresh rate.", lsbMsbTransitionBit, actualRefreshRate);
-
-    if (actualRefreshRate >= m_cfg.min_refresh_rate)
-      break;
+  // only the active_colour_depth most significant bitplanes are sent, see setColorDepth()
+  HUB75_I2S_CFG _active_cfg = m_cfg;
+  _active_cfg.setPixelColorDepthBits(active_colour_depth);
 
-    if (lsbMsbTransitionBit < m_cfg.getPixelColorDepthBits() - 1)
-      lsbMsbTransitionBit++;
-    else
-      break;
-  }
+  lsbMsbTransitionBit = calculateLsbMsbTransitionBit(_active_cfg, calculated_refresh_rate, true);
 
   if (lsbMsbTransitionBit > 0)
   {
     ESP_LOGW("I2S-DMA", "lsbMsbTransitionBit of %d used to achieve refresh rate of %d Hz. Percieved colour depth to the eye may be reduced.", lsbMsbTransitionBit, m_cfg.min_refresh_rate);
   }
 
-  ESP_LOGI("I2S-DMA", "DMA frame buffer color depths: %d", m_cfg.getPixelColorDepthBits());
+  ESP_LOGI("I2S-DMA", "DMA frame buffer color depths: %d, %d shown", m_cfg.getPixelColorDepthBits(), active_colour_depth);
+
+#else
+
+  // every bitplane for its full BCM weight, the timeouts waiting on the DMA still need the refresh rate that gives
+  calculated_refresh_rate = HUB75Planner::refreshRate(PIXELS_PER_ROW, ROWS_PER_FRAME, active_colour_depth, m_cfg.i2sspeed, 0);
 
 #endif
 
@@ -191,26 +577,7 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
    *          give this library's DMA output memory allocation approach is by the row.
    */
 	
-  int    dma_descs_per_row_1cdepth	 	= (frame_buffer[0].rowBits[0]->getColorDepthSize(true) + DMA_MAX - 1 ) / DMA_MAX;
-  size_t last_dma_desc_bytes_1cdepth    = (frame_buffer[0].rowBits[0]->getColorDepthSize(true) % DMA_MAX);
-  
-  int    dma_descs_per_row_all_cdepths	  = (frame_buffer[0].rowBits[0]->getColorDepthSize(false) + DMA_MAX - 1 ) / DMA_MAX;
-  size_t last_dma_desc_bytes_all_cdepths  = (frame_buffer[0].rowBits[0]->getColorDepthSize(false) % DMA_MAX);
-
-  // Logging the calculated values
-  ESP_LOGV("I2S-DMA", "dma_descs_per_row_1cdepth: %d", dma_descs_per_row_1cdepth);
-  ESP_LOGV("I2S-DMA", "last_dma_desc_bytes_1cdepth: %zu", last_dma_desc_bytes_1cdepth);
-  ESP_LOGV("I2S-DMA", "dma_descs_per_row_all_cdepths: %d", dma_descs_per_row_all_cdepths);
-  ESP_LOGV("I2S-DMA", "last_dma_desc_bytes_all_cdepths: %zu", last_dma_desc_bytes_all_cdepths);
-  
- 
-  // Calculate per-row number
-  int dma_descriptors_per_row = dma_descs_per_row_all_cdepths;
-
-  // Add descriptors for MSB bits after transition
-  for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) {
-    dma_descriptors_per_row += (1 << (i - lsbMsbTransitionBit - 1)) * dma_descs_per_row_1cdepth;
-  }
+  int dma_descriptors_per_row = activeDMADescriptorsPerRow();
   
   //dma_descriptors_per_row = 1;
 
@@ -224,7 +591,9 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
    * Step 3:  Allocate the DMA descriptor memory via. the relevant platform DMA implementation class.
    */
 
-  if (m_cfg.double_buff) {
+  if (m_cfg.triple_buff) {
+    dma_bus.enable_triple_dma_desc();
+  } else if (m_cfg.double_buff) {
     dma_bus.enable_double_dma_desc();
   }
 
@@ -238,64 +607,7 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
    * Step 4:  Link up the DMA descriptors per the colour depth and rows.
    */
 
-  //fbs_required = 1; // (m_cfg.double_buff) ? 2 : 1;
-  for (int fb = 0; fb < (fbs_required); fb++)
-  {  
-	
-	int _dmadescriptor_count = 0; // for tracking
-	
-    for (int row = 0; row < ROWS_PER_FRAME; row++)
-    {
-	  //ESP_LOGV("I2S-DMA", ">>> Linking DMA descriptors for output row %d", row);    	
-		
-	  // Link and send all colour data, all passes of everything in one hit. 1 bit colour at least...
-	  for (int dma_desc_all = 0; dma_desc_all < dma_descs_per_row_all_cdepths; dma_desc_all++) 
-	  {
-			size_t payload_bytes = (dma_desc_all == (dma_descs_per_row_all_cdepths-1)) ? last_dma_desc_bytes_all_cdepths:DMA_MAX;
-			
-			// Log the current descriptor number and the payload size being used.
-			//ESP_LOGV("I2S-DMA", "Processing dma_desc_all: %d, payload_bytes: %zu, memory location: %p", dma_desc_all, payload_bytes, (frame_buffer[fb].rowBits[row]->getDataPtr(0)+(dma_desc_all*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE)))));
-				
-		    dma_bus.create_dma_desc_link(frame_buffer[fb].rowBits[row]->getDataPtr(0)+(dma_desc_all*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes, (fb==1));
-			_dmadescriptor_count++;
-			
-			// Log the updated descriptor count after each operation.
-			//ESP_LOGV("I2S-DMA", "Updated _dmadescriptor_count: %d", _dmadescriptor_count);			
-	  }
-	
-      // Step 2: Handle additional descriptors for bits beyond the lsbMsbTransitionBit 
-      for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) 
-	  {
-		  // binary time division setup: we need 2 of bit (LSBMSB_TRANSITION_BIT + 1) four of (LSBMSB_TRANSITION_BIT + 2), etc
-		  // because we sweep through to MSB each time, it divides the number of times we have to sweep in half (saving linked list RAM)
-		  // we need 2^(i - LSBMSB_TRANSITION_BIT - 1) == 1 << (i - LSBMSB_TRANSITION_BIT - 1) passes from i to MSB
-
-		  for (int k = 0; k < (1 << (i - lsbMsbTransitionBit - 1)); k++)
-		  {		  
-			  // Link and send all colour data, all passes of everything in one hit.
-			  for (int dma_desc_1cdepth = 0; dma_desc_1cdepth < dma_descs_per_row_1cdepth; dma_desc_1cdepth++) 
-			  {		  
-				size_t payload_bytes = (dma_desc_1cdepth == (dma_descs_per_row_1cdepth-1)) ? last_dma_desc_bytes_1cdepth:DMA_MAX;
-				
-				// Log the current bit and the corresponding payload size.
-				//ESP_LOGV("I2S-DMA", "Processing dma_desc_1cdepth: %d, payload_bytes: %zu, memory location: %p", dma_desc_1cdepth, payload_bytes, (frame_buffer[fb].rowBits[row]->getDataPtr(i)+(dma_desc_1cdepth*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE)))));
-		
-				dma_bus.create_dma_desc_link(frame_buffer[fb].rowBits[row]->getDataPtr(i)+(dma_desc_1cdepth*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes, (fb==1));
-				_dmadescriptor_count++;
-				
-				// Log the updated descriptor count after each operation.
-			//	ESP_LOGV("I2S-DMA", "Updated _dmadescriptor_count: %d", _dmadescriptor_count);		
-			  }
-		  } // end K
-		
-      } // end all other colour depth bits
-	  
-
-    } // end all rows
-	
-    ESP_LOGI("I2S-DMA", "Created %d DMA descriptors for buffer %d.", _dmadescriptor_count, fb);	
-	
-  } // end framebuffer loop
+  linkDMADescriptors(fbs_required);
 	  
 	/*
 	#include <iostream>
@@ -368,44 +680,217 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 
 } // end setupDMA
 
-/* There are 'bits' set in the frameStruct that we simply don't need to set every single time we change a pixel / DMA buffer co-ordinate.
- *  For example, the bits that determine the address lines, we don't need to set these every time. Once they're in place, and assuming we
- *  don't accidentally clear them, then we don't need to set them again.
- *  So to save processing, we strip this logic out to the absolute bare minimum, which is toggling only the R,G,B pixels (bits) per co-ord.
- *
- *  Critical dependency: That 'updateMatrixDMABuffer(uint8_t red, uint8_t green, uint8_t blue)' has been run at least once over the
- *                       entire frameBuffer to ensure all the non R,G,B bitmasks are in place (i.e. like OE, Address Lines etc.)
- *
- *  Note: If you change the brightness with setBrightness() you MUST then clearScreen() and repaint / flush the entire framebuffer.
- */
-
-/** @brief - Update pixel at specific co-ordinate in the DMA buffer
- *  this is the main method used to update DMA buffer on pixel-by-pixel level so it must be fast, real fast!
- *  Let's put it into IRAM to avoid situations when it could be flushed out of instruction cache
- *  and had to be read from spi-flash over and over again.
- *  Yes, it is always a tradeoff between memory/speed/size, but compared to DMA-buffer size is not a big deal
- *
- *  Note: Cannot pass a negative co-ord as it makes no sense in the DMA bit array lookup.
- */
-void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint16_t y_coord, uint8_t red, uint8_t green, uint8_t blue)
+/* DMA descriptors per row to send the active_colour_depth most significant bitplanes with the current lsbMsbTransitionBit */
+int MatrixPanel_I2S_DMA::activeDMADescriptorsPerRow()
 {
-  if (!initialized)
-    return;
+  if (m_cfg.hscroll)
+    return HUB75Planner::hscrollDescriptorsPerRow(active_colour_depth, lsbMsbTransitionBit);
 
-  /* 1) Check that the co-ordinates are within range, or it'll break everything big time.
-   * Valid co-ordinates are from 0 to (MATRIX_XXXX-1)
-   */
-  if (x_coord >= PIXELS_PER_ROW || y_coord >= m_cfg.mx_height)
+  const uint8_t first_plane = m_cfg.getPixelColorDepthBits() - active_colour_depth;
+
+  // With a hybrid SRAM/PSRAM placement, the bitplanes [0, split_plane) and [split_plane, colour depth) of a row are two separate runs
+#if defined(SPIRAM_DMA_BUFFER)
+  const uint8_t split_plane = frame_buffer[0].rowBits[0].split;
+#else
+  const uint8_t split_plane = m_cfg.getPixelColorDepthBits();
+#endif
+
+  return calculateDMADescriptorsPerRow(frame_buffer[0].rowBits[0].getColorDepthSize(true), active_colour_depth, lsbMsbTransitionBit,
+                                       (split_plane > first_plane) ? split_plane - first_plane : 0);
+}
+
+/* Link the DMA descriptors of the framebuffers, to send the active_colour_depth most significant bitplanes of every row */
+void MatrixPanel_I2S_DMA::linkDMADescriptors(int fbs_required)
+{
+  if (m_cfg.hscroll)
   {
+    for (int fb = 0; fb < fbs_required; fb++)
+      for (int row = 0; row < ROWS_PER_FRAME; row++)
+        linkHScrollRow(fb, row, false);
+
+    ESP_LOGI("I2S-DMA", "Created %d DMA descriptors per buffer for hscroll.", activeDMADescriptorsPerRow() * ROWS_PER_FRAME);
     return;
   }
 
-  /* LED Brightness Compensation. Because if we do a basic "red & mask" for example,
-   * we'll NEVER send the dimmest possible colour, due to binary skew.
-   * i.e. It's almost impossible for colour_depth_idx of 0 to be sent out to the MATRIX unless the 'value' of a colour is exactly '1'
-   * https://ledshield.wordpress.com/2012/11/13/led-brightness-to-your-eye-gamma-correction-no/
-   */
-  DO_BRIGHTNESS_COMPENSATION() 
+  // Logging the calculated values
+  ESP_LOGV("I2S-DMA", "DMA descriptors per row: %d, first bitplane sent: %d", activeDMADescriptorsPerRow(), m_cfg.getPixelColorDepthBits() - active_colour_depth);
+
+  for (int fb = 0; fb < (fbs_required); fb++)
+  {  
+	
+	int _dmadescriptor_count = 0; // for tracking
+	
+    for (int row = 0; row < ROWS_PER_FRAME; row++)
+      _dmadescriptor_count += linkDMARow(fb, row, false);
+	
+    ESP_LOGI("I2S-DMA", "Created %d DMA descriptors for buffer %d.", _dmadescriptor_count, fb);	
+	
+  } // end framebuffer loop
+}
+
+/* The descriptors of one row for linkDMADescriptors(), in the order the DMA sends them. Every row takes the same number of them, so
+ * with 'update' the ones already linked for the row are repointed in place (see scrollVertical()).
+ */
+int MatrixPanel_I2S_DMA::linkDMARow(int _buff_id, int row, bool update)
+{
+  if (m_cfg.hscroll)
+  {
+    linkHScrollRow(_buff_id, row, update);
+    return activeDMADescriptorsPerRow();
+  }
+
+  const uint8_t colour_depth = m_cfg.getPixelColorDepthBits();
+  const uint8_t first_plane  = colour_depth - active_colour_depth;
+  rowBitStruct &_row = frame_buffer[_buff_id].rowBits[vscrollRow(row)];
+
+  int    dma_descs_per_row_1cdepth	 	= (_row.getColorDepthSize(true) + DMA_MAX - 1 ) / DMA_MAX;
+  size_t last_dma_desc_bytes_1cdepth    = _row.getColorDepthSize(true) - (dma_descs_per_row_1cdepth - 1) * DMA_MAX;
+  
+#if defined(SPIRAM_DMA_BUFFER)
+  uint8_t split_plane = _row.split;
+#else
+  uint8_t split_plane = colour_depth;
+#endif
+
+  int _dmadescriptor_count = 0;
+  size_t idx = update ? (size_t)row * activeDMADescriptorsPerRow() : 0;
+
+  auto link = [&](ESP32_I2S_DMA_STORAGE_TYPE *data, size_t payload_bytes)
+  {
+    if (update)
+      dma_bus.update_dma_desc_link(idx++, data, payload_bytes, _buff_id);
+    else
+      dma_bus.create_dma_desc_link(data, payload_bytes, _buff_id);
+
+    _dmadescriptor_count++;
+  };
+
+  // Link and send all colour data, all passes of everything in one hit. 1 bit colour at least...
+  // One run of bitplanes, or two when they are split between SRAM and PSRAM.
+  for (int run_start = first_plane, run_end; run_start < colour_depth; run_start = run_end)
+  {
+	run_end = (run_start < split_plane) ? split_plane : colour_depth;
+	size_t run_bytes = _row.getColorDepthSize(true) * (run_end - run_start);
+	
+	int    dma_descs_per_row_all_cdepths   = (run_bytes + DMA_MAX - 1 ) / DMA_MAX;
+	size_t last_dma_desc_bytes_all_cdepths = run_bytes - (dma_descs_per_row_all_cdepths - 1) * DMA_MAX;
+	
+    for (int dma_desc_all = 0; dma_desc_all < dma_descs_per_row_all_cdepths; dma_desc_all++) 
+    {
+		size_t payload_bytes = (dma_desc_all == (dma_descs_per_row_all_cdepths-1)) ? last_dma_desc_bytes_all_cdepths:DMA_MAX;
+			
+	    link(_row.getDataPtr(run_start)+(dma_desc_all*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes);
+    }
+  }
+
+  // Step 2: Handle additional descriptors for bits beyond the lsbMsbTransitionBit (counted from the first bitplane sent)
+  for (int i = lsbMsbTransitionBit + 1; i < active_colour_depth; i++) 
+  {
+	  // binary time division setup: we need 2 of bit (LSBMSB_TRANSITION_BIT + 1) four of (LSBMSB_TRANSITION_BIT + 2), etc
+	  // because we sweep through to MSB each time, it divides the number of times we have to sweep in half (saving linked list RAM)
+	  // we need 2^(i - LSBMSB_TRANSITION_BIT - 1) == 1 << (i - LSBMSB_TRANSITION_BIT - 1) passes from i to MSB
+
+	  for (int k = 0; k < (1 << (i - lsbMsbTransitionBit - 1)); k++)
+	  {		  
+		  // Link and send all colour data, all passes of everything in one hit.
+		  for (int dma_desc_1cdepth = 0; dma_desc_1cdepth < dma_descs_per_row_1cdepth; dma_desc_1cdepth++) 
+		  {		  
+			size_t payload_bytes = (dma_desc_1cdepth == (dma_descs_per_row_1cdepth-1)) ? last_dma_desc_bytes_1cdepth:DMA_MAX;
+	
+			link(_row.getDataPtr(first_plane + i)+(dma_desc_1cdepth*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes);
+		  }
+	  } // end K
+	
+  } // end all other colour depth bits
+
+  return _dmadescriptor_count;
+}
+
+/* HUB75_I2S_CFG::hscroll: the passes over the bitplanes of a row in the same order as linkDMADescriptors(), but as rings,
+ * each from hscroll_offset to the end of the row and then from the start of the row round to hscroll_offset. With an offset
+ * of 0 the row is still split in two, so a row always takes the same descriptors and scrollHorizontal() can just repoint them.
+ */
+void MatrixPanel_I2S_DMA::linkHScrollRow(int _buff_id, int row, bool update)
+{
+  const uint8_t first_plane = m_cfg.getPixelColorDepthBits() - active_colour_depth;
+  rowBitStruct &_row = frame_buffer[_buff_id].rowBits[vscrollRow(row)];
+
+  const uint16_t len_1 = hscroll_offset ? PIXELS_PER_ROW - hscroll_offset : PIXELS_PER_ROW - HSCROLL_STEP;
+  const uint16_t start_2 = hscroll_offset ? 0 : len_1;
+
+  size_t idx = (size_t)row * activeDMADescriptorsPerRow();
+
+  auto link = [&](uint8_t colouridx)
+  {
+    ESP32_I2S_DMA_STORAGE_TYPE *plane = _row.getDataPtr(colouridx);
+
+    if (update)
+    {
+      dma_bus.update_dma_desc_link(idx++, plane + hscroll_offset, len_1 * sizeof(ESP32_I2S_DMA_STORAGE_TYPE), _buff_id);
+      dma_bus.update_dma_desc_link(idx++, plane + start_2, (PIXELS_PER_ROW - len_1) * sizeof(ESP32_I2S_DMA_STORAGE_TYPE), _buff_id);
+    }
+    else
+    {
+      dma_bus.create_dma_desc_link(plane + hscroll_offset, len_1 * sizeof(ESP32_I2S_DMA_STORAGE_TYPE), _buff_id);
+      dma_bus.create_dma_desc_link(plane + start_2, (PIXELS_PER_ROW - len_1) * sizeof(ESP32_I2S_DMA_STORAGE_TYPE), _buff_id);
+    }
+  };
+
+  for (int i = 0; i < active_colour_depth; i++)
+    link(first_plane + i);
+
+  for (int i = lsbMsbTransitionBit + 1; i < active_colour_depth; i++)
+    for (int k = 0; k < (1 << (i - lsbMsbTransitionBit - 1)); k++)
+      link(first_plane + i);
+}
+
+/* There are 'bits' set in the frameStruct that we simply don't need to set every single time we change a pixel / DMA buffer co-ordinate.
+ *  For example, the bits that determine the address lines, we don't need to set these every time. Once they're in place, and assuming we
+ *  don't accidentally clear them, then we don't need to set them again.
+ *  So to save processing, we strip this logic out to the absolute bare minimum, which is toggling only the R,G,B pixels (bits) per co-ord.
+ *
+ *  Critical dependency: That 'updateMatrixDMABuffer(uint8_t red, uint8_t green, uint8_t blue)' has been run at least once over the
+ *                       entire frameBuffer to ensure all the non R,G,B bitmasks are in place (i.e. like OE, Address Lines etc.)
+ *
+ *  Note: If you change the brightness with setBrightness() you MUST then clearScreen() and repaint / flush the entire framebuffer.
+ */
+
+/** @brief - Update pixel at specific co-ordinate in the DMA buffer
+ *  this is the main method used to update DMA buffer on pixel-by-pixel level so it must be fast, real fast!
+ *  Let's put it into IRAM to avoid situations when it could be flushed out of instruction cache
+ *  and had to be read from spi-flash over and over again.
+ *  Yes, it is always a tradeoff between memory/speed/size, but compared to DMA-buffer size is not a big deal
+ *
+ *  Note: Cannot pass a negative co-ord as it makes no sense in the DMA bit array lookup.
+ */
+void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint16_t y_coord, uint8_t red, uint8_t green, uint8_t blue)
+{
+  if (!initialized)
+    return;
+
+  DRAW_BEGIN();
+
+  /* 1) Check that the co-ordinates are within range, or it'll break everything big time.
+   * Valid co-ordinates are from 0 to (MATRIX_XXXX-1)
+   */
+  if (x_coord >= PIXELS_PER_ROW || y_coord >= m_cfg.mx_height)
+  {
+    return;
+  }
+
+#ifdef USE_SHADOW_BUFFER
+  if (shadowFill(x_coord, y_coord, 1, 1, red, green, blue))
+    return;
+#endif
+
+  STATS_ENCODE(1);
+
+  /* LED Brightness Compensation. Because if we do a basic "red & mask" for example,
+   * we'll NEVER send the dimmest possible colour, due to binary skew.
+   * i.e. It's almost impossible for colour_depth_idx of 0 to be sent out to the MATRIX unless the 'value' of a colour is exactly '1'
+   * https://ledshield.wordpress.com/2012/11/13/led-brightness-to-your-eye-gamma-correction-no/
+   */
+  DO_BITPLANE_ENCODE()
 
   /* When using the drawPixel, we are obviously only changing the value of one x,y position,
    * however, the two-scan panels paint TWO lines at the same time
@@ -418,7 +903,7 @@ void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint
    * so we have to check for this and check the correct position of the MATRIX_DATA_STORAGE_TYPE
    * data.
    */
-  x_coord = ESP32_TX_FIFO_POSITION_ADJUST(x_coord);
+  x_coord = DMA_COLUMN(x_coord);
 
   uint16_t _colourbitclear = BITMASK_RGB1_CLEAR, _colourbitoffset = 0;
 
@@ -429,23 +914,19 @@ void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint
     y_coord -= ROWS_PER_FRAME;
   }
 
+  y_coord = vscrollRow(y_coord); // see scrollVertical()
+
+  MARK_DIRTY(y_coord, x_coord, x_coord + 1);
+
   // Iterating through colour depth bits, which we assume are 8 bits per RGB subpixel (24bpp)
   uint8_t colour_depth_idx = m_cfg.getPixelColorDepthBits();
   do
   {
     --colour_depth_idx;
 
-    // Extract bit at current depth index
-    uint16_t mask = (1 << colour_depth_idx);
-    uint16_t RGB_output_bits = 0;
-
     /* Per the .h file, the order of the output RGB bits is:
      * BIT_B2, BIT_G2, BIT_R2,    BIT_B1, BIT_G1, BIT_R1     */
-    RGB_output_bits |= (bool)(blue_val & mask); // --B
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(green_val & mask); // -BG
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(red_val & mask); // BGR
+    uint16_t RGB_output_bits = BITPLANE_RGB_BITS(colour_depth_idx); // BGR
     RGB_output_bits <<= _colourbitoffset;    // shift colour bits to the required position
 
     // Get the contents at this address,
@@ -456,11 +937,9 @@ void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint
     p[x_coord] &= _colourbitclear; // reset RGB bits
     p[x_coord] |= RGB_output_bits; // set new RGB bits
 
-#if defined(SPIRAM_DMA_BUFFER)
-    Cache_WriteBack_Addr((uint32_t)&p[x_coord], sizeof(ESP32_I2S_DMA_STORAGE_TYPE));
-#endif
-
   } while (colour_depth_idx); // end of colour depth loop (8)
+
+  DRAW_DONE();
 } // updateMatrixDMABuffer (specific co-ords change)
 
 
@@ -470,24 +949,28 @@ void MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint8_t red, uint8_t green, uint
   if (!initialized)
     return;
 
+  DRAW_BEGIN();
+
+#ifdef USE_SHADOW_BUFFER
+  if (shadowFill(0, 0, PIXELS_PER_ROW, m_cfg.mx_height, red, green, blue))
+    return;
+#endif
+
+  STATS_ENCODE(PIXELS_PER_ROW * m_cfg.mx_height);
+
   /* https://ledshield.wordpress.com/2012/11/13/led-brightness-to-your-eye-gamma-correction-no/ */
-  DO_BRIGHTNESS_COMPENSATION()  
+  DO_BITPLANE_ENCODE()
+
+  for (int row = 0; row < fb->rows; row++)
+    MARK_DIRTY(row, 0, PIXELS_PER_ROW);
 
   for (uint8_t colour_depth_idx = 0; colour_depth_idx < m_cfg.getPixelColorDepthBits(); colour_depth_idx++) // colour depth - 8 iterations
   {
     // let's precalculate RGB1 and RGB2 bits than flood it over the entire DMA buffer
-    uint16_t RGB_output_bits = 0;
-
-    // Extract bit at current depth index
-    uint16_t mask = (1 << colour_depth_idx);
 
     /* Per the .h file, the order of the output RGB bits is:
      * BIT_B2, BIT_G2, BIT_R2,    BIT_B1, BIT_G1, BIT_R1      */
-    RGB_output_bits |= (bool)(blue_val & mask); // --B
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(green_val & mask); // -BG
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(red_val & mask); // BGR
+    uint16_t RGB_output_bits = BITPLANE_RGB_BITS(colour_depth_idx); // BGR
 
     // Duplicate and shift across so we have have 6 populated bits of RGB1 and RGB2 pin values suitable for DMA buffer
     RGB_output_bits |= RGB_output_bits << BITS_RGB2_OFFSET; // BGRBGR
@@ -504,184 +987,1549 @@ void MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint8_t red, uint8_t green, uint
       ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(matrix_frame_parallel_row, colour_depth_idx);
 
       // iterate pixels in a row
-      int x_coord = fb->rowBits[matrix_frame_parallel_row]->width;
+      int x_coord = fb->rowBits[matrix_frame_parallel_row].width;
       do
       {
         --x_coord;
         p[x_coord] &= BITMASK_RGB12_CLEAR; // reset colour bits
         p[x_coord] |= RGB_output_bits;     // set new colour bits
 
-#if defined(SPIRAM_DMA_BUFFER)
-        Cache_WriteBack_Addr((uint32_t)&p[x_coord], sizeof(ESP32_I2S_DMA_STORAGE_TYPE));
-#endif
-
       } while (x_coord);
 
     } while (matrix_frame_parallel_row); // end row iteration
   }                                      // colour depth loop (8)
+
+  DRAW_DONE();
 } // updateMatrixDMABuffer (full frame paint)
 
-/**
- * @brief - clears and reinitializes colour/control data in DMA buffs
- * When allocated, DMA buffs might be dirty, so we need to blank it and initialize ABCDE,LAT,OE control bits.
- * Those control bits are constants during the entire DMA sweep and never changed when updating just pixel colour data
- * so we could set it once on DMA buffs initialization and forget.
- * This effectively clears buffers to blank BLACK and makes it ready to display output.
- * (Brightness control via OE bit manipulation is another case) - this must be done as well seperately!
+/** @brief - Update a run of pixels in one row of the DMA buffer
+ *  Same result as calling updateMatrixDMABuffer(x, y, r, g, b) for each pixel, but the top/bottom half
+ *  decision is made once, the brightness compensation is done once per pixel (not once per pixel per bitplane),
+ *  and each bitplane of the row is then walked sequentially.
+ *
+ *  Note: Co-ordinates must already be clipped to the panel by the caller.
  */
-void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
+void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABufferRow(uint16_t x_coord, uint16_t y_coord, uint16_t len, const uint8_t *rgb888, const uint16_t *rgb565)
 {
   if (!initialized)
     return;
 
-  frameStruct *fb = &frame_buffer[_buff_id];
+  DRAW_BEGIN();
 
-  // we start with iterating all rows in dma_buff structure
-  int row_idx = fb->rowBits.size();
-  
-  // abcde bitmask for TYPE_DIRECT line decoder
-  ESP32_I2S_DMA_STORAGE_TYPE abcde_mask;
-  if (row_idx == 2) abcde_mask = 0x3;  
-  else abcde_mask = 0xf;
+  // a run past the end of the DMA row (see scrollHorizontal()) carries on at its start, as a second run
+  if (hscrollColumn(x_coord) + len > PIXELS_PER_ROW)
+  {
+    uint16_t _len = PIXELS_PER_ROW - hscrollColumn(x_coord);
+    updateMatrixDMABufferRow(x_coord, y_coord, _len, rgb888, rgb565);
+    updateMatrixDMABufferRow(x_coord + _len, y_coord, len - _len, rgb888 ? rgb888 + _len * 3 : nullptr, rgb565 ? rgb565 + _len : nullptr);
+    return;
+  }
 
-  do
+#ifdef USE_SHADOW_BUFFER
+  if (shadowStoreRow(x_coord, y_coord, len, rgb888, rgb565))
+    return;
+#endif
+
+  STATS_ENCODE(len);
+
+  x_coord = hscrollColumn(x_coord);
+
+  uint16_t _colourbitclear = BITMASK_RGB1_CLEAR, _colourbitoffset = 0;
+
+  if (y_coord >= ROWS_PER_FRAME)
+  { // if we are drawing to the bottom part of the panel
+    _colourbitoffset = BITS_RGB2_OFFSET;
+    _colourbitclear = BITMASK_RGB2_CLEAR;
+    y_coord -= ROWS_PER_FRAME;
+  }
+
+  y_coord = vscrollRow(y_coord); // see scrollVertical()
+
+  MARK_DIRTY(y_coord, x_coord, x_coord + len);
+
+  // encoded colours for the current chunk of the row
+  BITPLANE_CHUNK_DECL(encoded);
+
+  while (len)
   {
-    --row_idx;
+    uint16_t _chunk = (len > ROW_ENCODE_CHUNK_PIXELS) ? ROW_ENCODE_CHUNK_PIXELS : len;
 
-    ESP32_I2S_DMA_STORAGE_TYPE *row = fb->rowBits[row_idx]->getDataPtr(0); // set pointer to the HEAD of a buffer holding data for the entire matrix row
-    ESP32_I2S_DMA_STORAGE_TYPE abcde = (ESP32_I2S_DMA_STORAGE_TYPE)row_idx;
-   
-    if (m_cfg.line_decoder == HUB75_I2S_CFG::TYPE_DIRECT)
-		{ 
-      abcde = abcde_mask & (~(1 << abcde)); 
+    for (uint16_t i = 0; i < _chunk; i++)
+    {
+      uint8_t red, green, blue;
+      if (rgb888)
+      {
+        red   = *rgb888++;
+        green = *rgb888++;
+        blue  = *rgb888++;
+      }
+      else
+      {
+        color565to888(*rgb565++, red, green, blue);
+      }
+
+      DO_BITPLANE_ENCODE()
+      BITPLANE_CHUNK_STORE(encoded, i);
     }
 
-    // get last pixel index in a row of all colourdepths
-    int x_pixel = fb->rowBits[row_idx]->width * fb->rowBits[row_idx]->colour_depth;
+    uint8_t colour_depth_idx = m_cfg.getPixelColorDepthBits();
+    do
+    {
+      --colour_depth_idx;
 
-	abcde <<= BITS_ADDR_OFFSET; // shift row y-coord to match ABCDE bits in vector from 8 to 12
-	do
-	{
-		--x_pixel;
-		if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5266P)
-		{
-			// modifications here for row shift register type SM5266P
-			// https://github.com/mrfaptastic/ESP32-HUB75-MatrixPanel-I2S-DMA/issues/164
-			row[x_pixel] = abcde & (0x18 << BITS_ADDR_OFFSET); // mask out the bottom 3 bits which are the clk di bk inputs
-		}
-		else if (m_cfg.line_decoder  == HUB75_I2S_CFG::SM5368) 
-		{
-			row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] = 0x0000;
-		}
-		else
-		{
-			row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] = abcde;
-		}
+      ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(y_coord, colour_depth_idx);
+
+      for (uint16_t i = 0; i < _chunk; i++)
+      {
+        /* Per the .h file, the order of the output RGB bits is:
+         * BIT_B2, BIT_G2, BIT_R2,    BIT_B1, BIT_G1, BIT_R1     */
+        uint16_t RGB_output_bits = BITPLANE_CHUNK_BITS(encoded, i, colour_depth_idx);
+
+        uint16_t &v = p[ESP32_TX_FIFO_POSITION_ADJUST(x_coord + i)];
+        v = (v & _colourbitclear) | (RGB_output_bits << _colourbitoffset);
+      }
+
+    } while (colour_depth_idx); // end of colour depth loop
+
+    x_coord += _chunk;
+    len -= _chunk;
+  }
+
+  DRAW_DONE();
+} // updateMatrixDMABufferRow()
+
+/** @brief - Update a run of pixels in both halves of a DMA row
+ *  Each DMA word carries R1G1B1 for matrix row 'row' and R2G2B2 for row 'row' + ROWS_PER_FRAME,
+ *  so encoding both source rows together produces the final 6 colour bits of a word in one go.
+ *  Every word of every bitplane is then read and written back exactly once, instead of twice
+ *  (once per half) as with updateMatrixDMABuffer() / updateMatrixDMABufferRow().
+ *
+ *  Note: Co-ordinates must already be clipped to the panel by the caller. A nullptr source leaves that half as it is.
+ */
+void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABufferRowPair(uint16_t x_coord, uint16_t row, uint16_t len, const uint8_t *upper, const uint8_t *lower)
+{
+  if (!initialized || (upper == nullptr && lower == nullptr))
+    return;
+
+  DRAW_BEGIN();
+
+  // a run past the end of the DMA row (see scrollHorizontal()) carries on at its start, as a second run
+  if (hscrollColumn(x_coord) + len > PIXELS_PER_ROW)
+  {
+    uint16_t _len = PIXELS_PER_ROW - hscrollColumn(x_coord);
+    updateMatrixDMABufferRowPair(x_coord, row, _len, upper, lower);
+    updateMatrixDMABufferRowPair(x_coord + _len, row, len - _len, upper ? upper + _len * 3 : nullptr, lower ? lower + _len * 3 : nullptr);
+    return;
+  }
+
+#ifdef USE_SHADOW_BUFFER
+  bool _deferred = shadow_deferred;
+  if (upper)
+    shadowStoreRow(x_coord, row, len, upper, nullptr);
+  if (lower)
+    shadowStoreRow(x_coord, row + ROWS_PER_FRAME, len, lower, nullptr);
+  if (_deferred)
+    return;
+#endif
+
+  STATS_ENCODE((upper && lower) ? len * 2 : len);
+
+  x_coord = hscrollColumn(x_coord);
+
+  uint16_t _colourbitclear = BITMASK_RGB12_CLEAR;
+
+  if (upper == nullptr)
+    _colourbitclear = BITMASK_RGB2_CLEAR;
+  else if (lower == nullptr)
+    _colourbitclear = BITMASK_RGB1_CLEAR;
+
+  row = vscrollRow(row);
+
+  MARK_DIRTY(row, x_coord, x_coord + len);
+
+  // encoded colours for the current chunk of both rows, a missing half stays black and is masked out anyway
+  BITPLANE_CHUNK_DECL(encoded_upper) = {};
+  BITPLANE_CHUNK_DECL(encoded_lower) = {};
+
+  while (len)
+  {
+    uint16_t _chunk = (len > ROW_ENCODE_CHUNK_PIXELS) ? ROW_ENCODE_CHUNK_PIXELS : len;
+
+    for (uint16_t i = 0; upper && i < _chunk; i++)
+    {
+      uint8_t red   = *upper++;
+      uint8_t green = *upper++;
+      uint8_t blue  = *upper++;
+
+      DO_BITPLANE_ENCODE()
+      BITPLANE_CHUNK_STORE(encoded_upper, i);
+    }
+
+    for (uint16_t i = 0; lower && i < _chunk; i++)
+    {
+      uint8_t red   = *lower++;
+      uint8_t green = *lower++;
+      uint8_t blue  = *lower++;
+
+      DO_BITPLANE_ENCODE()
+      BITPLANE_CHUNK_STORE(encoded_lower, i);
+    }
+
+    uint8_t colour_depth_idx = m_cfg.getPixelColorDepthBits();
+    do
+    {
+      --colour_depth_idx;
+
+      ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(row, colour_depth_idx);
+
+      for (uint16_t i = 0; i < _chunk; i++)
+      {
+        /* Per the .h file, the order of the output RGB bits is:
+         * BIT_B2, BIT_G2, BIT_R2,    BIT_B1, BIT_G1, BIT_R1     */
+        uint16_t RGB_output_bits = BITPLANE_CHUNK_BITS(encoded_lower, i, colour_depth_idx) << BITS_RGB2_OFFSET;
+        RGB_output_bits |= BITPLANE_CHUNK_BITS(encoded_upper, i, colour_depth_idx);
+
+        uint16_t &v = p[ESP32_TX_FIFO_POSITION_ADJUST(x_coord + i)];
+        v = (v & _colourbitclear) | RGB_output_bits;
+      }
+
+    } while (colour_depth_idx); // end of colour depth loop
+
+    x_coord += _chunk;
+    len -= _chunk;
+  }
+
+  DRAW_DONE();
+} // updateMatrixDMABufferRowPair()
+
+/** @brief - inverse of the brightness compensation, for reading pixels back from the bitplanes
+ *  A range of 8 bit values usually compensates to the same 'val', the middle of it is returned. Except for the
+ *  ranges holding 0 and 255, so black and full colour read back as such. The compensation curve never decreases,
+ *  so the range ends are found with a binary search over the 8 bit input, rather than with an inverse table.
+ */
+uint8_t MatrixPanel_I2S_DMA::uncompensate(uint16_t val) const
+{
+  // lowest 8 bit value that compensates to 'v' or more, 256 if none does
+  auto lower_bound = [this](uint16_t v) -> uint16_t
+  {
+    uint16_t lo = 0, hi = 256;
+    while (lo < hi)
+    {
+      uint8_t red = (lo + hi) / 2, green = 0, blue = 0;
+
+      DO_BRIGHTNESS_COMPENSATION()
+      (void)green_val;
+      (void)blue_val;
+
+      if (red_val < v)
+        lo = red + 1;
+      else
+        hi = red;
+    }
+    return lo;
+  };
+
+  uint16_t first = lower_bound(val), next = lower_bound(val + 1);
+
+  if (first == 0)
+    return 0;
+
+  if (next > 255)
+    return 255;
+
+  if (next == first) // nothing compensates to 'val' exactly
+    return first;
+
+  return (first + next - 1) / 2;
+}
+
+bool MatrixPanel_I2S_DMA::getPixelRaw(int16_t x, int16_t y, uint16_t &r, uint16_t &g, uint16_t &b)
+{
+  int16_t w = 1, h = 1;
+  transform(x, y, w, h);
+
+  if (!initialized || x < 0 || y < 0 || x >= PIXELS_PER_ROW || y >= m_cfg.mx_height)
+    return false;
+
+  DRAW_BEGIN();
+
+  uint8_t _colourbitoffset = 0;
+
+  if (y >= ROWS_PER_FRAME)
+  { // bottom half of the panel
+    _colourbitoffset = BITS_RGB2_OFFSET;
+    y -= ROWS_PER_FRAME;
+  }
+
+  y = vscrollRow(y);
+
+  x = DMA_COLUMN(x);
+
+  r = g = b = 0;
+  for (uint8_t colour_depth_idx = 0; colour_depth_idx < m_cfg.getPixelColorDepthBits(); colour_depth_idx++)
+  {
+    const ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(y, colour_depth_idx);
+    uint16_t v = p[x] >> _colourbitoffset;
+
+    r |= (v & 1) << colour_depth_idx;
+    g |= ((v >> 1) & 1) << colour_depth_idx;
+    b |= ((v >> 2) & 1) << colour_depth_idx;
+  }
+
+  return true;
+}
+
+bool MatrixPanel_I2S_DMA::getPixelRGB(int16_t x, int16_t y, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+  uint16_t red_val, green_val, blue_val;
+
+  if (!getPixelRaw(x, y, red_val, green_val, blue_val))
+    return false;
+
+  r = uncompensate(red_val);
+  g = uncompensate(green_val);
+  b = uncompensate(blue_val);
+  return true;
+}
+
+int16_t MatrixPanel_I2S_DMA::readRow(int16_t y, uint8_t *rgb, int16_t x0, int16_t len)
+{
+  if (!initialized || rgb == nullptr || len < 1)
+    return 0;
+
+  DRAW_BEGIN();
+
+#ifndef NO_GFX
+  if (rotation)
+  { // rotated rows are no longer contiguous in the DMA buffer, so go pixel by pixel
+    int16_t _read = 0;
+    for (int16_t i = 0; i < len; i++, rgb += 3)
+      _read += getPixelRGB(x0 + i, y, rgb[0], rgb[1], rgb[2]);
+    return _read;
+  }
+#endif
+
+  if (y < 0 || y >= m_cfg.mx_height || x0 >= PIXELS_PER_ROW || (x0 + len) < 1)
+    return 0;
+
+  if (x0 < 0)
+  {
+    rgb -= x0 * 3;
+    len += x0;
+    x0 = 0;
+  }
+
+  len = ((x0 + len) >= PIXELS_PER_ROW) ? (PIXELS_PER_ROW - x0) : len;
+
+  uint8_t _colourbitoffset = 0;
+
+  if (y >= ROWS_PER_FRAME)
+  { // bottom half of the panel
+    _colourbitoffset = BITS_RGB2_OFFSET;
+    y -= ROWS_PER_FRAME;
+  }
+
+  y = vscrollRow(y);
+
+  // colour depth values of the current chunk of the row
+  uint16_t values[ROW_ENCODE_CHUNK_PIXELS][3];
+
+  for (int16_t x = x0; x < x0 + len; x += ROW_ENCODE_CHUNK_PIXELS)
+  {
+    int16_t _chunk = (x0 + len - x > ROW_ENCODE_CHUNK_PIXELS) ? ROW_ENCODE_CHUNK_PIXELS : x0 + len - x;
+
+    memset(values, 0, sizeof(values));
+
+    for (uint8_t colour_depth_idx = 0; colour_depth_idx < m_cfg.getPixelColorDepthBits(); colour_depth_idx++)
+    {
+      const ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(y, colour_depth_idx);
+
+      for (int16_t i = 0; i < _chunk; i++)
+      {
+        uint16_t v = p[DMA_COLUMN(x + i)] >> _colourbitoffset;
+
+        values[i][0] |= (v & 1) << colour_depth_idx;
+        values[i][1] |= ((v >> 1) & 1) << colour_depth_idx;
+        values[i][2] |= ((v >> 2) & 1) << colour_depth_idx;
+      }
+    }
+
+    // neighbouring pixels are often the same colour, so only search for a value when it changes
+    uint16_t _last = UINT16_MAX;
+    uint8_t _last_8bit = 0;
+
+    for (int16_t i = 0; i < _chunk * 3; i++)
+    {
+      uint16_t v = values[i / 3][i % 3];
+      if (v != _last)
+      {
+        _last = v;
+        _last_8bit = uncompensate(v);
+      }
+      *rgb++ = _last_8bit;
+    }
+  }
+
+  return len;
+} // readRow()
+
+/** @brief - halve the brightness compensated colour values 'shift' times, bitplane by bitplane
+ *  Plane n takes the colour bits of plane n + shift, from the least significant up so each is read before it's overwritten,
+ *  and the top 'shift' planes go black. Every bitplane is faded, sent or not (see setColorDepth()).
+ */
+void MatrixPanel_I2S_DMA::fadeFrame(uint8_t shift)
+{
+  if (!initialized || shift == 0)
+    return;
+
+  DRAW_BEGIN();
+
+  const uint8_t depth = m_cfg.getPixelColorDepthBits();
+  if (shift > depth)
+    shift = depth;
+
+  for (int row = 0; row < fb->rows; row++)
+  {
+    rowBitStruct &_row = fb->rowBits[row];
+
+    for (uint8_t colouridx = 0; colouridx < depth; colouridx++)
+      copyColourBits(_row.getDataPtr(colouridx), (colouridx + shift < depth) ? _row.getDataPtr(colouridx + shift) : nullptr, _row.width);
+
+    MARK_DIRTY(row, 0, PIXELS_PER_ROW);
+  }
+
+#ifdef USE_SHADOW_BUFFER
+  shadowScale(1, shift);
+#endif
+
+  DRAW_DONE();
+} // fadeFrame()
+
+/** @brief - multiply the brightness compensated colour values by numerator / 256 in the bitplanes, see dimWord()
+ *  A power of two is just a fadeFrame().
+ */
+void MatrixPanel_I2S_DMA::dimFrame(uint8_t numerator)
+{
+  if (!initialized)
+    return;
+
+  DRAW_BEGIN();
+
+  const uint8_t depth = m_cfg.getPixelColorDepthBits();
+
+  if ((numerator & (numerator - 1)) == 0)
+  {
+    uint8_t shift = 8;
+    while (numerator > 1)
+    {
+      numerator >>= 1;
+      shift--;
+    }
+    fadeFrame(numerator ? shift : depth);
+    return;
+  }
+
+  ESP32_I2S_DMA_STORAGE_TYPE *planes[PIXEL_COLOR_DEPTH_BITS_MAX];
+  colour_pair_t *pairs[PIXEL_COLOR_DEPTH_BITS_MAX];
+
+  for (int row = 0; row < fb->rows; row++)
+  {
+    rowBitStruct &_row = fb->rowBits[row];
+    uintptr_t align = 0;
+
+    for (uint8_t colouridx = 0; colouridx < depth; colouridx++)
+    {
+      planes[colouridx] = _row.getDataPtr(colouridx);
+      pairs[colouridx] = (colour_pair_t *)planes[colouridx];
+      align |= (uintptr_t)planes[colouridx];
+    }
+
+    size_t x = 0;
+
+    // two columns, i.e. four pixels, at a time
+    if ((align & 3) == 0)
+      for (; x + 1 < _row.width; x += 2)
+        dimWord<colour_pair_t>(pairs, x / 2, depth, numerator, COLOUR_PAIR_RGB);
+
+    for (; x < _row.width; x++)
+      dimWord<ESP32_I2S_DMA_STORAGE_TYPE>(planes, x, depth, numerator, (ESP32_I2S_DMA_STORAGE_TYPE)~BITMASK_RGB12_CLEAR);
+
+    MARK_DIRTY(row, 0, PIXELS_PER_ROW);
+  }
+
+#ifdef USE_SHADOW_BUFFER
+  shadowScale(numerator, 8);
+#endif
+
+  DRAW_DONE();
+} // dimFrame()
+
+/** @brief - copy the colour bits of a rectangle of pixels to another place in the bitplanes
+ *  Each pixel's 3 bits are taken from the half of the panel (RGB1 / RGB2 position) it's in and put into the half it goes to,
+ *  the control bits of the words around them stay as they are. Row by row, in the order that doesn't overwrite a pixel before it's read.
+ */
+void MatrixPanel_I2S_DMA::copyRect(int16_t src_x, int16_t src_y, int16_t w, int16_t h, int16_t dst_x, int16_t dst_y)
+{
+  if (!initialized || w < 1 || h < 1)
+    return;
+
+  DRAW_BEGIN();
+
+  // both rectangles turn the same way, so pixel i,j of one still goes to pixel i,j of the other
+  int16_t _w = w, _h = h;
+  transform(src_x, src_y, w, h);
+  transform(dst_x, dst_y, _w, _h);
+
+  // leave out what's off the panel at either end
+  if (src_x < 0) { dst_x -= src_x; w += src_x; src_x = 0; }
+  if (dst_x < 0) { src_x -= dst_x; w += dst_x; dst_x = 0; }
+  if (src_y < 0) { dst_y -= src_y; h += src_y; src_y = 0; }
+  if (dst_y < 0) { src_y -= dst_y; h += dst_y; dst_y = 0; }
+
+  w = std::min<int16_t>(w, PIXELS_PER_ROW - std::max(src_x, dst_x));
+  h = std::min<int16_t>(h, m_cfg.mx_height - std::max(src_y, dst_y));
+
+  if (w < 1 || h < 1 || (src_x == dst_x && src_y == dst_y))
+    return;
+
+#ifdef USE_SHADOW_BUFFER
+  if (shadowCopyRect(src_x, src_y, w, h, dst_x, dst_y))
+    return;
+#endif
+
+  // like memmove(), a destination further on is copied from the far end so nothing is overwritten before it's read
+  const bool rows_back = dst_y > src_y;
+  const bool cols_back = dst_y == src_y && dst_x > src_x;
+  const uint8_t depth = m_cfg.getPixelColorDepthBits();
+
+  // Neither run goes past the end of the DMA row (see scrollHorizontal()) and, in the ESP32's FIFO order, both are whole
+  // pairs of columns: then every bitplane's run of source words is just copied into the destination run as it is
+  const uint16_t _src_x0 = hscrollColumn(src_x), _dst_x0 = hscrollColumn(dst_x);
+  bool _runs = (_src_x0 + w <= PIXELS_PER_ROW) && (_dst_x0 + w <= PIXELS_PER_ROW);
+#if defined(ESP32_THE_ORIG)
+  _runs = _runs && !((_src_x0 | _dst_x0 | w) & 1);
+#endif
+
+  uint16_t src_col[ROW_ENCODE_CHUNK_PIXELS], dst_col[ROW_ENCODE_CHUNK_PIXELS];
+
+  for (int16_t j = 0; j < h; j++)
+  {
+    int16_t _sy = src_y + (rows_back ? h - 1 - j : j);
+    int16_t _dy = dst_y + (rows_back ? h - 1 - j : j);
+
+    uint8_t _src_offset = 0, _dst_offset = 0;
+    uint16_t _dst_clear = BITMASK_RGB1_CLEAR;
+
+    if (_sy >= ROWS_PER_FRAME)
+    { // bottom half of the panel
+      _src_offset = BITS_RGB2_OFFSET;
+      _sy -= ROWS_PER_FRAME;
+    }
+
+    if (_dy >= ROWS_PER_FRAME)
+    {
+      _dst_offset = BITS_RGB2_OFFSET;
+      _dst_clear = BITMASK_RGB2_CLEAR;
+      _dy -= ROWS_PER_FRAME;
+    }
+
+    rowBitStruct &_src_row = fb->rowBits[vscrollRow(_sy)];
+    rowBitStruct &_dst_row = fb->rowBits[vscrollRow(_dy)];
+
+    // the 3 colour bits of one word into their place in another
+    auto _move = [=](ESP32_I2S_DMA_STORAGE_TYPE s, ESP32_I2S_DMA_STORAGE_TYPE &d)
+    {
+      d = (d & _dst_clear) | (((s >> _src_offset) & (ESP32_I2S_DMA_STORAGE_TYPE)~BITMASK_RGB1_CLEAR) << _dst_offset);
+    };
+
+    if (_runs)
+    {
+      for (uint8_t colour_depth_idx = 0; colour_depth_idx < depth; colour_depth_idx++)
+      {
+        const ESP32_I2S_DMA_STORAGE_TYPE *ps = _src_row.getDataPtr(colour_depth_idx) + _src_x0;
+        ESP32_I2S_DMA_STORAGE_TYPE *pd = _dst_row.getDataPtr(colour_depth_idx) + _dst_x0;
+
+        if (cols_back)
+          for (int16_t i = w - 1; i >= 0; i--)
+            _move(ps[i], pd[i]);
+        else
+          for (int16_t i = 0; i < w; i++)
+            _move(ps[i], pd[i]);
+      }
+    }
+    else
+    {
+      // the columns looked up (hscroll, FIFO order) a chunk at a time, for every bitplane
+      for (int16_t c = 0; c < w; c += ROW_ENCODE_CHUNK_PIXELS)
+      {
+        const int16_t _chunk = std::min<int16_t>(w - c, ROW_ENCODE_CHUNK_PIXELS);
+        const int16_t _first = cols_back ? w - c - _chunk : c;
+
+        for (int16_t i = 0; i < _chunk; i++)
+        {
+          src_col[i] = DMA_COLUMN(src_x + _first + i);
+          dst_col[i] = DMA_COLUMN(dst_x + _first + i);
+        }
+
+        for (uint8_t colour_depth_idx = 0; colour_depth_idx < depth; colour_depth_idx++)
+        {
+          const ESP32_I2S_DMA_STORAGE_TYPE *ps = _src_row.getDataPtr(colour_depth_idx);
+          ESP32_I2S_DMA_STORAGE_TYPE *pd = _dst_row.getDataPtr(colour_depth_idx);
+
+          for (int16_t k = 0; k < _chunk; k++)
+          {
+            const int16_t i = cols_back ? _chunk - 1 - k : k;
+            _move(ps[src_col[i]], pd[dst_col[i]]);
+          }
+        }
+      }
+    }
+
+#if defined(USE_DIRTY_TRACKING) || defined(SPIRAM_DMA_BUFFER)
+    // the destination run, which carries on at the start of the DMA row if it goes past its end
+    const uint16_t _row = vscrollRow(_dy);
+    if (_dst_x0 + w > PIXELS_PER_ROW)
+    {
+      MARK_DIRTY(_row, _dst_x0, PIXELS_PER_ROW);
+      MARK_DIRTY(_row, 0, _dst_x0 + w - PIXELS_PER_ROW);
+    }
+    else
+    {
+      MARK_DIRTY(_row, _dst_x0, _dst_x0 + w);
+    }
+#endif
+  }
+
+  DRAW_DONE();
+} // copyRect()
+
+bool MatrixPanel_I2S_DMA::encodeSprite(BitplaneSprite &sprite, const uint8_t *rgb888, int16_t w, int16_t h, int32_t transparent)
+{
+  return encodeSpritePixels(sprite, rgb888, nullptr, w, h, transparent);
+}
+
+bool MatrixPanel_I2S_DMA::encodeSprite(BitplaneSprite &sprite, const uint16_t *rgb565, int16_t w, int16_t h, int32_t transparent)
+{
+  return encodeSpritePixels(sprite, nullptr, rgb565, w, h, transparent);
+}
+
+/** @brief - encode every pixel of an image once, the way updateMatrixDMABufferRow() does, into the sprite's bytes
+ *  The bits of each bitplane are kept in the R1G1B1 position, drawSprite() moves them to the half of the panel they go to.
+ */
+bool MatrixPanel_I2S_DMA::encodeSpritePixels(BitplaneSprite &sprite, const uint8_t *rgb888, const uint16_t *rgb565, int16_t w, int16_t h, int32_t transparent)
+{
+  if (!initialized || (rgb888 == nullptr && rgb565 == nullptr) || w < 1 || h < 1)
+    return false;
+
+  const uint8_t depth = m_cfg.getPixelColorDepthBits();
+  const size_t _bytes = (size_t)w * h * depth;
+
+  sprite.storage.clear();
+  sprite.storage.shrink_to_fit();
+  sprite.data = nullptr;
+  sprite.width = sprite.height = 0;
+
+  if (heap_caps_get_largest_free_block(MALLOC_CAP_8BIT) < _bytes)
+  {
+    ESP_LOGE("I2S-DMA", "Could not allocate %u bytes for a %dx%d sprite.", (unsigned int)_bytes, w, h);
+    return false;
+  }
+
+  sprite.storage.resize(_bytes);
+  sprite.width = w;
+  sprite.height = h;
+  sprite.depth = depth;
+  sprite.data = sprite.storage.data();
+
+  for (int16_t y = 0; y < h; y++)
+  {
+    uint8_t *row = sprite.storage.data() + (size_t)y * depth * w;
+
+    for (int16_t x = 0; x < w; x++)
+    {
+      uint8_t red, green, blue;
+      if (rgb888)
+      {
+        red   = *rgb888++;
+        green = *rgb888++;
+        blue  = *rgb888++;
+      }
+      else
+      {
+        color565to888(*rgb565++, red, green, blue);
+      }
+
+      if (transparent >= 0 && color565(red, green, blue) == (uint16_t)transparent)
+      {
+        for (uint8_t colour_depth_idx = 0; colour_depth_idx < depth; colour_depth_idx++)
+          row[colour_depth_idx * w + x] = SPRITE_TRANSPARENT;
+        continue;
+      }
+
+      DO_BITPLANE_ENCODE()
+
+      for (uint8_t colour_depth_idx = 0; colour_depth_idx < depth; colour_depth_idx++)
+        row[colour_depth_idx * w + x] = (uint8_t)BITPLANE_RGB_BITS(colour_depth_idx);
+    }
+  }
+
+  return true;
+} // encodeSpritePixels()
+
+bool MatrixPanel_I2S_DMA::getSpritePixelRGB(const BitplaneSprite &sprite, int16_t sx, int16_t sy, uint8_t &r, uint8_t &g, uint8_t &b) const
+{
+  uint16_t red_val = 0, green_val = 0, blue_val = 0;
+  for (uint8_t colour_depth_idx = 0; colour_depth_idx < sprite.depth; colour_depth_idx++)
+  {
+    uint8_t v = sprite.getRowPtr(sy, colour_depth_idx)[sx];
+    if (v & SPRITE_TRANSPARENT)
+      return false;
+
+    red_val |= (v & 1) << colour_depth_idx;
+    green_val |= ((v >> 1) & 1) << colour_depth_idx;
+    blue_val |= ((v >> 2) & 1) << colour_depth_idx;
+  }
+
+  r = uncompensate(red_val);
+  g = uncompensate(green_val);
+  b = uncompensate(blue_val);
+  return true;
+}
+
+/* A run of 'len' sprite bytes into DMA words from column x_coord on: a transparent byte keeps all of its word, any other
+ * replaces the colour bits of its half of the panel with its own. */
+static inline void drawSpriteRun(ESP32_I2S_DMA_STORAGE_TYPE *p, uint16_t x_coord, const uint8_t *src, uint16_t len, uint16_t _colourbitclear, uint8_t _colourbitoffset)
+{
+  for (uint16_t i = 0; i < len; i++)
+  {
+    // all ones for a transparent byte, which has no colour bits either
+    const uint16_t _keep = _colourbitclear | (uint16_t)(0 - (src[i] >> 3));
+
+    uint16_t &v = p[ESP32_TX_FIFO_POSITION_ADJUST(x_coord + i)];
+    v = (v & _keep) | ((src[i] & 0x7) << _colourbitoffset);
+  }
+}
+
+void MatrixPanel_I2S_DMA::drawSprite(const BitplaneSprite &sprite, int16_t x, int16_t y)
+{
+  if (!initialized || sprite.data == nullptr || sprite.width < 1 || sprite.height < 1)
+    return;
+
+  if (sprite.depth != m_cfg.getPixelColorDepthBits())
+  {
+    ESP_LOGW("I2S-DMA", "Sprite encoded for %d bit colour depth, not %d. Not drawn.", sprite.depth, m_cfg.getPixelColorDepthBits());
+    return;
+  }
+
+  DRAW_BEGIN();
+
+#ifndef NO_GFX
+  if (rotation)
+  { // rotated rows are no longer contiguous in the DMA buffer, so go pixel by pixel
+    for (int16_t j = 0; j < sprite.height; j++)
+      for (int16_t i = 0; i < sprite.width; i++)
+      {
+        uint8_t r, g, b;
+        if (getSpritePixelRGB(sprite, i, j, r, g, b))
+          drawPixelRGB888(x + i, y + j, r, g, b);
+      }
+    return;
+  }
+#endif
+
+  // clip the sprite to the panel
+  int16_t _x0 = (x < 0) ? 0 : x;
+  int16_t _y0 = (y < 0) ? 0 : y;
+  int16_t _x1 = ((x + sprite.width) > PIXELS_PER_ROW) ? PIXELS_PER_ROW : (x + sprite.width);
+  int16_t _y1 = ((y + sprite.height) > m_cfg.mx_height) ? m_cfg.mx_height : (y + sprite.height);
+
+  if (_x0 >= _x1 || _y0 >= _y1)
+    return;
+
+#ifdef USE_SHADOW_BUFFER
+  if (shadowStoreSprite(sprite, _x0 - x, _y0 - y, _x1 - _x0, _y1 - _y0, _x0, _y0))
+    return;
+#endif
+
+  const uint8_t depth = sprite.depth;
+  const uint16_t len = _x1 - _x0;
+
+  // a run past the end of the DMA row (see scrollHorizontal()) carries on at its start
+  const uint16_t x_coord = hscrollColumn(_x0);
+  const uint16_t _first = (x_coord + len > PIXELS_PER_ROW) ? PIXELS_PER_ROW - x_coord : len;
+
+  for (int16_t y_coord = _y0; y_coord < _y1; y_coord++)
+  {
+    uint16_t _colourbitclear = BITMASK_RGB1_CLEAR;
+    uint8_t _colourbitoffset = 0;
+    int16_t _row = y_coord;
+
+    if (_row >= ROWS_PER_FRAME)
+    { // bottom half of the panel
+      _colourbitoffset = BITS_RGB2_OFFSET;
+      _colourbitclear = BITMASK_RGB2_CLEAR;
+      _row -= ROWS_PER_FRAME;
+    }
+
+    _row = vscrollRow(_row);
+
+    for (uint8_t colour_depth_idx = 0; colour_depth_idx < depth; colour_depth_idx++)
+    {
+      const uint8_t *src = sprite.getRowPtr(y_coord - y, colour_depth_idx) + (_x0 - x);
+      ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(_row, colour_depth_idx);
+
+      drawSpriteRun(p, x_coord, src, _first, _colourbitclear, _colourbitoffset);
+      if (_first < len)
+        drawSpriteRun(p, 0, src + _first, len - _first, _colourbitclear, _colourbitoffset);
+    }
+
+    MARK_DIRTY(_row, x_coord, x_coord + _first);
+    if (_first < len)
+      MARK_DIRTY(_row, 0, len - _first);
+  }
+
+  DRAW_DONE();
+} // drawSprite()
+
+void MatrixPanel_I2S_DMA::drawIcon(int *ico, int16_t x, int16_t y, int16_t cols, int16_t rows)
+{
+  if (ico == nullptr || cols < 1)
+    return;
+
+  // the icon's colours narrowed to RGB565 a chunk of a row at a time, for drawRowRGB565() to encode
+  uint16_t rgb565[ROW_ENCODE_CHUNK_PIXELS];
+
+  for (int16_t j = 0; j < rows; j++)
+    for (int16_t i = 0; i < cols; i += ROW_ENCODE_CHUNK_PIXELS)
+    {
+      const int16_t _chunk = std::min<int16_t>(cols - i, ROW_ENCODE_CHUNK_PIXELS);
+      for (int16_t k = 0; k < _chunk; k++)
+        rgb565[k] = (uint16_t)ico[j * cols + i + k];
+
+      drawRowRGB565(y + j, rgb565, x + i, _chunk);
+    }
+}
+
+#ifdef USE_BITPLANE_LUT
+/** @brief - Build the per channel bit-spreading tables used to encode pixels
+ *  For every 8 bit input value the brightness compensated output value is spread out to 3 bits per bitplane,
+ *  with the channel's bit at the R, G or B position of that plane. A pixel's RGB bits for plane 'n' are then
+ *  just (bitplane_lut[0][r] | bitplane_lut[1][g] | bitplane_lut[2][b]) >> (3 * n).
+ */
+void MatrixPanel_I2S_DMA::buildBitplaneLUT()
+{
+  for (uint16_t v = 0; v < 256; v++)
+  {
+    uint8_t red = v, green = v, blue = v;
+
+    DO_BRIGHTNESS_COMPENSATION()
+    (void)green_val;
+    (void)blue_val;
+
+    bitplane_lut_t spread = 0;
+    for (uint8_t colour_depth_idx = 0; colour_depth_idx < m_cfg.getPixelColorDepthBits(); colour_depth_idx++)
+    {
+      spread |= (bitplane_lut_t)((red_val >> colour_depth_idx) & 1) << (3 * colour_depth_idx);
+    }
+
+    bitplane_lut[0][v] = spread;      // R
+    bitplane_lut[1][v] = spread << 1; // G
+    bitplane_lut[2][v] = spread << 2; // B
+  }
+} // buildBitplaneLUT()
+#endif
+
+void MatrixPanel_I2S_DMA::drawRowRGB888(int16_t y, const uint8_t *rgb, int16_t x0, int16_t len)
+{
+  if (!initialized || rgb == nullptr)
+    return;
+
+#ifndef NO_GFX
+  if (rotation)
+  { // rotated rows are no longer contiguous in the DMA buffer, so go pixel by pixel
+    for (int16_t i = 0; i < len; i++, rgb += 3)
+      drawPixelRGB888(x0 + i, y, rgb[0], rgb[1], rgb[2]);
+    return;
+  }
+#endif
+
+  if (y < 0 || y >= m_cfg.mx_height || len < 1 || x0 >= PIXELS_PER_ROW || (x0 + len) < 1)
+    return;
+
+  if (x0 < 0)
+  {
+    rgb -= x0 * 3;
+    len += x0;
+    x0 = 0;
+  }
+
+  len = ((x0 + len) >= PIXELS_PER_ROW) ? (PIXELS_PER_ROW - x0) : len;
+
+  updateMatrixDMABufferRow(x0, y, len, rgb, nullptr);
+}
+
+void MatrixPanel_I2S_DMA::drawRowRGB565(int16_t y, const uint16_t *rgb565, int16_t x0, int16_t len)
+{
+  if (!initialized || rgb565 == nullptr)
+    return;
+
+#ifndef NO_GFX
+  if (rotation)
+  { // rotated rows are no longer contiguous in the DMA buffer, so go pixel by pixel
+    for (int16_t i = 0; i < len; i++)
+      drawPixel(x0 + i, y, rgb565[i]);
+    return;
+  }
+#endif
+
+  if (y < 0 || y >= m_cfg.mx_height || len < 1 || x0 >= PIXELS_PER_ROW || (x0 + len) < 1)
+    return;
+
+  if (x0 < 0)
+  {
+    rgb565 -= x0;
+    len += x0;
+    x0 = 0;
+  }
+
+  len = ((x0 + len) >= PIXELS_PER_ROW) ? (PIXELS_PER_ROW - x0) : len;
+
+  updateMatrixDMABufferRow(x0, y, len, nullptr, rgb565);
+}
+
+void MatrixPanel_I2S_DMA::pushFrameRGB888(const uint8_t *rgb)
+{
+  pushRectRGB888(0, 0, width(), height(), rgb);
+}
+
+void MatrixPanel_I2S_DMA::pushRectRGB888(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *rgb)
+{
+  if (!initialized || rgb == nullptr || w < 1 || h < 1)
+    return;
+
+#ifndef NO_GFX
+  if (rotation)
+  { // rotated rows are no longer contiguous in the DMA buffer, so go pixel by pixel
+    for (int16_t j = 0; j < h; j++)
+      for (int16_t i = 0; i < w; i++, rgb += 3)
+        drawPixelRGB888(x + i, y + j, rgb[0], rgb[1], rgb[2]);
+    return;
+  }
+#endif
+
+  // clip the rectangle to the panel, keeping the source stride
+  int16_t _x0 = (x < 0) ? 0 : x;
+  int16_t _y0 = (y < 0) ? 0 : y;
+  int16_t _x1 = ((x + w) > PIXELS_PER_ROW) ? PIXELS_PER_ROW : (x + w);
+  int16_t _y1 = ((y + h) > m_cfg.mx_height) ? m_cfg.mx_height : (y + h);
+
+  if (_x0 >= _x1 || _y0 >= _y1)
+    return;
+
+  const size_t _stride = (size_t)w * 3;
+  rgb += (_x0 - x) * 3;
+
+  // walk the DMA rows, each one carries a source row from the top half and one from the bottom half
+  for (int16_t row = 0; row < ROWS_PER_FRAME; row++)
+  {
+    int16_t y_lower = row + ROWS_PER_FRAME;
+
+    const uint8_t *upper = (row >= _y0 && row < _y1) ? rgb + (row - y) * _stride : nullptr;
+    const uint8_t *lower = (y_lower >= _y0 && y_lower < _y1) ? rgb + (y_lower - y) * _stride : nullptr;
+
+    if (upper || lower)
+      updateMatrixDMABufferRowPair(_x0, row, _x1 - _x0, upper, lower);
+  }
+}
+
+/**
+ * @brief - clears and reinitializes colour/control data in DMA buffs
+ * When allocated, DMA buffs might be dirty, so we need to blank it and initialize ABCDE,LAT,OE control bits.
+ * Those control bits are constants during the entire DMA sweep and never changed when updating just pixel colour data
+ * so we could set it once on DMA buffs initialization and forget.
+ * This effectively clears buffers to blank BLACK and makes it ready to display output.
+ * (Brightness control via OE bit manipulation is another case) - this must be done as well seperately!
+ */
+void MatrixPanel_I2S_DMA::clearFrameBuffer(int _buff_id, bool _address_only)
+{
+  if (!initialized)
+    return;
+
+  frameStruct *fb = &frame_buffer[_buff_id];
+
+  // we start with iterating all rows in dma_buff structure
+  int row_idx = fb->rowBits.size();
+
+  do
+  {
+    --row_idx;
+    clearFrameBufferRow(_buff_id, row_idx, _address_only);
+  } while (row_idx);
+
+#ifdef USE_DIRTY_TRACKING
+  // the buffers are all cleared together, so there is nothing to sync between them
+  if (!_address_only)
+  {
+    for (auto &_span : fb->dirty)
+      _span.clear();
+    for (auto &_span : fb->stale)
+      _span.clear();
+  }
+#endif
+
+#if defined(SPIRAM_DMA_BUFFER)
+  for (auto &_span : fb->unflushed)
+    _span.clear();
+#endif
+}
+
+/* The rows are cleared one at a time, as scrollVertical() readdresses them one at a time. The address bits are those of the DMA row
+ * the frame buffer row is sent as, which is row_idx itself unless scrolled.
+ */
+void MatrixPanel_I2S_DMA::clearFrameBufferRow(int _buff_id, int row_idx, bool _address_only)
+{
+  frameStruct *fb = &frame_buffer[_buff_id];
+
+  // with _address_only just the ABCDE bits are rewritten, the colour, LAT and OE bits of every pixel stay as they are
+  const ESP32_I2S_DMA_STORAGE_TYPE keep = _address_only ? (ESP32_I2S_DMA_STORAGE_TYPE)~(0x1F << BITS_ADDR_OFFSET) : 0;
+
+  // the first bitplane sent per row, see setColorDepth()
+  const uint8_t first_plane = fb->rowBits[0].colour_depth - active_colour_depth;
+
+  // abcde bitmask for TYPE_DIRECT line decoder
+  ESP32_I2S_DMA_STORAGE_TYPE abcde_mask;
+  if (fb->rowBits.size() == 2) abcde_mask = 0x3;  
+  else abcde_mask = 0xf;
+
+  const int dma_row = (row_idx + ROWS_PER_FRAME - vscroll_row) % ROWS_PER_FRAME;
+
+  ESP32_I2S_DMA_STORAGE_TYPE *row = fb->rowBits[row_idx].getDataPtr(first_plane); // set pointer to the first bitplane sent for the row
+  ESP32_I2S_DMA_STORAGE_TYPE abcde = (ESP32_I2S_DMA_STORAGE_TYPE)dma_row;
+   
+  if (m_cfg.line_decoder == HUB75_I2S_CFG::TYPE_DIRECT)
+		{ 
+    abcde = abcde_mask & (~(1 << abcde)); 
+  }
+
+  int x_pixel;
+
+	abcde <<= BITS_ADDR_OFFSET; // shift row y-coord to match ABCDE bits in vector from 8 to 12
+
+	// spare the first bitplane sent as it gets the previous row's address.
+	// Go bitplane by bitplane, as they needn't be contiguous (see HUB75_I2S_CFG::psram_placement)
+	for (uint8_t colouridx = 0; colouridx < fb->rowBits[row_idx].colour_depth; colouridx++)
+	{
+	  if (colouridx == first_plane)
+		continue;
+
+	  ESP32_I2S_DMA_STORAGE_TYPE *plane = fb->rowBits[row_idx].getDataPtr(colouridx);
+
+	  x_pixel = fb->rowBits[row_idx].width;
+	  do
+	  {
+		--x_pixel;
+		if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5266P)
+		{
+			// modifications here for row shift register type SM5266P
+			// https://github.com/mrfaptastic/ESP32-HUB75-MatrixPanel-I2S-DMA/issues/164
+			plane[x_pixel] = (plane[x_pixel] & keep) | (abcde & (0x18 << BITS_ADDR_OFFSET)); // mask out the bottom 3 bits which are the clk di bk inputs
+		}
+		else if (m_cfg.line_decoder  == HUB75_I2S_CFG::SM5368) 
+		{
+			plane[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] &= keep;
+		}
+		else
+		{
+			plane[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] = (plane[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] & keep) | abcde;
+		}
+
+	  } while (x_pixel);
+	}
+
+	x_pixel = fb->rowBits[row_idx].width;
+
+	// The first bitplane sent (colour_index[0], the LSB, unless setColorDepth() shows fewer) x_pixels must be "marked" with a previous's
+	// row address, because it is used to display previous row while we pump in MSBs's for the next row.
+	if (dma_row == 0) { 
+		abcde = ROWS_PER_FRAME-1; // wrap around
+	} else {
+		abcde = dma_row-1;	
+	}
+
+  if (m_cfg.line_decoder == HUB75_I2S_CFG::TYPE_DIRECT)
+  { 
+   abcde = abcde_mask & (~(1 << abcde)); 
+  }
+  
+  abcde <<= BITS_ADDR_OFFSET; // shift row y-coord to match ABCDE bits in vector from 8 to 12		
+	do
+  {
+    --x_pixel;
+
+    if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5266P)
+    {
+      // modifications here for row shift register type SM5266P
+      // https://github.com/mrfaptastic/ESP32-HUB75-MatrixPanel-I2S-DMA/issues/164
+      row[x_pixel] = (row[x_pixel] & keep) | (abcde & (0x18 << BITS_ADDR_OFFSET)); // mask out the bottom 3 bits which are the clk di bk inputs
+    }
+    else if (m_cfg.line_decoder  == HUB75_I2S_CFG::SM5368) 
+    {
+      row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] &= keep;
+    }
+    else
+    {
+      row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] = (row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] & keep) | abcde;
+    }
+
+  } while (x_pixel);
+
+  // modifications here for row shift register type SM5266P
+  // https://github.com/mrfaptastic/ESP32-HUB75-MatrixPanel-I2S-DMA/issues/164
+  if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5266P)
+  {
+    uint16_t serialCount;
+    uint16_t latch;
+    x_pixel = fb->rowBits[row_idx].width - 16; // come back 8*2 pixels to allow for 8 writes
+    serialCount = 8;
+    do
+    {
+      serialCount--;
+      latch = (row[hscrollColumn(x_pixel)] & (0x1F << BITS_ADDR_OFFSET)) | (((((ESP32_I2S_DMA_STORAGE_TYPE)dma_row) % 8) == serialCount) << 1) << BITS_ADDR_OFFSET; // data on 'B'
+      row[hscrollColumn(x_pixel)] = (row[hscrollColumn(x_pixel)] & keep) | latch | (0x05 << BITS_ADDR_OFFSET); x_pixel++;                                          // clock high on 'A'and BK high for update
+      row[hscrollColumn(x_pixel)] = (row[hscrollColumn(x_pixel)] & keep) | latch | (0x04 << BITS_ADDR_OFFSET); x_pixel++;                                          // clock low on 'A'and BK high for update
+    } while (serialCount);
+  } // end SM5266P
+
+  // row selection for SM5368 shift regs with ABC-only addressing. A is row clk, B is BK and C is row data
+  if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5368) 
+  {
+    x_pixel = fb->rowBits[row_idx].width - 1;                                                                        // last pixel in first block)
+    uint16_t c = (dma_row == 0) ? BIT_C : 0x0000;                                                                     // set row data (C) when row==0, then push through shift regs for all other rows
+    row[DMA_COLUMN(x_pixel - 1)] |= c | BIT_B;                                                            // set row data
+    row[DMA_COLUMN(x_pixel + 0)] |= c | BIT_A | BIT_B;                                             // set row clk and bk, carry row data
+  } // end DP3246_SM5368
+
+  // let's set LAT/OE control bits for specific pixels in each colour_index subrows
+  // Need to consider the original ESP32's (WROOM) DMA TX FIFO reordering of bytes...
+  uint8_t colouridx = fb->rowBits[row_idx].colour_depth;
+  do
+  {
+    --colouridx;
+
+    // switch pointer to a row for a specific colour index
+    row = fb->rowBits[row_idx].getDataPtr(colouridx);
+
+    // DP3246 needs the latch high for 3 clock cycles, so start 2 cycles earlier
+    if (m_cfg.driver == HUB75_I2S_CFG::DP3246) 
+    {
+      row[DMA_COLUMN(fb->rowBits[row_idx].width - 3)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
+      row[DMA_COLUMN(fb->rowBits[row_idx].width - 2)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
+    } // DP3246_SM5368
+    
+    row[DMA_COLUMN(fb->rowBits[row_idx].width - 1)] |= BIT_LAT; // -1 pixel to compensate array index starting at 0
+
+    // ESP32_TX_FIFO_POSITION_ADJUST(dma_buff.rowBits[row_idx].width - 1)
+
+    // need to disable OE before/after latch to hide row transition
+    // Should be one clock or more before latch, otherwise can get ghosting
+    uint8_t _blank = m_cfg.latch_blanking;
+    do
+    {
+      --_blank;
+
+      row[DMA_COLUMN(0 + _blank)] |= BIT_OE;                               // disable output
+      row[DMA_COLUMN(fb->rowBits[row_idx].width - 1)] |= BIT_OE;          // disable output
+      row[DMA_COLUMN(fb->rowBits[row_idx].width - _blank - 1)] |= BIT_OE; // (LAT pulse is (width-2) -1 pixel to compensate array index starting at 0
+
+    } while (_blank);
+
+  } while (colouridx);
+
+#if defined(SPIRAM_DMA_BUFFER)
+  writeBackRow(fb->rowBits[row_idx]);
+#endif
+}
+
+void MatrixPanel_I2S_DMA::crossfadeDMABuffer(uint16_t frames, bool wait)
+{
+  if (!m_cfg.double_buff)
+  {
+    return;
+  }
+
+  // the third buffer would have to be kept out of the way of the interrupt for the whole transition
+  if (m_cfg.triple_buff || frames == 0)
+  {
+    flipDMABuffer(wait);
+    return;
+  }
+
+  commit(); // the DMA must see everything drawn into the back buffer
+
+#ifdef USE_DIRTY_TRACKING
+  finishBackBufferSync(); // the crossfade before this one
+#endif
+
+  // from the buffer on the panel to the back buffer. The interrupt links the buffer for the frame after the
+  // one it has just started, so the old front buffer can be sent up to two frames after the last step.
+  dma_bus.blend_dma_output_buffers(back_buffer_id ^ 1, back_buffer_id, frames);
+  back_buffer_free_frame = dma_bus.get_frames_sent() + frames + 2;
+
+#ifdef USE_DIRTY_TRACKING
+  back_buffer_sync_from = back_buffer_id; // not while the old front buffer is on the panel, see waitBackBufferFree()
+#endif
+
+  back_buffer_id = back_buffer_id ^ 1;
+  fb = &frame_buffer[back_buffer_id];
+
+  if (wait)
+  {
+    waitBackBufferFree();
+  }
+}
+
+/**
+ * @brief - write the row spans drawn to since the last commit() back from the CPU cache to the PSRAM DMA buffer
+ * One write back per bitplane of a changed row span, or one per row when the whole row was drawn to.
+ */
+void MatrixPanel_I2S_DMA::commit()
+{
+#if defined(SPIRAM_DMA_BUFFER)
+  if (!initialized)
+    return;
+
+  for (int row = 0; row < fb->rows; row++)
+  {
+    rowSpan &_span = fb->unflushed[row];
+    if (_span.empty())
+      continue;
+
+    rowBitStruct &_row = fb->rowBits[row];
+
+    if (_span.x0 == 0 && _span.x1 >= _row.width)
+    { // the bitplanes of a row are contiguous (per SRAM / PSRAM run)
+      writeBackRow(_row);
+    }
+    else
+    {
+      // FIFO position adjustment only ever swaps within an even/odd pair, so flush whole pairs
+      uint16_t x0 = _span.x0 & ~1U, x1 = (_span.x1 + 1) & ~1U;
+
+      for (uint8_t colour_depth_idx = 0; colour_depth_idx < _row.colour_depth; colour_depth_idx++)
+        if (_row.inPsram(colour_depth_idx))
+          Cache_WriteBack_Addr((uint32_t)(uintptr_t)&_row.getDataPtr(colour_depth_idx)[x0], (x1 - x0) * sizeof(ESP32_I2S_DMA_STORAGE_TYPE));
+    }
+
+    _span.clear();
+  }
+#endif
+} // commit()
+
+#ifdef USE_DIRTY_TRACKING
+/**
+ * @brief - bring the new back buffer up to date after a flip, by copying over only what was drawn since it was last drawn to
+ * Whatever was drawn into the buffer just flipped to the front is now missing from every other buffer ('stale').
+ * The back buffer's stale spans are then copied from the front buffer, colour bits only, the control / OE bits
+ * of the back buffer are kept as they are.
+ * @param int front_id - the buffer that was just flipped (or queued) to be displayed
+ */
+void MatrixPanel_I2S_DMA::syncBackBuffer(int front_id)
+{
+  frameStruct *front = &frame_buffer[front_id];
+  if (front == fb)
+    return;
+
+  const int fbs_used = m_cfg.triple_buff ? 3 : 2;
+
+  for (int row = 0; row < fb->rows; row++)
+  {
+    for (int _buff_id = 0; _buff_id < fbs_used; _buff_id++)
+    {
+      if (_buff_id != front_id)
+        frame_buffer[_buff_id].stale[row].merge(front->dirty[row]);
+    }
+
+    // drawing into the back buffer starts afresh
+    fb->dirty[row].clear();
+
+    rowSpan &_span = fb->stale[row];
+    if (_span.empty())
+      continue;
+
+    // FIFO position adjustment only ever swaps within an even/odd pair, so copy whole pairs
+    uint16_t x0 = _span.x0, x1 = _span.x1;
+#if defined(ESP32_THE_ORIG)
+    x0 &= ~1U;
+    x1 = (x1 + 1) & ~1U;
+#endif
+    if (x1 > PIXELS_PER_ROW)
+      x1 = PIXELS_PER_ROW;
+
+    for (uint8_t colour_depth_idx = 0; colour_depth_idx < fb->rowBits[row].colour_depth; colour_depth_idx++)
+    {
+      const ESP32_I2S_DMA_STORAGE_TYPE *src = front->rowBits[row].getDataPtr(colour_depth_idx);
+      ESP32_I2S_DMA_STORAGE_TYPE *p = fb->rowBits[row].getDataPtr(colour_depth_idx);
+
+      for (uint16_t x = x0; x < x1; x++)
+        p[x] = (p[x] & BITMASK_RGB12_CLEAR) | (src[x] & ~BITMASK_RGB12_CLEAR);
+    }
+
+#if defined(SPIRAM_DMA_BUFFER)
+    fb->unflushed[row].merge(x0, x1); // written back by the next flipDMABuffer()
+#endif
+
+    _span.clear();
+  }
+} // syncBackBuffer()
+#endif
+
+#ifdef USE_SHADOW_BUFFER
+bool MatrixPanel_I2S_DMA::allocateShadowBuffer()
+{
+  if (shadow_buff)
+    heap_caps_free(shadow_buff);
+
+  size_t _bytes = (size_t)PIXELS_PER_ROW * m_cfg.mx_height * SHADOW_BYTES_PER_PIXEL;
+
+  // doesn't need to be DMA capable, so keep internal SRAM for the DMA buffers if there is PSRAM
+  shadow_buff = (uint8_t *)heap_caps_calloc(1, _bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (shadow_buff == nullptr)
+    shadow_buff = (uint8_t *)heap_caps_calloc(1, _bytes, MALLOC_CAP_8BIT);
+
+  if (shadow_buff == nullptr)
+  {
+    ESP_LOGE("I2S-DMA", "Could not allocate %u bytes for the shadow buffer.", (unsigned int)_bytes);
+    return false;
+  }
+
+  ESP_LOGI("I2S-DMA", "Allocated %u bytes for the shadow buffer.", (unsigned int)_bytes);
+
+  shadow_dirty.assign(ROWS_PER_FRAME, rowSpan());
+  return true;
+}
+
+bool MatrixPanel_I2S_DMA::shadowFill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t r, uint8_t g, uint8_t b)
+{
+  for (uint16_t _y = y; _y < y + h; _y++)
+  {
+    uint8_t *p = shadowPtr(x, _y);
+    for (uint16_t i = 0; i < w; i++, p += SHADOW_BYTES_PER_PIXEL)
+      shadowSet(p, r, g, b);
+
+    if (shadow_deferred)
+      shadow_dirty[_y >= ROWS_PER_FRAME ? _y - ROWS_PER_FRAME : _y].merge(x, x + w);
+  }
+
+  return shadow_deferred;
+}
+
+bool MatrixPanel_I2S_DMA::shadowStoreRow(uint16_t x, uint16_t y, uint16_t len, const uint8_t *rgb888, const uint16_t *rgb565)
+{
+  uint8_t *p = shadowPtr(x, y);
+
+#if SHADOW_BYTES_PER_PIXEL == 3
+  if (rgb888)
+  {
+    if (rgb888 != p) // encodeShadowBuffer() passes the shadow buffer itself
+      memmove(p, rgb888, (size_t)len * 3);
+  }
+  else
+#endif
+  {
+    for (uint16_t i = 0; i < len; i++, p += SHADOW_BYTES_PER_PIXEL)
+    {
+      uint8_t r, g, b;
+      if (rgb888)
+      {
+        r = *rgb888++;
+        g = *rgb888++;
+        b = *rgb888++;
+      }
+      else
+      {
+        color565to888(*rgb565++, r, g, b);
+      }
+      shadowSet(p, r, g, b);
+    }
+  }
+
+  if (shadow_deferred)
+    shadow_dirty[y >= ROWS_PER_FRAME ? y - ROWS_PER_FRAME : y].merge(x, x + len);
+
+  return shadow_deferred;
+}
+
+bool MatrixPanel_I2S_DMA::shadowCopyRect(uint16_t src_x, uint16_t src_y, uint16_t w, uint16_t h, uint16_t dst_x, uint16_t dst_y)
+{
+  // rows in the order copyRect() takes them, memmove() sees to overlaps within a row
+  const bool rows_back = dst_y > src_y;
+
+  for (uint16_t j = 0; j < h; j++)
+  {
+    uint16_t _j = rows_back ? h - 1 - j : j;
+    memmove(shadowPtr(dst_x, dst_y + _j), shadowPtr(src_x, src_y + _j), (size_t)w * SHADOW_BYTES_PER_PIXEL);
+
+    if (shadow_deferred)
+      shadow_dirty[(dst_y + _j) % ROWS_PER_FRAME].merge(dst_x, dst_x + w);
+  }
+
+  return shadow_deferred;
+}
+
+bool MatrixPanel_I2S_DMA::shadowStoreSprite(const BitplaneSprite &sprite, uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t x, uint16_t y)
+{
+  for (uint16_t j = 0; j < h; j++)
+  {
+    uint8_t *p = shadowPtr(x, y + j);
+    for (uint16_t i = 0; i < w; i++, p += SHADOW_BYTES_PER_PIXEL)
+    {
+      uint8_t r, g, b;
+      if (getSpritePixelRGB(sprite, sx + i, sy + j, r, g, b))
+        shadowSet(p, r, g, b);
+    }
+
+    if (shadow_deferred)
+      shadow_dirty[(y + j) % ROWS_PER_FRAME].merge(x, x + w);
+  }
+
+  return shadow_deferred;
+}
+
+void MatrixPanel_I2S_DMA::shadowScale(uint16_t numerator, uint8_t shift)
+{
+  if (shadow_buff == nullptr)
+    return;
+
+  // what each 8 bit colour becomes
+  uint8_t lut[256];
+  for (uint16_t c = 0; c < 256; c++)
+  {
+    uint8_t red = c, green = 0, blue = 0;
+
+    DO_BRIGHTNESS_COMPENSATION()
+    (void)green_val;
+    (void)blue_val;
+
+    lut[c] = uncompensate((uint16_t)(((uint32_t)red_val * numerator) >> shift));
+  }
+
+  for (uint8_t *p = shadow_buff; p < shadowPtr(0, m_cfg.mx_height); p += SHADOW_BYTES_PER_PIXEL)
+  {
+    uint8_t r, g, b;
+    shadowGet(p, r, g, b);
+    shadowSet(p, lut[r], lut[g], lut[b]);
+  }
+}
 
-	} while (x_pixel != fb->rowBits[row_idx]->width); // spare the first "width's" worth of pixels as they are the LSB pixels/colordepth
+void MatrixPanel_I2S_DMA::encodeShadowBuffer(bool dirty_only)
+{
+  if (!initialized || shadow_buff == nullptr)
+    return;
 
-	// The colour_index[0] (LSB) x_pixels must be "marked" with a previous's row address, because it is used to display
-	// previous row while we pump in MSBs's for the next row.
-	if (row_idx == 0) { 
-		abcde = ROWS_PER_FRAME-1; // wrap around
-	} else {
-		abcde = row_idx-1;	
-	}
+  bool _deferred = shadow_deferred;
+  shadow_deferred = false;
 
-  if (m_cfg.line_decoder == HUB75_I2S_CFG::TYPE_DIRECT)
-  { 
-     abcde = abcde_mask & (~(1 << abcde)); 
-  }
-  
-    abcde <<= BITS_ADDR_OFFSET; // shift row y-coord to match ABCDE bits in vector from 8 to 12		
-	do
+  for (uint16_t row = 0; row < ROWS_PER_FRAME; row++)
+  {
+    uint16_t x0 = 0, x1 = PIXELS_PER_ROW;
+
+    if (dirty_only)
     {
-      --x_pixel;
+      if (shadow_dirty[row].empty())
+        continue;
 
-      if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5266P)
-      {
-        // modifications here for row shift register type SM5266P
-        // https://github.com/mrfaptastic/ESP32-HUB75-MatrixPanel-I2S-DMA/issues/164
-        row[x_pixel] = abcde & (0x18 << BITS_ADDR_OFFSET); // mask out the bottom 3 bits which are the clk di bk inputs
-      }
-      else if (m_cfg.line_decoder  == HUB75_I2S_CFG::SM5368) 
-      {
-        row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] = 0x0000;
-      }
-      else
-      {
-        row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] = abcde;
-      }
+      x0 = shadow_dirty[row].x0;
+      x1 = shadow_dirty[row].x1;
+    }
 
-    } while (x_pixel);
+    shadow_dirty[row].clear();
 
-    // modifications here for row shift register type SM5266P
-    // https://github.com/mrfaptastic/ESP32-HUB75-MatrixPanel-I2S-DMA/issues/164
-    if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5266P)
+#if SHADOW_BYTES_PER_PIXEL == 3
+    // the shadow rows are packed RGB888 already
+    updateMatrixDMABufferRowPair(x0, row, x1 - x0, shadowPtr(x0, row), shadowPtr(x0, row + ROWS_PER_FRAME));
+#else
+    uint8_t upper[ROW_ENCODE_CHUNK_PIXELS * 3], lower[ROW_ENCODE_CHUNK_PIXELS * 3];
+
+    for (uint16_t x = x0; x < x1; x += ROW_ENCODE_CHUNK_PIXELS)
     {
-      uint16_t serialCount;
-      uint16_t latch;
-      x_pixel = fb->rowBits[row_idx]->width - 16; // come back 8*2 pixels to allow for 8 writes
-      serialCount = 8;
-      do
+      uint16_t _chunk = (x1 - x > ROW_ENCODE_CHUNK_PIXELS) ? ROW_ENCODE_CHUNK_PIXELS : x1 - x;
+
+      for (uint16_t i = 0; i < _chunk; i++)
       {
-        serialCount--;
-        latch = row[x_pixel] | (((((ESP32_I2S_DMA_STORAGE_TYPE)row_idx) % 8) == serialCount) << 1) << BITS_ADDR_OFFSET; // data on 'B'
-        row[x_pixel++] = latch | (0x05 << BITS_ADDR_OFFSET);                                                            // clock high on 'A'and BK high for update
-        row[x_pixel++] = latch | (0x04 << BITS_ADDR_OFFSET);                                                            // clock low on 'A'and BK high for update
-      } while (serialCount);
-    } // end SM5266P
-
-    // row selection for SM5368 shift regs with ABC-only addressing. A is row clk, B is BK and C is row data
-    if (m_cfg.line_decoder == HUB75_I2S_CFG::SM5368) 
-    {
-      x_pixel = fb->rowBits[row_idx]->width - 1;                                                                        // last pixel in first block)
-      uint16_t c = (row_idx == 0) ? BIT_C : 0x0000;                                                                     // set row data (C) when row==0, then push through shift regs for all other rows
-      row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel - 1)] |= c | BIT_B;                                                            // set row data
-      row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel + 0)] |= c | BIT_A | BIT_B;                                             // set row clk and bk, carry row data
-    } // end DP3246_SM5368
-
-    // let's set LAT/OE control bits for specific pixels in each colour_index subrows
-    // Need to consider the original ESP32's (WROOM) DMA TX FIFO reordering of bytes...
-    uint8_t colouridx = fb->rowBits[row_idx]->colour_depth;
-    do
-    {
-      --colouridx;
+        shadowGet(shadowPtr(x + i, row), upper[i * 3], upper[i * 3 + 1], upper[i * 3 + 2]);
+        shadowGet(shadowPtr(x + i, row + ROWS_PER_FRAME), lower[i * 3], lower[i * 3 + 1], lower[i * 3 + 2]);
+      }
 
-      // switch pointer to a row for a specific colour index
-      row = fb->rowBits[row_idx]->getDataPtr(colouridx);
+      updateMatrixDMABufferRowPair(x, row, _chunk, upper, lower);
+    }
+#endif
+  }
 
-      // DP3246 needs the latch high for 3 clock cycles, so start 2 cycles earlier
-      if (m_cfg.driver == HUB75_I2S_CFG::DP3246) 
-      {
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 3)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 2)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
-      } // DP3246_SM5368
-      
-      row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 1)] |= BIT_LAT; // -1 pixel to compensate array index starting at 0
+  shadow_deferred = _deferred;
+} // encodeShadowBuffer()
 
-      // ESP32_TX_FIFO_POSITION_ADJUST(dma_buff.rowBits[row_idx]->width - 1)
+bool MatrixPanel_I2S_DMA::readPixel(int16_t x, int16_t y, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+  int16_t w = 1, h = 1;
+  transform(x, y, w, h);
 
-      // need to disable OE before/after latch to hide row transition
-      // Should be one clock or more before latch, otherwise can get ghosting
-      uint8_t _blank = m_cfg.latch_blanking;
-      do
-      {
-        --_blank;
+  if (shadow_buff == nullptr || x < 0 || y < 0 || x >= PIXELS_PER_ROW || y >= m_cfg.mx_height)
+    return false;
 
-        row[ESP32_TX_FIFO_POSITION_ADJUST(0 + _blank)] |= BIT_OE;                               // disable output
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 1)] |= BIT_OE;          // disable output
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - _blank - 1)] |= BIT_OE; // (LAT pulse is (width-2) -1 pixel to compensate array index starting at 0
+  shadowGet(shadowPtr(x, y), r, g, b);
+  return true;
+}
 
-      } while (_blank);
+void MatrixPanel_I2S_DMA::blendPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
+{
+  uint8_t _r, _g, _b;
+  if (!readPixel(x, y, _r, _g, _b))
+    return;
 
-    } while (colouridx);
+  // (new * alpha + old * (255 - alpha)) / 255, rounded
+  uint16_t _a = alpha, _na = 255 - alpha;
+  _r = (r * _a + _r * _na + 127) / 255;
+  _g = (g * _a + _g * _na + 127) / 255;
+  _b = (b * _a + _b * _na + 127) / 255;
 
-#if defined(SPIRAM_DMA_BUFFER)
-    Cache_WriteBack_Addr((uint32_t)row, fb->rowBits[row_idx]->getColorDepthSize(false));
+  drawPixelRGB888(x, y, _r, _g, _b);
+}
 #endif
 
-  } while (row_idx);
+/* The output is enabled for a range in the centre of the row, shorter for the lower bitplanes as they are shown for less time */
+void MatrixPanel_I2S_DMA::brightnessOERange(uint8_t brt, uint8_t colouridx, int &x_min, int &x_max) const
+{
+  uint8_t _blank = m_cfg.latch_blanking; // don't want to inadvertantly blast over this
+  uint8_t _depth = active_colour_depth;   // bitplanes sent, the most significant ones. See setColorDepth()
+  uint16_t _width = PIXELS_PER_ROW;
+
+  char bitplane = (2 * _depth - colouridx) % _depth;
+  char bitshift = (_depth - lsbMsbTransitionBit - 1) >> 1;
+
+  char rightshift = std::max(bitplane - bitshift - 2, 0);
+
+  // Calculate the OE disable period by brightness and latch blanking.
+  // First, determine the maximum pixels for this specific bitplane (accounting for PWM time weighting).
+  // Then scale that maximum by brightness (0-255).
+  // This ensures all bitplanes scale proportionally and reach their maximums simultaneously.
+  int max_pixels_for_bitplane = (_width - _blank) >> rightshift;
+  int brightness_in_x_pixels = (max_pixels_for_bitplane * brt) >> 8;
+
+  // Ensure at least 1 pixel is enabled for any brightness > 0
+  if (brt > 0 && brightness_in_x_pixels == 0) {
+    brightness_in_x_pixels = 1;
+  }
+
+  // Safety margin: Ensure we never exceed max_pixels - 1 to maintain blanking headroom.
+  // At extreme brightness (252-255), we need at least (_blank + 1) total blanking pixels
+  // to prevent ghosting and artifacts, especially with high pixel density (many white pixels).
+  if (brightness_in_x_pixels > max_pixels_for_bitplane - 1) {
+    brightness_in_x_pixels = max_pixels_for_bitplane - 1;
+  }
+
+  // define range of Output Enable on the center of the row
+  x_max = (_width + brightness_in_x_pixels + 1) >> 1;
+  x_min = (_width - brightness_in_x_pixels + 0) >> 1;
 }
 
 void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
@@ -692,9 +2540,9 @@ void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
 
   frameStruct *fb = &frame_buffer[_buff_id];
 
-  uint8_t _blank = m_cfg.latch_blanking; // don't want to inadvertantly blast over this
-  uint8_t _depth = fb->rowBits[0]->colour_depth;
-  uint16_t _width = fb->rowBits[0]->width;
+  uint8_t _depth = active_colour_depth;   // bitplanes sent, the most significant ones. See setColorDepth()
+  uint8_t _first = fb->rowBits[0].colour_depth - _depth;
+  uint16_t _width = fb->rowBits[0].width;
 
   // start with iterating all rows in dma_buff structure
   int row_idx = fb->rowBits.size();
@@ -702,42 +2550,18 @@ void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
   {
     --row_idx;
 
-    // let's set OE control bits for specific pixels in each color_index subrows
+    // let's set OE control bits for specific pixels in each color_index subrows (counted from the first one sent)
     uint8_t colouridx = _depth;
     do
     {
       --colouridx;
 
-      char bitplane = (2 * _depth - colouridx) % _depth;
-      char bitshift = (_depth - lsbMsbTransitionBit - 1) >> 1;
-
-      char rightshift = std::max(bitplane - bitshift - 2, 0);
-
-      // Calculate the OE disable period by brightness and latch blanking.
-      // First, determine the maximum pixels for this specific bitplane (accounting for PWM time weighting).
-      // Then scale that maximum by brightness (0-255).
-      // This ensures all bitplanes scale proportionally and reach their maximums simultaneously.
-      int max_pixels_for_bitplane = (_width - _blank) >> rightshift;
-      int brightness_in_x_pixels = (max_pixels_for_bitplane * brt) >> 8;
-
-      // Ensure at least 1 pixel is enabled for any brightness > 0
-      if (brt > 0 && brightness_in_x_pixels == 0) {
-        brightness_in_x_pixels = 1;
-      }
-
-      // Safety margin: Ensure we never exceed max_pixels - 1 to maintain blanking headroom.
-      // At extreme brightness (252-255), we need at least (_blank + 1) total blanking pixels
-      // to prevent ghosting and artifacts, especially with high pixel density (many white pixels).
-      if (brightness_in_x_pixels > max_pixels_for_bitplane - 1) {
-        brightness_in_x_pixels = max_pixels_for_bitplane - 1;
-      }
+      int x_coord_min, x_coord_max;
+      brightnessOERange(brt, colouridx, x_coord_min, x_coord_max);
 
       // switch pointer to a row for a specific color index
-      ESP32_I2S_DMA_STORAGE_TYPE *row = fb->rowBits[row_idx]->getDataPtr(colouridx);
+      ESP32_I2S_DMA_STORAGE_TYPE *row = fb->rowBits[row_idx].getDataPtr(_first + colouridx);
 
-      // define range of Output Enable on the center of the row
-      int x_coord_max = (_width + brightness_in_x_pixels + 1) >> 1;
-      int x_coord_min = (_width - brightness_in_x_pixels + 0) >> 1;
       int x_coord = _width;
       do
       {
@@ -746,11 +2570,11 @@ void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
         // (the check is already including "blanking" )
         if (x_coord >= x_coord_min && x_coord < x_coord_max)
         {
-          row[ESP32_TX_FIFO_POSITION_ADJUST(x_coord)] &= BITMASK_OE_CLEAR;
+          row[DMA_COLUMN(x_coord)] &= BITMASK_OE_CLEAR;
         }
         else
         {
-          row[ESP32_TX_FIFO_POSITION_ADJUST(x_coord)] |= BIT_OE; // Disable output after this point.
+          row[DMA_COLUMN(x_coord)] |= BIT_OE; // Disable output after this point.
         }
 
       } while (x_coord);
@@ -760,8 +2584,7 @@ void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
 #if defined(SPIRAM_DMA_BUFFER)
 	// Force the flush and update of the PSRAM for the memory address range of the 'row data' as
 	// data changes probably aren't being sent out via DMA as they're sitting in a hadrware 'cache' 
-    ESP32_I2S_DMA_STORAGE_TYPE *row_ptr = fb->rowBits[row_idx]->getDataPtr(0);
-    Cache_WriteBack_Addr((uint32_t)row_ptr, fb->rowBits[row_idx]->getColorDepthSize(false));
+    writeBackRow(fb->rowBits[row_idx]);
 #endif
   } while (row_idx);
 }
@@ -831,6 +2654,379 @@ uint8_t MatrixPanel_I2S_DMA::setLatBlanking(uint8_t pulses)
   return m_cfg.latch_blanking;
 }
 
+bool MatrixPanel_I2S_DMA::setColorDepth(uint8_t depth)
+{
+  if (depth < 2 || depth > m_cfg.getPixelColorDepthBits())
+  {
+    ESP_LOGE("setColorDepth()", "Colour depth of %d not possible, must be between 2 and the pixel_color_depth_bits of %d.", depth, m_cfg.getPixelColorDepthBits());
+    return false;
+  }
+
+  if (!initialized)
+  {
+    active_colour_depth = depth; // used by begin()
+    return true;
+  }
+
+  if (depth == active_colour_depth)
+    return true;
+
+  return relinkDMA(depth, m_cfg.min_refresh_rate);
+}
+
+bool MatrixPanel_I2S_DMA::setMinRefreshRate(uint8_t hz)
+{
+  if (!initialized)
+  {
+    m_cfg.min_refresh_rate = hz;
+    return true;
+  }
+
+  return relinkDMA(active_colour_depth, hz);
+}
+
+#ifdef USE_STATS
+MatrixPanel_I2S_DMA::stats_t MatrixPanel_I2S_DMA::getStats() const
+{
+  frame_stats_t _bus;
+  dma_bus.get_stats(_bus);
+
+  stats_t _stats = {};
+  _stats.elapsed_us = (uint32_t)(_bus.now_us - _bus.reset_us);
+  _stats.frames_output = _bus.frames;
+  _stats.max_frame_us = _bus.max_frame_us;
+
+  // frames - 1 frame periods between the first and the last end of frame
+  if (_bus.frames > 1 && _bus.last_frame_us > _bus.first_frame_us)
+    _stats.measured_refresh_rate = (_bus.frames - 1) * 1000000.0f / (float)(_bus.last_frame_us - _bus.first_frame_us);
+
+  _stats.flips_requested = stats_flips_requested;
+  _stats.flips_applied = _bus.flips_applied;
+  _stats.flip_latency_avg_us = _bus.flips_applied ? (uint32_t)(_bus.flip_latency_total_us / _bus.flips_applied) : 0;
+  _stats.flip_latency_max_us = _bus.flip_latency_max_us;
+
+  _stats.pixels_written = stats_pixels;
+  _stats.pixels_per_second = _stats.elapsed_us ? (uint32_t)(stats_pixels * 1000000 / _stats.elapsed_us) : 0;
+  _stats.encode_us = (uint32_t)(stats_encode_ticks / STATS_TICKS_PER_US());
+
+  return _stats;
+}
+
+void MatrixPanel_I2S_DMA::resetStats()
+{
+  stats_flips_requested = 0;
+  stats_pixels = 0;
+  stats_encode_ticks = 0;
+
+  dma_bus.reset_stats();
+}
+#endif
+
+/* Blank a bitplane of every row, i.e. disable the output for all of it */
+void MatrixPanel_I2S_DMA::blankBitplane(int _buff_id, uint8_t _plane)
+{
+  frameStruct *fb = &frame_buffer[_buff_id];
+
+  for (auto &_row : fb->rowBits)
+  {
+    ESP32_I2S_DMA_STORAGE_TYPE *p = _row.getDataPtr(_plane);
+
+    for (size_t x = 0; x < _row.width; x++)
+      p[x] |= BIT_OE;
+
+#if defined(SPIRAM_DMA_BUFFER)
+    writeBackRow(_row);
+#endif
+  }
+}
+
+bool MatrixPanel_I2S_DMA::relinkDMA(uint8_t depth, uint8_t min_refresh_rate)
+{
+  const int fbs = (m_cfg.triple_buff) ? 3 : (m_cfg.double_buff) ? 2 : 1;
+
+  const uint8_t old_depth = active_colour_depth;
+  const int old_transition_bit = lsbMsbTransitionBit;
+  const uint8_t old_first = m_cfg.getPixelColorDepthBits() - old_depth;
+  const uint8_t new_first = m_cfg.getPixelColorDepthBits() - depth;
+
+  HUB75_I2S_CFG _active_cfg = m_cfg;
+  _active_cfg.setPixelColorDepthBits(depth);
+  _active_cfg.min_refresh_rate = min_refresh_rate;
+
+  int refresh_rate;
+
+#if !defined(FORCE_COLOR_DEPTH)
+  int transition_bit = calculateLsbMsbTransitionBit(_active_cfg, refresh_rate);
+#else
+  int transition_bit = 0;
+  refresh_rate = HUB75Planner::refreshRate(PIXELS_PER_ROW, ROWS_PER_FRAME, depth, m_cfg.i2sspeed, 0);
+#endif
+
+  // Nothing may link buffers in while the descriptors are replaced, the links made would be lost. So take a
+  // crossfade straight to its end, and let the end of frame interrupt link in a triple buffer flip still queued.
+  if (isCrossfading())
+  {
+    dma_bus.stop_dma_output_blend();
+    dma_bus.flip_dma_output_buffer(back_buffer_id ^ 1);
+  }
+
+  int8_t _current, _next, _queued;
+  dma_bus.get_dma_output_buffers(_current, _next, _queued);
+  if (_queued >= 0)
+    dma_bus.wait_frames_sent(dma_bus.get_frames_sent() + 1, (calculated_refresh_rate > 0 ? 1000 / calculated_refresh_rate : 0) + 10);
+
+  active_colour_depth = depth;
+  lsbMsbTransitionBit = transition_bit;
+
+  if (!dma_bus.start_dma_desc_relink(activeDMADescriptorsPerRow() * ROWS_PER_FRAME))
+  {
+    active_colour_depth = old_depth;
+    lsbMsbTransitionBit = old_transition_bit;
+    return false;
+  }
+
+  linkDMADescriptors(fbs);
+
+  // The first bitplane sent for a row shows the previous row, so has that row's address. Until the addresses are
+  // rewritten below, either the old or the new descriptors send one at the wrong address, so keep both dark till then.
+  for (int _fb = 0; _fb < fbs; _fb++)
+  {
+    blankBitplane(_fb, old_first);
+    blankBitplane(_fb, new_first);
+  }
+
+  // hand the output over at the end of a frame, allowing for a couple of frames at the slower refresh rate
+  int slowest = std::min(calculated_refresh_rate, refresh_rate);
+  if (!dma_bus.finish_dma_desc_relink((slowest > 0 ? 2000 / slowest : 0) + 10))
+    ESP_LOGE("I2S-DMA", "No frame sent on the relinked DMA descriptors in time, the old ones are left allocated.");
+
+  m_cfg.min_refresh_rate = min_refresh_rate;
+  calculated_refresh_rate = refresh_rate;
+
+  // the colours drawn stay, only the row addresses and OE timing depend on the bitplanes sent
+  for (int _fb = 0; _fb < fbs; _fb++)
+  {
+    clearFrameBuffer(_fb, true);
+    setBrightnessOE(brightness, _fb);
+  }
+
+  ESP_LOGI("I2S-DMA", "Showing %d of %d bitplanes, lsbMsbTransitionBit %d, refresh rate %d Hz.", depth, m_cfg.getPixelColorDepthBits(), lsbMsbTransitionBit, calculated_refresh_rate);
+
+  return true;
+}
+
+/**
+ * @brief - scroll by moving the column the DMA starts each row at, see HUB75_I2S_CFG::hscroll
+ * The colour bits stay where they are, the rows are rings and hscrollColumn() finds a pixel in them. The control bits have to stay
+ * put relative to the start of the row though, which hscrollControlBits() sees to for just the columns they differ in.
+ */
+bool MatrixPanel_I2S_DMA::scrollHorizontal(int16_t dx)
+{
+  if (!initialized || !m_cfg.hscroll)
+  {
+    ESP_LOGE("scrollHorizontal()", "Needs HUB75_I2S_CFG::hscroll set, and begin() called.");
+    return false;
+  }
+
+  if (dx % HSCROLL_STEP)
+  {
+    ESP_LOGE("scrollHorizontal()", "Can only scroll by a multiple of %d columns, not %d.", HSCROLL_STEP, dx);
+    return false;
+  }
+
+  const int width = PIXELS_PER_ROW;
+
+  // the shorter way round
+  dx %= width;
+  if (dx > width / 2)
+    dx -= width;
+  else if (dx < -width / 2)
+    dx += width;
+
+  if (dx == 0)
+    return true;
+
+#ifdef USE_SHADOW_BUFFER
+  if (shadow_buff)
+  {
+    const size_t row_bytes = (size_t)width * SHADOW_BYTES_PER_PIXEL;
+
+    for (uint16_t y = 0; y < m_cfg.mx_height; y++)
+      std::rotate(shadowPtr(0, y), shadowPtr((dx + width) % width, y), shadowPtr(0, y) + row_bytes);
+
+    // anything not encoded yet has moved as well
+    for (auto &_span : shadow_dirty)
+      if (!_span.empty())
+        _span.merge(0, width);
+  }
+#endif
+
+  const int fbs_used = m_cfg.triple_buff ? 3 : m_cfg.double_buff ? 2 : 1;
+  const uint8_t first_plane = m_cfg.getPixelColorDepthBits() - active_colour_depth;
+  const uint16_t old_offset = hscroll_offset;
+
+  // the output enabled range of every bitplane sent, the same in every row
+  int oe_min[PIXEL_COLOR_DEPTH_BITS_MAX], oe_max[PIXEL_COLOR_DEPTH_BITS_MAX];
+  for (uint8_t colouridx = 0; colouridx < active_colour_depth; colouridx++)
+    brightnessOERange(brightness, colouridx, oe_min[colouridx], oe_max[colouridx]);
+
+  // Start right after an end of frame. The DMA spends a whole row time on each row, rewriting a row takes the CPU a small fraction
+  // of that, so from there on every row is done before the DMA gets to it. If the output is stopped, there's no waiting for it.
+  uint32_t timeout_ms = (calculated_refresh_rate > 0 ? 1000 / calculated_refresh_rate : 0) + 10;
+  dma_bus.wait_frames_sent(dma_bus.get_frames_sent() + 1, timeout_ms);
+
+  hscroll_offset = (old_offset + dx + width) % width;
+
+  for (int row = 0; row < ROWS_PER_FRAME; row++)
+  {
+    for (int _buff_id = 0; _buff_id < fbs_used; _buff_id++)
+    {
+      rowBitStruct &_row = frame_buffer[_buff_id].rowBits[vscrollRow(row)];
+
+      for (uint8_t colouridx = 0; colouridx < _row.colour_depth; colouridx++)
+      {
+        // the bitplanes not sent get their OE bits rewritten when setColorDepth() sends them again
+        int _min = 0, _max = 0;
+        if (colouridx >= first_plane)
+        {
+          _min = oe_min[colouridx - first_plane];
+          _max = oe_max[colouridx - first_plane];
+        }
+
+        uint16_t offset = old_offset;
+        for (int moved = 0; moved != dx;)
+        {
+          int step = dx - moved;
+          step = (step > HSCROLL_MAX_STEP) ? HSCROLL_MAX_STEP : (step < -HSCROLL_MAX_STEP) ? -HSCROLL_MAX_STEP : step;
+
+          hscrollControlBits(_row.getDataPtr(colouridx), offset, step, _min, _max);
+
+          offset = (offset + step + width) % width;
+          moved += step;
+        }
+      }
+
+      linkHScrollRow(_buff_id, row, true);
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief - the control bits of a bitplane are the same all along the row but for the OE blanking at its start, the LAT, OE blanking
+ * and SM5266P / SM5368 row select at its end, and the edges of the output enabled range. When the row moves along by 'step' columns,
+ * only the columns within 'step' of those change, so just those are moved along with it.
+ */
+void MatrixPanel_I2S_DMA::hscrollControlBits(ESP32_I2S_DMA_STORAGE_TYPE *plane, uint16_t offset, int step, int oe_min, int oe_max)
+{
+  const int width = PIXELS_PER_ROW;
+  const int a = (step < 0) ? -step : step;
+  const uint16_t new_offset = (offset + step + width) % width;
+
+  // [from, to) of the positions in the row to move, they can overlap
+  const int ranges[4][2] = {{0, MAX_LAT_BLANKING + a}, {width - HSCROLL_TAIL_COLUMNS - a, width}, {oe_min - a, oe_min + a}, {oe_max - a, oe_max + a}};
+
+  // all of them are read before any are written, as the ones moved into can be ones still to move out of
+  ESP32_I2S_DMA_STORAGE_TYPE ctrl[MAX_LAT_BLANKING + HSCROLL_TAIL_COLUMNS + 6 * HSCROLL_MAX_STEP];
+  int n = 0;
+
+  for (const auto &range : ranges)
+    for (int pos = std::max(range[0], 0); pos < std::min(range[1], width); pos++)
+    {
+      uint16_t x = (offset + pos) % width;
+      ctrl[n++] = plane[ESP32_TX_FIFO_POSITION_ADJUST(x)] & BITMASK_RGB12_CLEAR;
+    }
+
+  n = 0;
+  for (const auto &range : ranges)
+    for (int pos = std::max(range[0], 0); pos < std::min(range[1], width); pos++)
+    {
+      uint16_t x = (new_offset + pos) % width;
+      ESP32_I2S_DMA_STORAGE_TYPE &v = plane[ESP32_TX_FIFO_POSITION_ADJUST(x)];
+      v = (v & ~BITMASK_RGB12_CLEAR) | ctrl[n++];
+    }
+}
+
+/**
+ * @brief - scroll by sending the rows in a different order, the frame buffer row sent as DMA row 'row' being vscrollRow(row)
+ * A DMA row carries a row of the top half of the panel in its RGB1 bits and the row ROWS_PER_FRAME below it in its RGB2 bits.
+ * Moving the start of the ring on by one row sends the frame buffer row that was first last, i.e. its top half row goes from the
+ * top of the panel to the bottom, and its bottom half row from the middle to just above it: the halves of just that row swap.
+ * Everything else only needs the row address bits of the DMA row it is now sent as.
+ */
+bool MatrixPanel_I2S_DMA::scrollVertical(int16_t dy)
+{
+  if (!initialized)
+  {
+    ESP_LOGE("scrollVertical()", "Needs begin() called.");
+    return false;
+  }
+
+  const int height = m_cfg.mx_height;
+
+  // up, as up and down are the same but for the direction round the ring
+  dy %= height;
+  if (dy < 0)
+    dy += height;
+
+  if (dy == 0)
+    return true;
+
+#ifdef USE_SHADOW_BUFFER
+  if (shadow_buff)
+  {
+    std::rotate(shadow_buff, shadowPtr(0, dy), shadowPtr(0, height));
+
+    // anything not encoded yet has moved as well, both halves of a DMA row still to the same DMA row
+    std::rotate(shadow_dirty.begin(), shadow_dirty.begin() + dy % ROWS_PER_FRAME, shadow_dirty.end());
+  }
+#endif
+
+  const int fbs_used = m_cfg.triple_buff ? 3 : m_cfg.double_buff ? 2 : 1;
+
+  // rows round the ring, each crossing of the end of it swaps the halves of a row once
+  const int shift = dy % ROWS_PER_FRAME;
+  const bool swap_all = (dy >= ROWS_PER_FRAME);
+
+  // Start right after an end of frame and go through the DMA rows in the order they're sent, like scrollHorizontal(). A frame buffer
+  // row is only ever changed as the DMA row it is sent as from now on, which the DMA gets to after the CPU is done with it.
+  uint32_t timeout_ms = (calculated_refresh_rate > 0 ? 1000 / calculated_refresh_rate : 0) + 10;
+  dma_bus.wait_frames_sent(dma_bus.get_frames_sent() + 1, timeout_ms);
+
+  vscroll_offset = (vscroll_offset + dy) % height;
+  vscroll_row = vscroll_offset % ROWS_PER_FRAME;
+
+  for (int row = 0; row < ROWS_PER_FRAME; row++)
+  {
+    // the last 'shift' DMA rows are the ones that came round from the start of the ring
+    const bool swap = swap_all != (row >= ROWS_PER_FRAME - shift);
+    const int row_idx = vscrollRow(row);
+
+    for (int _buff_id = 0; _buff_id < fbs_used; _buff_id++)
+    {
+      rowBitStruct &_row = frame_buffer[_buff_id].rowBits[row_idx];
+
+      // all the bitplanes, sent or not, so setColorDepth() can show them again
+      if (swap)
+      {
+        for (uint8_t colouridx = 0; colouridx < _row.colour_depth; colouridx++)
+        {
+          ESP32_I2S_DMA_STORAGE_TYPE *p = _row.getDataPtr(colouridx);
+
+          for (size_t x = 0; x < _row.width; x++)
+            p[x] = (p[x] & BITMASK_RGB12_CLEAR) | ((p[x] << BITS_RGB2_OFFSET) & ~BITMASK_RGB2_CLEAR) | ((p[x] >> BITS_RGB2_OFFSET) & ~BITMASK_RGB1_CLEAR);
+        }
+      }
+
+      linkDMARow(_buff_id, row, true);
+      clearFrameBufferRow(_buff_id, row_idx, true);
+    }
+  }
+
+  return true;
+}
+
 #ifndef NO_FAST_FUNCTIONS
 /**
  * @brief - update DMA buff drawing horizontal line at specified coordinates
@@ -844,6 +3040,8 @@ void MatrixPanel_I2S_DMA::hlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
   if (!initialized)
     return;
 
+  DRAW_BEGIN();
+
   if ((x_coord + l) < 1 || y_coord < 0 || l < 1 || x_coord >= PIXELS_PER_ROW || y_coord >= m_cfg.mx_height)
     return;
 
@@ -855,8 +3053,26 @@ void MatrixPanel_I2S_DMA::hlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
   // if (x_coord+l > PIXELS_PER_ROW)
   //    l = PIXELS_PER_ROW - x_coord + 1;     // reset width to end of row
 
+  // a line past the end of the DMA row (see scrollHorizontal()) carries on at its start, as a second line
+  if (hscrollColumn(x_coord) + l > PIXELS_PER_ROW)
+  {
+    int16_t _l = PIXELS_PER_ROW - hscrollColumn(x_coord);
+    hlineDMA(x_coord, y_coord, _l, red, green, blue);
+    hlineDMA(x_coord + _l, y_coord, l - _l, red, green, blue);
+    return;
+  }
+
+#ifdef USE_SHADOW_BUFFER
+  if (shadowFill(x_coord, y_coord, l, 1, red, green, blue))
+    return;
+#endif
+
+  STATS_ENCODE(l);
+
+  x_coord = hscrollColumn(x_coord);
+
   /* LED Brightness Compensation */
-DO_BRIGHTNESS_COMPENSATION() 
+  DO_BITPLANE_ENCODE()
 
   uint16_t _colourbitclear = BITMASK_RGB1_CLEAR, _colourbitoffset = 0;
 
@@ -867,6 +3083,10 @@ DO_BRIGHTNESS_COMPENSATION()
     y_coord -= ROWS_PER_FRAME;
   }
 
+  y_coord = vscrollRow(y_coord); // see scrollVertical()
+
+  MARK_DIRTY(y_coord, x_coord, x_coord + l);
+
   // Iterating through colour depth bits (8 iterations)
   uint8_t colour_depth_idx = m_cfg.getPixelColorDepthBits();
   do
@@ -874,23 +3094,15 @@ DO_BRIGHTNESS_COMPENSATION()
     --colour_depth_idx;
 
     // let's precalculate RGB1 and RGB2 bits than flood it over the entire DMA buffer
-    uint16_t RGB_output_bits = 0;
-
-    // Extract bit at current depth index
-    uint16_t mask = (1 << colour_depth_idx);
 
     /* Per the .h file, the order of the output RGB bits is:
      * BIT_B2, BIT_G2, BIT_R2,    BIT_B1, BIT_G1, BIT_R1     */
-    RGB_output_bits |= (bool)(blue_val & mask); // --B
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(green_val & mask); // -BG
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(red_val & mask); // BGR
+    uint16_t RGB_output_bits = BITPLANE_RGB_BITS(colour_depth_idx); // BGR
     RGB_output_bits <<= _colourbitoffset;    // shift color bits to the required position
 
     // Get the contents at this address,
     // it would represent a vector pointing to the full row of pixels for the specified colour depth bit at Y coordinate
-    ESP32_I2S_DMA_STORAGE_TYPE *p = fb->rowBits[y_coord]->getDataPtr(colour_depth_idx);
+    ESP32_I2S_DMA_STORAGE_TYPE *p = fb->rowBits[y_coord].getDataPtr(colour_depth_idx);
     // inlined version works slower here, dunno why :(
     // ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(y_coord, colour_depth_idx, back_buffer_id);
 
@@ -914,6 +3126,8 @@ DO_BRIGHTNESS_COMPENSATION()
       v |= RGB_output_bits;   // set new colour bits
     } while (_l);             // iterate pixels in a row
   } while (colour_depth_idx); // end of colour depth loop (8)
+
+  DRAW_DONE();
 } // hlineDMA()
 
 /**
@@ -928,6 +3142,8 @@ void MatrixPanel_I2S_DMA::vlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
   if (!initialized)
     return;
 
+  DRAW_BEGIN();
+
   if (x_coord < 0 || (y_coord + l) < 1 || l < 1 || x_coord >= PIXELS_PER_ROW || y_coord >= m_cfg.mx_height)
     return;
 
@@ -939,7 +3155,14 @@ void MatrixPanel_I2S_DMA::vlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
   // if (y_coord + l > m_cfg.mx_height)
   ///    l = m_cfg.mx_height - y_coord + 1;     // reset width to end of col
 
-  DO_BRIGHTNESS_COMPENSATION() 
+#ifdef USE_SHADOW_BUFFER
+  if (shadowFill(x_coord, y_coord, 1, l, red, green, blue))
+    return;
+#endif
+
+  STATS_ENCODE(l);
+
+  DO_BITPLANE_ENCODE()
 
   /*
   #if defined(ESP32_THE_ORIG)
@@ -947,24 +3170,19 @@ void MatrixPanel_I2S_DMA::vlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
     x_coord & 1U ? --x_coord : ++x_coord;
   #endif
   */
-  x_coord = ESP32_TX_FIFO_POSITION_ADJUST(x_coord);
+  x_coord = DMA_COLUMN(x_coord);
+
+  for (int16_t _y = y_coord; _y < y_coord + l; _y++)
+    MARK_DIRTY(vscrollRow(_y >= ROWS_PER_FRAME ? _y - ROWS_PER_FRAME : _y), x_coord, x_coord + 1);
 
   uint8_t colour_depth_idx = m_cfg.getPixelColorDepthBits();
   do
   { // Iterating through colour depth bits (8 iterations)
     --colour_depth_idx;
 
-    // Extract bit at current depth index
-    uint16_t mask = (1 << colour_depth_idx);
-    uint16_t RGB_output_bits = 0;
-
     /* Per the .h file, the order of the output RGB bits is:
      * BIT_B2, BIT_G2, BIT_R2,    BIT_B1, BIT_G1, BIT_R1   */
-    RGB_output_bits |= (bool)(blue_val & mask); // --B
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(green_val & mask); // -BG
-    RGB_output_bits <<= 1;
-    RGB_output_bits |= (bool)(red_val & mask); // BGR
+    uint16_t RGB_output_bits = BITPLANE_RGB_BITS(colour_depth_idx); // BGR
 
     int16_t _l = 0, _y = y_coord;
     uint16_t _colourbitclear = BITMASK_RGB1_CLEAR;
@@ -981,13 +3199,15 @@ void MatrixPanel_I2S_DMA::vlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
       // Get the contents at this address,
       // it would represent a vector pointing to the full row of pixels for the specified colour depth bit at Y coordinate
       // ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(_y, colour_depth_idx, back_buffer_id);
-      ESP32_I2S_DMA_STORAGE_TYPE *p = fb->rowBits[_y]->getDataPtr(colour_depth_idx);
+      ESP32_I2S_DMA_STORAGE_TYPE *p = fb->rowBits[vscrollRow(_y)].getDataPtr(colour_depth_idx);
 
       p[x_coord] &= _colourbitclear; // reset RGB bits
       p[x_coord] |= RGB_output_bits; // set new RGB bits
       ++_y;
     } while (++_l != l);      // iterate pixels in a col
   } while (colour_depth_idx); // end of colour depth loop (8)
+
+  DRAW_DONE();
 } // vlineDMA()
 
 /**
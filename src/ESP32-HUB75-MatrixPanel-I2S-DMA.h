@@ -11,6 +11,7 @@
 
 // #include <Arduino.h>
 #include "platforms/platform_detect.hpp"
+#include "HUB75Planner.hpp"
 
 #ifdef USE_GFX_LITE
   // Slimmed version of Adafruit GFX + FastLED: https://github.com/mrcodetastic/GFX_Lite
@@ -85,6 +86,24 @@
 /***************************************************************************************/
 /* Definitions below should NOT be ever changed without rewriting library logic         */
 #define ESP32_I2S_DMA_STORAGE_TYPE uint16_t // DMA output of one uint16_t at a time.
+
+#ifdef USE_BITPLANE_LUT
+// Brightness compensated colour value spread out to 3 bits per bitplane (R at bit 3*plane, G at 3*plane+1, B at 3*plane+2)
+// 64 bits are needed to hold PIXEL_COLOR_DEPTH_BITS_MAX planes.
+typedef uint64_t bitplane_lut_t;
+#endif
+#ifdef USE_SHADOW_BUFFER
+// -DUSE_SHADOW_BUFFER keeps an RGB888 copy of the frame, -DUSE_SHADOW_BUFFER=565 an RGB565 one in 2/3 of the memory
+#if USE_SHADOW_BUFFER == 565
+#define SHADOW_BYTES_PER_PIXEL 2
+#else
+#define SHADOW_BYTES_PER_PIXEL 3
+#endif
+#endif
+#if defined(SPIRAM_DMA_BUFFER) && !defined(PSRAM_PLACEMENT_SRAM_RESERVE)
+// Internal SRAM left free for everything else when bitplanes are put there, see HUB75_I2S_CFG::psram_placement
+#define PSRAM_PLACEMENT_SRAM_RESERVE (48 * 1024)
+#endif
 #define CLKS_DURING_LATCH 0                 // Not (yet) used.
 
 // Panel Upper half RGB (numbering according to order in DMA gpio_bus configuration)
@@ -124,6 +143,13 @@
 // Max clock cycles to blank OE before/after LAT signal change
 #define MAX_LAT_BLANKING 4
 
+// scrollHorizontal() moves by multiples of this many columns. The ESP32 / S2 I2S DMA only takes word aligned buffers.
+#if defined(ESP32_THE_ORIG) || defined(CONFIG_IDF_TARGET_ESP32S2)
+#define HSCROLL_STEP 2
+#else
+#define HSCROLL_STEP 1
+#endif
+
 /***************************************************************************************/
 
 /** @brief - Structure holds raw DMA data to drive TWO full rows of pixels spanning through all chained modules
@@ -143,9 +169,12 @@ struct rowBitStruct
  * @var data
  * Pointer to DMA storage type array holding pixel data for the row
  * 
- * @note Memory allocation differs based on target platform and configuration:
- * - For ESP32-S3 with SPIRAM: Allocates aligned memory in SPIRAM
- * - For other configurations: Allocates DMA-capable internal memory
+ * @note The row doesn't own its memory, it is a view into the memory block(s) allocated
+ * by the frameStruct it belongs to. See frameStruct::allocate().
+ *
+ * @note With SPIRAM_DMA_BUFFER the bitplanes may be split in two runs, bitplanes [0, split) at 'data'
+ * and [split, colour_depth) at 'data_hi', one of them in internal SRAM and the other in PSRAM.
+ * See HUB75_I2S_CFG::psram_placement. Always go through getDataPtr() for a bitplane.
  */
 {
   const size_t width;
@@ -153,6 +182,15 @@ struct rowBitStruct
   //const bool double_buff;
   ESP32_I2S_DMA_STORAGE_TYPE *data;
 
+#if defined(SPIRAM_DMA_BUFFER)
+  uint8_t split;                        // first bitplane held at data_hi, colour_depth if there is only the one run
+  ESP32_I2S_DMA_STORAGE_TYPE *data_hi = nullptr;
+  bool lo_psram = true, hi_psram = true; // which of the two runs is in PSRAM (and so needs cache write backs)
+
+  /* true when bitplane _dpth is in PSRAM */
+  inline bool inPsram(const uint8_t _dpth) const { return (_dpth < split) ? lo_psram : hi_psram; }
+#endif
+
   /** @brief Returns size (in bytes) of a colour depth row data array
    * 
    * @param single_color_depth 
@@ -175,43 +213,149 @@ struct rowBitStruct
    * NOTE: this call might be very slow in loops. Due to poor instruction caching in esp32 it might be required a reread from flash
    * every loop cycle, better use inlined #define instead in such cases
    */
-  inline ESP32_I2S_DMA_STORAGE_TYPE *getDataPtr(const uint8_t _dpth = 0) { return &(data[_dpth * width]); };
-
-  // constructor - allocates DMA-capable memory to hold the struct data
-  //rowBitStruct(const size_t _width, const uint8_t _depth, const bool _dbuff) : width(_width), colour_depth(_depth), double_buff(_dbuff)
-  rowBitStruct(const size_t _width, const uint8_t _depth) : width(_width), colour_depth(_depth)
-  {
-
-    // #if defined(SPIRAM_FRAMEBUFFER) && defined (CONFIG_IDF_TARGET_ESP32S3)
 #if defined(SPIRAM_DMA_BUFFER)
+  inline ESP32_I2S_DMA_STORAGE_TYPE *getDataPtr(const uint8_t _dpth = 0) { return (_dpth < split) ? &(data[_dpth * width]) : &(data_hi[(_dpth - split) * width]); };
 
-    // data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_aligned_alloc(64, size()+size()*double_buff, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    // No longer have double buffer in the same struct - have a different struct
-    data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_aligned_alloc(64, getColorDepthSize(false), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  // constructor - the row data lives in its frameStruct's memory block(s)
+  rowBitStruct(const size_t _width, const uint8_t _depth, ESP32_I2S_DMA_STORAGE_TYPE *_data) : width(_width), colour_depth(_depth), data(_data), split(_depth) {}
 #else
-    // data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_malloc( size()+size()*double_buff, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
-
-    // No longer have double buffer in the same struct - have a different struct
-    data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_malloc(getColorDepthSize(false), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+  inline ESP32_I2S_DMA_STORAGE_TYPE *getDataPtr(const uint8_t _dpth = 0) { return &(data[_dpth * width]); };
 
+  // constructor - the row data lives in its frameStruct's memory block(s)
+  rowBitStruct(const size_t _width, const uint8_t _depth, ESP32_I2S_DMA_STORAGE_TYPE *_data) : width(_width), colour_depth(_depth), data(_data) {}
 #endif
+};
+
+/* A [x0, x1) run of pixels in a row, empty when x0 >= x1.
+ * Used to keep track of what was drawn where (see USE_DIRTY_TRACKING and USE_SHADOW_BUFFER).
+ */
+struct rowSpan
+{
+  uint16_t x0 = UINT16_MAX, x1 = 0;
+
+  inline bool empty() const { return x1 <= x0; }
+  inline void clear() { x0 = UINT16_MAX; x1 = 0; }
+  inline void merge(uint16_t _x0, uint16_t _x1)
+  {
+    if (_x0 < x0) x0 = _x0;
+    if (_x1 > x1) x1 = _x1;
   }
-  ~rowBitStruct() { heap_caps_free(data); }
+  inline void merge(const rowSpan &s) { merge(s.x0, s.x1); }
 };
 
 /* frameStruct
  * Note: A 'frameStruct' contains ALL the data for a full-frame (i.e. BOTH 2x16-row frames are
  *       are contained in parallel within the one uint16_t that is sent in parallel to the HUB75).
  *
- *       This structure isn't actually allocated in one memory block anymore, as the library now allocates
- *       memory per row (per rowBits) instead.
+ *       The rows are allocated as an arena: one memory block for the whole frame if the heap allows,
+ *       otherwise as few blocks (each holding a run of whole rows) as the heap fragmentation requires.
+ *       rowBits are just views into those blocks.
  */
 struct frameStruct
 {
-  uint8_t rows = 0; // number of rows held in current frame, not used actually, just to keep the idea of struct
-  std::vector<std::shared_ptr<rowBitStruct>> rowBits;
+  uint8_t rows = 0; // number of rows held in current frame
+  std::vector<rowBitStruct> rowBits;
+  std::vector<ESP32_I2S_DMA_STORAGE_TYPE *> blocks; // arena memory block(s) the rows point into
+
+  frameStruct() = default;
+  frameStruct(const frameStruct &) = delete;
+  frameStruct &operator=(const frameStruct &) = delete;
+  ~frameStruct() { release(); }
+
+  /** @brief Allocates DMA capable memory for '_rows' rows of '_width' pixels x '_depth' colour depth bits.
+   *  All or nothing, if the rows don't fit into the heap nothing is left allocated.
+   *  @param _sram_planes with SPIRAM_DMA_BUFFER, the number of bitplanes per row to put in internal SRAM rather than PSRAM,
+   *                      the most significant ones if _sram_msb, else the least significant ones. Ignored otherwise.
+   *  @returns true on success
+   */
+  bool allocate(const size_t _width, const uint8_t _depth, const uint8_t _rows, const uint8_t _sram_planes = 0, const bool _sram_msb = true);
+
+  /** @brief Frees the memory block(s) and drops the rows */
+  void release();
+
+#if defined(SPIRAM_DMA_BUFFER)
+  /* Per row, what was drawn to and not yet written back from the cache to PSRAM. See MatrixPanel_I2S_DMA::commit() */
+  std::vector<rowSpan> unflushed;
+#endif
+
+#ifdef USE_DIRTY_TRACKING
+  /* Per row: 'dirty' - pixels drawn to since this buffer last became the back buffer,
+   *          'stale' - pixels drawn to in the other buffer(s) since then, that this one is missing.
+   * See MatrixPanel_I2S_DMA::syncBackBuffer() */
+  std::vector<rowSpan> dirty, stale;
+
+  inline void markDirty(uint16_t row, uint16_t x0, uint16_t x1) { dirty[row].merge(x0, x1); }
+#endif
+};
+
+/* BitplaneSprite
+ * An image already encoded the way the bitplanes hold it, to draw again and again without encoding it every time.
+ * One byte per pixel per bitplane: the pixel's B,G,R bits of that bitplane in the R1G1B1 position, or just
+ * SPRITE_TRANSPARENT for a pixel that isn't drawn. Row by row, each row bitplane by bitplane:
+ *
+ *   data[(y * depth + bitplane) * width + x]
+ *
+ * So it takes width * height * depth bytes. Built by MatrixPanel_I2S_DMA::encodeSprite(), or from a const array of
+ * such bytes (e.g. a sprite encoded on the host and dumped) for the same colour depth and brightness curve.
+ */
+#define SPRITE_TRANSPARENT 0x08
+
+struct BitplaneSprite
+{
+  int16_t width = 0, height = 0;
+  uint8_t depth = 0;              // colour depth it was encoded for, it can't be drawn at any other
+  const uint8_t *data = nullptr;  // the encoded pixels, 'storage' or someone else's array
+  std::vector<uint8_t> storage;   // what encodeSprite() encoded into
+
+  BitplaneSprite() = default;
+  BitplaneSprite(int16_t _width, int16_t _height, uint8_t _depth, const uint8_t *_data) : width(_width), height(_height), depth(_depth), data(_data) {}
+
+  // 'data' may point into 'storage', which moves along with it but isn't copied
+  BitplaneSprite(const BitplaneSprite &) = delete;
+  BitplaneSprite &operator=(const BitplaneSprite &) = delete;
+  BitplaneSprite(BitplaneSprite &&) = default;
+  BitplaneSprite &operator=(BitplaneSprite &&) = default;
+
+  /* the width bytes of bitplane _dpth of row _y */
+  inline const uint8_t *getRowPtr(int16_t _y, uint8_t _dpth) const { return data + ((size_t)_y * depth + _dpth) * width; }
+};
+
+/* USE_STATS: count the pixels a drawing function encodes into the DMA buffer, and time it from here to its return.
+ * CPU cycles on the ESP32, so the drawing task should be pinned to a core. Nanoseconds on the host.
+ * In the header as MatrixPanel_T's drawPixel() uses it too.
+ */
+#ifdef USE_STATS
+#if defined(ESP_PLATFORM)
+#include <esp_idf_version.h>
+#include <esp_rom_sys.h>
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include <esp_cpu.h>
+#define STATS_TICKS() ((uint32_t)esp_cpu_get_cycle_count())
+#else
+#include "xtensa/core-macros.h"
+#define STATS_TICKS() ((uint32_t)XTHAL_GET_CCOUNT())
+#endif
+#define STATS_TICKS_PER_US() esp_rom_get_cpu_ticks_per_us()
+#else
+#include <chrono>
+#define STATS_TICKS() ((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#define STATS_TICKS_PER_US() 1000
+#endif
+
+struct StatsEncodeTimer
+{
+  uint64_t &ticks;
+  const uint32_t start;
+
+  StatsEncodeTimer(uint64_t &_pixels, uint64_t &_ticks, uint32_t _count) : ticks(_ticks), start(STATS_TICKS()) { _pixels += _count; }
+  ~StatsEncodeTimer() { ticks += (uint32_t)(STATS_TICKS() - start); }
 };
 
+#define STATS_ENCODE(pixels) StatsEncodeTimer _stats_encode(stats_pixels, stats_encode_ticks, pixels)
+#else
+#define STATS_ENCODE(pixels)
+#endif
+
 /***************************************************************************************/
 // CIE 1931 lightness lookup tables - auto-generated by tools/generate_cie_luts.py
 // Based on:
@@ -289,6 +433,36 @@ struct HUB75_I2S_CFG
   // use DMA double buffer (twice as much RAM required)
   bool double_buff;
 
+  // use DMA triple buffer (three times as much RAM required, implies double_buff)
+  // one buffer is displayed, one is queued to be displayed next and one is drawn to, so flipDMABuffer() only waits for the panel with two frames already in flight
+  bool triple_buff = false;
+
+  /**
+   * Where the bitplanes go with SPIRAM_DMA_BUFFER, ignored otherwise.
+   *
+   * The bitplanes above the lsbMsbTransitionBit are sent 2, 4, 8... times per row, so nearly all of
+   * the data the DMA reads comes from a few most significant bitplanes.
+   *  PSRAM_ALL_PLANES - everything in PSRAM (default)
+   *  PSRAM_LSB_PLANES - as many of the most significant bitplanes as fit in internal DMA capable SRAM
+   *                     (keeping PSRAM_PLACEMENT_SRAM_RESERVE bytes free) go there, the rest in PSRAM
+   *  PSRAM_MSB_PLANES - the reverse, the least significant bitplanes go to SRAM
+   * Refer to testing/psram_placement_model.cpp for the PSRAM bandwidth each one needs.
+   */
+  enum psram_policy
+  {
+    PSRAM_ALL_PLANES = 0,
+    PSRAM_LSB_PLANES,
+    PSRAM_MSB_PLANES
+  };
+  psram_policy psram_placement = PSRAM_ALL_PLANES;
+
+  /**
+   * Link the DMA descriptors so scrollHorizontal() can move the whole display sideways without redrawing it.
+   * Every pass over a bitplane of a row takes two descriptors instead of one, so about twice the descriptor memory
+   * (see getMemoryReport()). A row (all chained panels) can't be more than 2046 pixels, and SPIRAM_DMA_BUFFER isn't supported.
+   */
+  bool hscroll = false;
+
   // I2S clock speed
   clk_speed i2sspeed;
 
@@ -463,10 +637,24 @@ public:
 		return false;
 	}
 
+#ifdef USE_BITPLANE_LUT
+    buildBitplaneLUT(); // depends on the colour depth, so (re)build it now the config is final
+#endif
+
+#ifdef USE_SHADOW_BUFFER
+    if (!allocateShadowBuffer())
+    {
+      return false;
+    }
+#endif
+
+    if (m_cfg.triple_buff)
+      m_cfg.double_buff = true;
+
     /* As DMA buffers are dynamically allocated, we must allocated in begin()
      * Ref: https://github.com/espressif/arduino-esp32/issues/831
      */
-    if (!setupDMA(m_cfg))
+    if (!setupDMA())
     {
       return false;
     } // couldn't even get the basic ram required.
@@ -480,7 +668,7 @@ public:
     resetbuffers(); // Must fill the DMA buffer with the initial output bit sequence or the panel will display garbage
     ESP_LOGV("being()", "Completed resetbuffers()");	
 
-	flipDMABuffer(); // display back buffer 0, draw to 1, ignored if double buffering isn't enabled.		
+	flipDMABuffer(); // display back buffer 0, draw to 1 (triple buffer: queue 0, draw to 1), ignored if double buffering isn't enabled.		
     ESP_LOGV("being()", "Completed flipDMABuffer()");		
 
 	// Start output output
@@ -490,6 +678,10 @@ public:
 	dma_bus.dma_transfer_start();
     ESP_LOGV("being()", "Completed dma_bus.dma_transfer_start()");		
 
+#ifdef USE_STATS
+    resetStats(); // flipDMABuffer() above isn't a flip of the sketch's
+#endif
+
     return initialized;
   }
 
@@ -497,6 +689,11 @@ public:
   virtual ~MatrixPanel_I2S_DMA()
   {
     dma_bus.release();
+
+#ifdef USE_SHADOW_BUFFER
+    if (shadow_buff)
+      heap_caps_free(shadow_buff);
+#endif
   }
 
   /*
@@ -597,6 +794,80 @@ public:
   void fillScreenRGB888(uint8_t r, uint8_t g, uint8_t b);
   void drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b);
 
+  /**
+   * @brief - fade everything in the buffer being drawn to towards black, halving its light output 'shift' times, without redrawing it
+   * The colour bits of each bitplane are replaced by those of the bitplane 'shift' above it, i.e. the brightness compensated colour
+   * values of every pixel are shifted down, a couple of 32 bit masked copies per two columns of a bitplane. A step of a fade to black.
+   * With USE_SHADOW_BUFFER the shadow buffer is faded as well, through the brightness curve, so getPixelRGB() and reencode() agree.
+   * @param shift - 1 halves, the colour depth or more is black
+   */
+  void fadeFrame(uint8_t shift);
+
+  /**
+   * @brief - scale the light output of everything in the buffer being drawn to by numerator / 256, without redrawing it
+   * Like fadeFrame(), but with finer steps: the brightness compensated colour values of every pixel are multiplied in the bitplanes,
+   * a shift and add per bit set in 'numerator', for the colour bits of two columns of both halves of the panel at a time.
+   * @param numerator - 0 is black, 128 the same as fadeFrame(1), 255 next to no change
+   */
+  void dimFrame(uint8_t numerator);
+
+  /**
+   * @brief - move a w x h rectangle of what's been drawn to dst_x, dst_y, straight from bitplane to bitplane
+   * The colour bits of every pixel are copied as they are, with no brightness compensation or bit spreading, and the
+   * rectangles may overlap (like memmove()). Whatever of the rectangle is off the panel at either end is left out.
+   * With USE_SHADOW_BUFFER the shadow buffer is moved the same.
+   */
+  void copyRect(int16_t src_x, int16_t src_y, int16_t w, int16_t h, int16_t dst_x, int16_t dst_y);
+
+  /**
+   * @brief - encode a w x h image into 'sprite' once, for drawSprite() to draw as often as needed
+   * It's encoded for all pixel_color_depth_bits bitplanes, so setColorDepth() leaves it as good as before.
+   * @param rgb888 / rgb565 - w * h pixels, row by row
+   * @param transparent - RGB565 colour of the pixels that aren't to be drawn, -1 for none
+   * @returns false before begin() or if there isn't the memory for it
+   */
+  bool encodeSprite(BitplaneSprite &sprite, const uint8_t *rgb888, int16_t w, int16_t h, int32_t transparent = -1);
+  bool encodeSprite(BitplaneSprite &sprite, const uint16_t *rgb565, int16_t w, int16_t h, int32_t transparent = -1);
+
+  /**
+   * @brief - draw a sprite with its top left at x, y
+   * Nothing is encoded: each bitplane of each row of the sprite is a masked OR of its bytes into the DMA words.
+   * Whatever is off the panel is left out. A sprite encoded for another colour depth isn't drawn.
+   */
+  void drawSprite(const BitplaneSprite &sprite, int16_t x, int16_t y);
+
+  /**
+   * @brief - write a horizontal run of pixels to row y in one pass
+   * Bounds checks, CIE lookups and the top/bottom half decision are done once per run,
+   * and each colour depth bitplane of the row is then written sequentially.
+   * Much faster than calling drawPixelRGB888() for every pixel of a full frame update.
+   * @param y - row to write to
+   * @param rgb - packed R,G,B byte triplets, 'len' pixels long
+   * @param x0 - x coordinate of the first pixel
+   * @param len - number of pixels to write
+   */
+  void drawRowRGB888(int16_t y, const uint8_t *rgb, int16_t x0, int16_t len);
+
+  /**
+   * @brief - RGB565 version of drawRowRGB888()
+   * @param rgb565 - RGB565 colours, 'len' pixels long
+   */
+  void drawRowRGB565(int16_t y, const uint16_t *rgb565, int16_t x0, int16_t len);
+
+  /**
+   * @brief - push a whole frame of packed RGB888 pixels to the DMA buffer
+   * The two source rows that are output together (row y and row y + height/2) are encoded
+   * together, so every DMA word of every bitplane is written with a single store.
+   * @param rgb - width() * height() packed R,G,B byte triplets, row by row
+   */
+  void pushFrameRGB888(const uint8_t *rgb);
+
+  /**
+   * @brief - push a rectangle of packed RGB888 pixels to the DMA buffer, same as pushFrameRGB888()
+   * @param rgb - w * h packed R,G,B byte triplets, row by row
+   */
+  void pushRectRGB888(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *rgb);
+
 #ifdef USE_GFX_LITE
   // 24bpp FASTLED CRGB colour struct support
   void fillScreen(CRGB color);
@@ -608,6 +879,10 @@ public:
     inline int16_t height() const { return m_cfg.mx_height; }
 #endif
 
+  /**
+   * @brief - draw a cols x rows icon of RGB565 colours, one per int, row by row
+   * For an icon drawn over and over, encodeSprite() it once and drawSprite() it instead.
+   */
   void drawIcon(int *ico, int16_t x, int16_t y, int16_t cols, int16_t rows);
 
   // Colour 444 is a 4 bit scale, so 0 to 15, colour 565 takes a 0-255 bit value, so scale up by 255/15 (i.e. 17)!
@@ -621,23 +896,279 @@ public:
    */
   static void color565to888(const uint16_t color, uint8_t &r, uint8_t &g, uint8_t &b);
 
-  inline void flipDMABuffer()
+  /**
+   * @brief - read back the colour of pixel x,y from the bitplanes of the buffer being drawn to, no extra memory needed
+   * The stored colour depth value of each channel is mapped back through the brightness (CIE1931 or linear) curve,
+   * so the colour is approximate: the middle of the 8 bit values that encode the same. Drawing it again leaves the pixel as it is.
+   * @returns false if x,y is off the panel
+   */
+  bool getPixelRGB(int16_t x, int16_t y, uint8_t &r, uint8_t &g, uint8_t &b);
+
+  /**
+   * @brief - the colour depth bits of pixel x,y as stored in the bitplanes, before any mapping back to 8 bits
+   * @returns false if x,y is off the panel
+   */
+  bool getPixelRaw(int16_t x, int16_t y, uint16_t &r, uint16_t &g, uint16_t &b);
+
+  /**
+   * @brief - getPixelRGB() for a run of pixels of row y, each bitplane of the row is walked once
+   * @param rgb - receives packed R,G,B byte triplets, 'len' pixels long. Pixels off the panel are left untouched.
+   * @returns number of pixels read
+   */
+  int16_t readRow(int16_t y, uint8_t *rgb, int16_t x0, int16_t len);
+
+#ifdef USE_SHADOW_BUFFER
+  /**
+   * @brief - read back the colour last drawn at x,y from the shadow buffer
+   * With USE_SHADOW_BUFFER=565 the colour comes back rounded to RGB565.
+   * @returns false if x,y is off the panel
+   */
+  bool readPixel(int16_t x, int16_t y, uint8_t &r, uint8_t &g, uint8_t &b);
+
+  /**
+   * @brief - RGB565 version of readPixel(), returns black if x,y is off the panel
+   */
+  uint16_t readPixel(int16_t x, int16_t y)
+  {
+    uint8_t r, g, b;
+    return readPixel(x, y, r, g, b) ? color565(r, g, b) : 0;
+  }
+
+  /**
+   * @brief - draw a pixel alpha blended over what is there already
+   * @param uint8_t alpha - 0 leaves the pixel as it is, 255 is the same as drawPixelRGB888()
+   */
+  void blendPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha);
+
+  void blendPixel(int16_t x, int16_t y, uint16_t color, uint8_t alpha)
+  {
+    uint8_t r, g, b;
+    color565to888(color, r, g, b);
+    blendPixelRGB888(x, y, r, g, b, alpha);
+  }
+
+  /**
+   * @brief - only draw into the shadow buffer, and leave the DMA buffer as it is until reencodeDirty()
+   * Overlapping draws (blending, layers, sprites) then cost a shadow buffer write each, and every
+   * changed pixel is encoded into the bitplanes once, a row span at a time.
+   */
+  void setDeferredEncode(bool defer) { shadow_deferred = defer; }
+
+  /**
+   * @brief - encode the whole shadow buffer into the DMA buffer being drawn to
+   * Restores the frame after anything that wipes or changes the bitplane encoding (i.e. stopDMAoutput()).
+   */
+  void reencode() { encodeShadowBuffer(false); }
+
+  /**
+   * @brief - encode only the row spans of the shadow buffer drawn to since the last reencode() / reencodeDirty()
+   */
+  void reencodeDirty() { encodeShadowBuffer(true); }
+#endif
+
+  /**
+   * @brief - show the back buffer drawn so far, and switch drawing to the other buffer.
+   * Only does anything with double_buff. The DMA moves over to the new front buffer at the end of the
+   * frame it is sending, so the buffer handed back for drawing can still be on the panel for up to two
+   * frames (see isBackBufferFree()). Drawing into it before then can tear.
+   * Built with USE_DIRTY_TRACKING the buffer handed back is brought up to the frame just flipped (see syncBackBuffer())
+   * once it's off the panel, by waitBackBufferFree() or else by the next drawing call, so only what changes needs to be
+   * drawn. Otherwise it holds whatever was last drawn into it.
+   * @param bool wait - block until the new back buffer is free (paces the caller to the panel refresh)
+   */
+  inline void flipDMABuffer(bool wait = false)
   {
     if (!m_cfg.double_buff)
     {
       return;
     }
-	
-    dma_bus.flip_dma_output_buffer(back_buffer_id);
-	
-	//back_buffer_id ^= 1;
-	back_buffer_id = back_buffer_id^1;
-    fb = &frame_buffer[back_buffer_id];	
-	
 
-	
+    commit(); // the DMA must see everything drawn into the back buffer
+
+#ifdef USE_DIRTY_TRACKING
+    finishBackBufferSync(); // the flip or crossfadeDMABuffer() before this one
+
+    back_buffer_sync_from = back_buffer_id; // not while the new back buffer is on the panel, see waitBackBufferFree()
+#endif
+
+#ifdef USE_STATS
+    stats_flips_requested++;
+    dma_bus.stats_flip(back_buffer_id);
+#endif
+
+    if (m_cfg.triple_buff)
+    {
+      // Queue the back buffer to be shown from the next frame (or the one after, if this frame is nearly
+      // sent already). Carry on drawing into whichever buffer is free, which there always is unless the
+      // previous flip also landed at the end of a frame and two frames are in flight, then that's the
+      // one being sent once it's done.
+      dma_bus.queue_dma_output_buffer(back_buffer_id);
+      back_buffer_id = getTripleBufferDrawId();
+    }
+    else
+    {
+      dma_bus.stop_dma_output_blend(); // ends any crossfadeDMABuffer() here
+      dma_bus.flip_dma_output_buffer(back_buffer_id);
+
+      // If the DMA was already part way through the last descriptor of the old chain when it was relinked,
+      // it loops over the old buffer once more. So only the second end of frame after the relink guarantees
+      // the switch has happened.
+      back_buffer_free_frame = dma_bus.get_frames_sent() + 2;
+
+      back_buffer_id = back_buffer_id ^ 1;
+    }
+
+    fb = &frame_buffer[back_buffer_id];
+
+    if (wait)
+    {
+      waitBackBufferFree();
+    }
   }
 
+  /**
+   * @brief - like flipDMABuffer(), but the panel crossfades from the frame it shows to the back buffer over 'frames' refreshes.
+   * The end of frame interrupt links one buffer or the other in for each refresh, the back buffer for a rising share of them,
+   * and the eye averages the refreshes. Nothing is redrawn or re-encoded, so the CPU is free for the whole transition.
+   * It needs a refresh rate well above 100 Hz (see calculated_refresh_rate) for the middle of the fade not to flicker.
+   * Both buffers are on the panel until it's over, so the buffer handed back for drawing isn't free (isBackBufferFree())
+   * for 'frames' + 2 refreshes. Built with USE_DIRTY_TRACKING it's brought up to date by waitBackBufferFree(), so call
+   * that (or pass wait) before drawing into it. A flipDMABuffer() meanwhile ends the crossfade there and then.
+   * double_buff only, with triple_buff it's a plain flipDMABuffer().
+   * @param uint16_t frames - length of the transition in refreshes, i.e. calculated_refresh_rate / 2 for half a second
+   * @param bool wait - block until the transition is over and the new back buffer is free
+   */
+  void crossfadeDMABuffer(uint16_t frames, bool wait = false);
+
+  /**
+   * @brief - is a crossfadeDMABuffer() still under way?
+   */
+  inline bool isCrossfading() const { return dma_bus.get_dma_blend_frames_left() != 0; }
+
+  /**
+   * @brief - make everything drawn so far visible to the DMA
+   * Only needed with SPIRAM_DMA_BUFFER, where drawing goes through the CPU cache and the changed row spans have to
+   * be written back to PSRAM, which is done in one batch here. flipDMABuffer() commits the back buffer itself, and
+   * without double buffering every drawing call commits at its end, so calling this is never required. Does nothing otherwise.
+   */
+  void commit();
+
+  /**
+   * @brief - has the DMA finished with the buffer we are drawing to since the last flipDMABuffer()?
+   * Always true without double_buff.
+   */
+  inline bool isBackBufferFree() const
+  {
+    if (!m_cfg.double_buff)
+    {
+      return true;
+    }
+
+    if (m_cfg.triple_buff)
+    {
+      int8_t current, next, queued;
+      dma_bus.get_dma_output_buffers(current, next, queued);
+      return back_buffer_id != current && back_buffer_id != next;
+    }
+
+    return (int32_t)(dma_bus.get_frames_sent() - back_buffer_free_frame) >= 0;
+  }
+
+  /**
+   * @brief - block until isBackBufferFree(). The calling task sleeps on the end of frame interrupt, it doesn't spin.
+   * @return false if no frame was sent in time (DMA not running, or no end of frame interrupt available)
+   */
+  bool waitBackBufferFree()
+  {
+    if (!isBackBufferFree())
+    {
+      // triple buffer: the buffer being sent now is free once the next frame starts
+      uint32_t free_frame = m_cfg.triple_buff ? dma_bus.get_frames_sent() + 1 : back_buffer_free_frame;
+
+      // allow for a couple of frames more than that at the calculated refresh rate (a crossfade can be many)
+      uint32_t frames = free_frame - dma_bus.get_frames_sent() + 1;
+      uint32_t timeout_ms = (calculated_refresh_rate > 0 ? frames * 1000 / calculated_refresh_rate : 0) + 10;
+
+      if (!dma_bus.wait_frames_sent(free_frame, timeout_ms) || !isBackBufferFree())
+      {
+        ESP_LOGW("waitBackBufferFree()", "Timed out waiting for the DMA to finish with the back buffer.");
+        return false;
+      }
+    }
+
+#ifdef USE_DIRTY_TRACKING
+    finishBackBufferSync();
+#endif
+
+    return true;
+  }
+
+  /**
+   * @brief - number of complete frames the DMA has sent to the panel since begin()
+   */
+  inline uint32_t getFramesSent() const { return dma_bus.get_frames_sent(); }
+
+#ifdef USE_STATS
+  /**
+   * @brief - USE_STATS builds only: what the output and drawing have done since begin() or resetStats(),
+   * i.e. to check the panel really is refreshed at calculated_refresh_rate with everything else running.
+   */
+  struct stats_t
+  {
+    uint32_t elapsed_us;             // since begin() / resetStats()
+    uint32_t frames_output;          // frames sent to the panel
+    float    measured_refresh_rate;  // from the times of the first and last of those frames
+    uint32_t max_frame_us;           // longest time between the ends of two frames (1000000 / calculated_refresh_rate expected)
+    uint32_t flips_requested;        // flipDMABuffer() calls
+    uint32_t flips_applied;          // that got to the panel, the rest were replaced by a later flip first
+    uint32_t flip_latency_avg_us;    // from flipDMABuffer() to the end of the frame the DMA moved to the new buffer at
+    uint32_t flip_latency_max_us;
+    uint64_t pixels_written;         // encoded into the DMA buffer, by all drawing functions
+    uint32_t pixels_per_second;      // pixels_written over elapsed_us
+    uint32_t encode_us;              // time spent encoding them
+  };
+
+  /**
+   * @brief - a snapshot of the counters. Safe to call from any task while the output runs.
+   */
+  stats_t getStats() const;
+
+  /**
+   * @brief - start counting afresh, i.e. to measure one part of a sketch
+   */
+  void resetStats();
+#endif
+
+#if !defined(ESP_PLATFORM)
+  /**
+   * @brief - host builds only: the emulated output, to run the DMA and capture the words it sends.
+   * Refer to platforms/host/README.md
+   */
+  inline Bus_Parallel16 &getHostBus() { return dma_bus; }
+#endif
+
+  /**
+   * @brief - memory the DMA buffers for a config take, so the cost of double_buff / triple_buff
+   * (or colour depth, chain length...) can be checked before begin().
+   */
+  struct memory_report_t
+  {
+    uint8_t framebuffers;         // 1, 2 or 3
+    size_t framebuffer_bytes;     // per framebuffer (PSRAM with SPIRAM_DMA_BUFFER, otherwise internal DMA capable RAM)
+    size_t dma_descriptors;       // per framebuffer
+    size_t dma_descriptor_bytes;  // per framebuffer, always internal DMA capable RAM
+    size_t total_bytes;
+  };
+
+  static memory_report_t getMemoryReport(const HUB75_I2S_CFG &cfg);
+  static void printMemoryReport(const HUB75_I2S_CFG &cfg);
+
+  /**
+   * @brief - set a function to be called at the end of every frame sent to the panel, or nullptr to remove it.
+   * It is called from the end of frame interrupt, so it must be IRAM_ATTR, short and only use ...FromISR() FreeRTOS calls.
+   */
+  void setFrameCallback(void (*cb)(void *arg), void *arg = nullptr) { dma_bus.set_frame_callback(cb, arg); }
+
   /**
    * @param uint8_t b - 8-bit brightness value
    */
@@ -656,6 +1187,11 @@ public:
     {
       setBrightnessOE(b, 1);
     }
+
+    if (m_cfg.triple_buff)
+    {
+      setBrightnessOE(b, 2);
+    }
   }
 
   /**
@@ -686,6 +1222,66 @@ public:
    */
   uint8_t setLatBlanking(uint8_t pulses);
 
+  /**
+   * @brief - show just the 'depth' most significant bitplanes of the pixel_color_depth_bits allocated, without reallocating anything.
+   * Fewer bitplanes to send gives a higher refresh rate, or a lower lsbMsbTransitionBit for the same min_refresh_rate. Drawing
+   * is unchanged, as is what was drawn already, so going back to the full colour depth shows it all again straight away.
+   * After begin() only the DMA descriptors are relinked (in newly allocated memory, so the old ones are needed until the end of
+   * the frame being sent) and the output is switched over at the end of a frame, it's not stopped. A crossfadeDMABuffer() under
+   * way jumps to its end, and a triple buffer flip still queued is shown first.
+   * Before begin(), it sets the depth shown from the start.
+   * @param depth - 2 to pixel_color_depth_bits
+   * @returns false if out of range, or there wasn't the memory to relink the DMA descriptors (nothing changes)
+   */
+  bool setColorDepth(uint8_t depth);
+
+  /**
+   * @brief - number of bitplanes shown, see setColorDepth()
+   */
+  uint8_t getColorDepth() const { return active_colour_depth ? active_colour_depth : m_cfg.getPixelColorDepthBits(); }
+
+  /**
+   * @brief - change min_refresh_rate, i.e. the lsbMsbTransitionBit, after begin() as well. Relinks the DMA descriptors like setColorDepth().
+   * calculated_refresh_rate has the refresh rate it gives.
+   * @returns false if there wasn't the memory to relink the DMA descriptors (nothing changes)
+   */
+  bool setMinRefreshRate(uint8_t hz);
+
+  /**
+   * @brief - HUB75_I2S_CFG::hscroll only: scroll everything on the panel 'dx' columns to the left (right if negative), by moving
+   * the column the DMA starts sending each row at rather than by redrawing. The rows wrap around, so the columns scrolled in on one
+   * side are the ones that went out of the other, to be drawn over with whatever comes next (the next column of a ticker...).
+   * Drawing carries on in panel co-ordinates, x = 0 is still the left hand edge. Every buffer scrolls together.
+   * Only the DMA descriptors and the control bits near the ends of the rows and the brightness OE edges are rewritten, straight
+   * after an end of frame so the DMA doesn't send half a scroll. So it blocks until then, which paces a ticker to the refresh rate.
+   * With USE_SHADOW_BUFFER the shadow buffer is scrolled as well, which does take a pass over all of it.
+   * @param dx - columns, in panel (unrotated) co-ordinates, a multiple of HSCROLL_STEP
+   * @returns false if hscroll isn't set, before begin(), or dx isn't a multiple of HSCROLL_STEP
+   */
+  bool scrollHorizontal(int16_t dx);
+
+  /**
+   * @brief - columns scrolled by with scrollHorizontal() in all, 0 to the panel width - 1
+   */
+  uint16_t getScrollX() const { return hscroll_offset; }
+
+  /**
+   * @brief - scroll everything on the panel 'dy' rows up (down if negative), by relinking the DMA descriptors of the rows in a
+   * new order rather than by redrawing. Like scrollHorizontal() the rows wrap around, the rows scrolled in at the bottom are the
+   * ones that went out of the top, to be drawn over. Drawing carries on in panel co-ordinates, every buffer scrolls together.
+   * What it does rewrite are the row address bits of every row, and the colour bits of the rows that cross between the top and
+   * bottom halves of the panel, which swap their RGB1 and RGB2 bits. Blocks until an end of frame to start, like scrollHorizontal().
+   * With USE_SHADOW_BUFFER the shadow buffer is scrolled as well.
+   * @param dy - rows, in panel (unrotated) co-ordinates
+   * @returns false before begin()
+   */
+  bool scrollVertical(int16_t dy);
+
+  /**
+   * @brief - rows scrolled by with scrollVertical() in all, 0 to the panel height - 1
+   */
+  uint16_t getScrollY() const { return vscroll_offset; }
+
   /**
    * Get a class configuration struct
    *
@@ -721,9 +1317,13 @@ public:
   /**
    * Resume DMA output after a stopDMAoutput() call.
    * Note: stopDMAoutput() blanks the framebuffer (brightness is preserved), so redraw after.
+   *       Unless built with USE_SHADOW_BUFFER, in which case the frame is restored from the shadow buffer.
    */
   void resumeDMAoutput()
   {
+#ifdef USE_SHADOW_BUFFER
+    reencode(); // no redraw needed, the shadow buffer still holds the frame
+#endif
     dma_bus.dma_transfer_start();
   }
 
@@ -737,8 +1337,12 @@ protected:
    * so we could set it once on DMA buffs initialization and forget.
    * This effectively clears buffers to blank BLACK and makes it ready to display output.
    * (Brightness control via OE bit manipulation is another case)
+   * With _address_only just the row address bits are rewritten, for when the first bitplane sent changes (setColorDepth())
    */
-  void clearFrameBuffer(bool _buff_id);
+  void clearFrameBuffer(int _buff_id, bool _address_only = false);
+
+  /* clearFrameBuffer() of one frame buffer row, addressed as the DMA row it is sent as (see scrollVertical()) */
+  void clearFrameBufferRow(int _buff_id, int row_idx, bool _address_only);
 
   /* Update a specific pixel in the DMA buffer to a colour */
   void updateMatrixDMABuffer(uint16_t x, uint16_t y, uint8_t red, uint8_t green, uint8_t blue);
@@ -746,6 +1350,42 @@ protected:
   /* Update the entire DMA buffer (aka. The RGB Panel) a certain colour (wipe the screen basically) */
   void updateMatrixDMABuffer(uint8_t red, uint8_t green, uint8_t blue);
 
+  /* Update a run of 'len' pixels of a row in the DMA buffer from either RGB888 or RGB565 source data.
+   * Co-ordinates must already be clipped to the panel. Exactly one of the source pointers is used. */
+  void updateMatrixDMABufferRow(uint16_t x_coord, uint16_t y_coord, uint16_t len, const uint8_t *rgb888, const uint16_t *rgb565);
+
+  /* Update a run of 'len' pixels of both halves of a DMA row (matrix row 'row' and 'row' + ROWS_PER_FRAME) from RGB888 source data.
+   * Either source pointer may be nullptr, in which case the colour bits of that half are left untouched. */
+  void updateMatrixDMABufferRowPair(uint16_t x_coord, uint16_t row, uint16_t len, const uint8_t *upper, const uint8_t *lower);
+
+  /* An 8 bit colour value that brightness compensates to 'val', i.e. the inverse of DO_BRIGHTNESS_COMPENSATION() */
+  uint8_t uncompensate(uint16_t val) const;
+
+  /* Encode w x h pixels of RGB888 or RGB565 source data into 'sprite', exactly one of the source pointers is used */
+  bool encodeSpritePixels(BitplaneSprite &sprite, const uint8_t *rgb888, const uint16_t *rgb565, int16_t w, int16_t h, int32_t transparent);
+
+  /* The colour of pixel sx, sy of a sprite, as getPixelRGB() would read it back once drawn. false if it's transparent */
+  bool getSpritePixelRGB(const BitplaneSprite &sprite, int16_t sx, int16_t sy, uint8_t &r, uint8_t &g, uint8_t &b) const;
+
+  /* DMA row column holding pixel x, the rows being rings starting at hscroll_offset (0 unless HUB75_I2S_CFG::hscroll) */
+  inline uint16_t hscrollColumn(uint16_t x) const
+  {
+    x += hscroll_offset;
+    return (x >= PIXELS_PER_ROW) ? x - PIXELS_PER_ROW : x;
+  }
+
+  /* Frame buffer row sent as DMA row 'row' (0 to ROWS_PER_FRAME - 1), the rows being a ring starting at vscroll_row */
+  inline uint16_t vscrollRow(uint16_t row) const
+  {
+    row += vscroll_row;
+    return (row >= ROWS_PER_FRAME) ? row - ROWS_PER_FRAME : row;
+  }
+
+#ifdef USE_BITPLANE_LUT
+  /* Fill bitplane_lut[][] for the current colour depth and brightness compensation mode */
+  void buildBitplaneLUT();
+#endif
+
   /**
    * wipes DMA buffer(s) and reset all colour/service bits
    */
@@ -760,6 +1400,40 @@ protected:
       setBrightnessOE(brightness, 1);
 
     }
+
+    if (m_cfg.triple_buff) {
+
+      clearFrameBuffer(2);        
+      setBrightnessOE(brightness, 2);
+
+    }
+  }
+
+  /**
+   * Triple buffer: a buffer that is neither being sent, nor linked in next, nor queued.
+   * If there isn't one (two frames in flight already), waits for the end of the frame being sent, which frees its buffer.
+   */
+  inline int getTripleBufferDrawId()
+  {
+    int8_t current, next, queued;
+    dma_bus.get_dma_output_buffers(current, next, queued);
+
+    if (queued >= 0 && next != current)
+    {
+      uint32_t timeout_ms = (calculated_refresh_rate > 0 ? 2000 / calculated_refresh_rate : 0) + 10;
+      if (!dma_bus.wait_frames_sent(dma_bus.get_frames_sent() + 1, timeout_ms))
+        ESP_LOGW("getTripleBufferDrawId()", "Timed out waiting for the DMA to finish a frame, drawing into the one on the panel.");
+
+      dma_bus.get_dma_output_buffers(current, next, queued);
+    }
+
+    for (int id = 0; id < 3; id++)
+    {
+      if (id != current && id != next && id != queued)
+        return id;
+    }
+
+    return current;
   }
 
 #ifndef NO_FAST_FUNCTIONS
@@ -793,11 +1467,117 @@ protected:
   void fillRectDMA(int16_t x_coord, int16_t y_coord, int16_t w, int16_t h, uint8_t r, uint8_t g, uint8_t b);
 #endif
 
+#ifdef USE_DIRTY_TRACKING
+  /**
+   * @brief - copy the colour bits of everything drawn since the back buffer was last drawn to, from the buffer just flipped to the front
+   * Run by finishBackBufferSync() after a flip, so the back buffer always starts off holding the frame just flipped and only the changes need drawing.
+   * @param int front_id - the buffer that was just flipped (or queued) to be displayed
+   */
+  void syncBackBuffer(int front_id);
+
+  /* The syncBackBuffer() a flip leaves until the back buffer is off the panel, or until it's drawn to or read from anyway */
+  inline void finishBackBufferSync()
+  {
+    if (back_buffer_sync_from >= 0)
+    {
+      syncBackBuffer(back_buffer_sync_from);
+      back_buffer_sync_from = -1;
+    }
+  }
+#endif
+
+#ifdef USE_SHADOW_BUFFER
+  /* Allocates the (zeroed, i.e. black) shadow buffer, from PSRAM if there is any */
+  bool allocateShadowBuffer();
+
+  /* Encode the shadow buffer, or just its dirty row spans, into the DMA buffer */
+  void encodeShadowBuffer(bool dirty_only);
+
+  /* Shadow buffer pixel at x,y in panel co-ordinates */
+  inline uint8_t *shadowPtr(uint16_t x, uint16_t y) const { return shadow_buff + ((size_t)y * PIXELS_PER_ROW + x) * SHADOW_BYTES_PER_PIXEL; }
+
+  static inline void shadowSet(uint8_t *p, uint8_t r, uint8_t g, uint8_t b)
+  {
+#if SHADOW_BYTES_PER_PIXEL == 2
+    uint16_t c = color565(r, g, b);
+    p[0] = c & 0xff;
+    p[1] = c >> 8;
+#else
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+#endif
+  }
+
+  static inline void shadowGet(const uint8_t *p, uint8_t &r, uint8_t &g, uint8_t &b)
+  {
+#if SHADOW_BYTES_PER_PIXEL == 2
+    color565to888(p[0] | (p[1] << 8), r, g, b);
+#else
+    r = p[0];
+    g = p[1];
+    b = p[2];
+#endif
+  }
+
+  /* Fill a w x h rectangle of the shadow buffer (already clipped to the panel) with one colour.
+   * @returns true if encoding is deferred, i.e. the caller should leave the DMA buffer alone */
+  bool shadowFill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t r, uint8_t g, uint8_t b);
+
+  /* Store a run of 'len' pixels of row y from RGB888 or RGB565 source data. Same return as shadowFill() */
+  bool shadowStoreRow(uint16_t x, uint16_t y, uint16_t len, const uint8_t *rgb888, const uint16_t *rgb565);
+
+  /* fadeFrame() / dimFrame() of the shadow buffer: each colour brightness compensated, times 'numerator' >> 'shift', and back */
+  void shadowScale(uint16_t numerator, uint8_t shift);
+
+  /* copyRect() of the shadow buffer, already clipped. Same return as shadowFill() */
+  bool shadowCopyRect(uint16_t src_x, uint16_t src_y, uint16_t w, uint16_t h, uint16_t dst_x, uint16_t dst_y);
+
+  /* drawSprite() of the w x h pixels of 'sprite' from sx, sy to x, y, already clipped. Same return as shadowFill() */
+  bool shadowStoreSprite(const BitplaneSprite &sprite, uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t x, uint16_t y);
+#endif
+
   // ------- PRIVATE -------
 private:
 
   /* Setup the DMA Link List chain and configure the ESP32 DMA + I2S or LCD peripheral */
-  bool setupDMA(const HUB75_I2S_CFG &opts);
+  bool setupDMA();
+
+#if defined(SPIRAM_DMA_BUFFER)
+  /* Number of bitplanes per row that fit in internal SRAM for cfg.psram_placement, leaving PSRAM_PLACEMENT_SRAM_RESERVE free */
+  static uint8_t calculateSramPlanes(const HUB75_I2S_CFG &cfg);
+#endif
+
+  /* DMA descriptors per row to send the active_colour_depth most significant bitplanes with the current lsbMsbTransitionBit */
+  int activeDMADescriptorsPerRow();
+
+  /* Link the DMA descriptors of the framebuffers, to send the active_colour_depth most significant bitplanes of every row */
+  void linkDMADescriptors(int fbs_required);
+
+  /* Link (or with 'update', repoint) the DMA descriptors of DMA row 'row' of a buffer, to send frame buffer row vscrollRow(row).
+   * @returns the descriptors it took */
+  int linkDMARow(int _buff_id, int row, bool update);
+
+  /* setColorDepth() / setMinRefreshRate() after begin() */
+  bool relinkDMA(uint8_t depth, uint8_t min_refresh_rate);
+
+  /* HUB75_I2S_CFG::hscroll: link (or with 'update', repoint) the DMA descriptors of a row of a buffer. Every pass over a bitplane
+   * is two descriptors, from hscroll_offset to the end of the row, then from the start of the row round to hscroll_offset. */
+  void linkHScrollRow(int _buff_id, int row, bool update);
+
+  /* Move the control bits of a bitplane of a row that change when scrollHorizontal() moves the start of the rows on from 'offset'
+   * by 'step' columns, for a bitplane with its output enabled for [oe_min, oe_max) */
+  void hscrollControlBits(ESP32_I2S_DMA_STORAGE_TYPE *plane, uint16_t offset, int step, int oe_min, int oe_max);
+
+  /* Disable the output for all of bitplane _plane of every row */
+  void blankBitplane(int _buff_id, uint8_t _plane);
+
+  /* Lowest lsbMsbTransitionBit that gives cfg.min_refresh_rate (or the highest possible), and the refresh rate it gives */
+  static int calculateLsbMsbTransitionBit(const HUB75_I2S_CFG &cfg, int &refresh_rate, bool log = false);
+
+  /* DMA descriptors needed to send one row: all bitplanes once, then the planes above the transition bit repeated for their BCM weight.
+   * split_plane is rowBitStruct::split when the bitplanes are in two runs (see HUB75_I2S_CFG::psram_placement) */
+  static int calculateDMADescriptorsPerRow(size_t row_bytes_1cdepth, uint8_t colour_depth, int transition_bit, uint8_t split_plane = 0);
 
   /**
    * pre-init procedures for specific drivers
@@ -829,6 +1609,10 @@ private:
    */
   void setBrightnessOE(uint8_t brt, const int _buff_id = 0);
 
+  /* Columns [x_min, x_max) setBrightnessOE() enables the output for, in bitplane 'colouridx' counted from the first one sent */
+  void brightnessOERange(uint8_t brt, uint8_t colouridx, int &x_min, int &x_max) const;
+
+protected:
   /**
    * @brief - transforms coordinates according to orientation
    * @param x - x position origin
@@ -863,6 +1647,11 @@ private:
       w = t;
       return;
     }
+#else
+    (void)x; // no rotation without GFX
+    (void)y;
+    (void)w;
+    (void)h;
 #endif
   };
 
@@ -876,24 +1665,52 @@ public:
 protected:
   Bus_Parallel16 dma_bus;
 
-private:
-
   // Matrix i2s settings
   HUB75_I2S_CFG m_cfg;
 
   /* Pixel data is organized from LSB to MSB sequentially by row, from row 0 to row matrixHeight/matrixRowsInParallel
    * (two rows of pixels are refreshed in parallel)
-   * Memory is allocated (malloc'd) by the row, and not in one massive chunk, for flexibility.
-   * The whole DMA framebuffer is just a vector of pointers to structs with ESP32_I2S_DMA_STORAGE_TYPE arrays
+   * Memory is allocated in one chunk per frame buffer, or a few chunks of whole rows if the heap is fragmented (see frameStruct::allocate()).
+   * The whole DMA framebuffer is just a vector of row structs pointing into that memory
    * Since it's dimensions is unknown prior to class initialization, we just declare it here as empty struct and will do all allocations later.
    * Refer to rowBitStruct to get the idea of it's internal structure
    */
-  frameStruct frame_buffer[2];
-  frameStruct *fb; // What framebuffer we are writing pixel changes to? (pointer to either frame_buffer[0] or frame_buffer[1] basically ) used within updateMatrixDMABuffer(...)
+  frameStruct frame_buffer[3];
+  frameStruct *fb; // What framebuffer we are writing pixel changes to? (pointer to frame_buffer[0], [1] or with triple_buff [2]) used within updateMatrixDMABuffer(...)
 
+#ifdef USE_BITPLANE_LUT
+  /* Per channel (R,G,B) tables mapping an 8 bit colour value straight to its brightness compensated bits in every bitplane.
+   * A pixel is then encoded as three table loads OR'ed together, and the 3 RGB bits for a plane are just a shift away.
+   */
+  bitplane_lut_t bitplane_lut[3][256];
+#endif
+
+  bool initialized = false;
+
+#ifdef USE_SHADOW_BUFFER
+  uint8_t *shadow_buff = nullptr;    // last colour drawn to every pixel, PIXELS_PER_ROW x mx_height in panel (unrotated) co-ordinates
+  std::vector<rowSpan> shadow_dirty; // per DMA row, what was drawn into the shadow buffer and not encoded yet (both halves)
+  bool shadow_deferred = false;      // see setDeferredEncode()
+#endif
+
+#ifdef USE_STATS
+  uint32_t stats_flips_requested = 0;
+  uint64_t stats_pixels = 0;           // encoded since resetStats()
+  uint64_t stats_encode_ticks = 0;     // CPU cycles (host: nanoseconds) spent encoding them, see STATS_ENCODE()
+#endif
+
+private:
   volatile int back_buffer_id = 0;      // If using double buffer, which one is NOT active (ie. being displayed) to write too?
+  uint32_t back_buffer_free_frame = 0;  // dma_bus.get_frames_sent() value from which the back buffer is no longer being sent out
+#ifdef USE_DIRTY_TRACKING
+  int8_t back_buffer_sync_from = -1;    // front buffer the last flip is to syncBackBuffer() from, -1 for none
+#endif
   int brightness = 128;        // If you get ghosting... reduce brightness level. ((60/64)*255) seems to be the limit before ghosting on a 64 pixel wide physical panel for some panels.
   int lsbMsbTransitionBit = 0; // For colour depth calculations
+  uint8_t active_colour_depth = 0; // Most significant bitplanes sent, see setColorDepth(). 0 is all of them
+  uint16_t hscroll_offset = 0;     // column the DMA starts sending each row at, see scrollHorizontal()
+  uint16_t vscroll_offset = 0;     // panel rows scrolled up by, see scrollVertical()
+  uint8_t vscroll_row = 0;         // frame buffer row sent first, vscroll_offset % ROWS_PER_FRAME
 
   /* ESP32-HUB75-MatrixPanel-I2S-DMA functioning constants
    * we should not those once object instance initialized it's DMA structs
@@ -905,7 +1722,6 @@ private:
   uint8_t MASK_OFFSET = 16 - m_cfg.getPixelColorDepthBits();
 
   // Other private variables
-  bool initialized = false;
   bool config_set = false;
 
 }; // end Class header
@@ -0,0 +1,225 @@
+/**
+ * @file ESP32-HUB75-MatrixPanel_T.hpp
+ * @brief TEMPLATED MatrixPanel_I2S_DMA with a compile-time panel geometry. Hence the '_T'.
+ *
+ * MatrixPanel_I2S_DMA keeps the panel width, chain length, rows per frame and colour depth
+ * in runtime members, so the pixel drawing code has to reload them for every pixel and
+ * can't unroll the colour depth (bitplane) loop.
+ *
+ * Most builds drive one fixed panel setup though. MatrixPanel_T takes that setup as
+ * template parameters, so drawPixel() / drawPixelRGB888() are compiled with the geometry
+ * as constants and one straight run of stores per bitplane. Everything else (DMA setup,
+ * Bus_Parallel16 backend, double buffering, brightness, the fast line functions etc.)
+ * is the regular MatrixPanel_I2S_DMA.
+ *
+ * @tparam PanelWidth   Width of a single panel module in pixels.
+ * @tparam PanelHeight  Height of a single panel module in pixels.
+ * @tparam ChainLength  Number of panel modules chained together.
+ * @tparam ColorDepth   Colour depth (bitplanes) per colour.
+ *                      Must match PIXEL_COLOR_DEPTH_BITS unless NO_CIE1931 is used,
+ *                      as the CIE1931 lookup table is selected at compile time.
+ *
+ * Example:
+ *   MatrixPanel_T<64, 32, 2> *dma_display = new MatrixPanel_T<64, 32, 2>(mxconfig);
+ *   dma_display->begin();
+ *
+ * @note Any width/height/chain/colour depth in the HUB75_I2S_CFG passed in is overwritten
+ *       with the template parameters.
+ */
+
+#ifndef MATRIX_PANEL_TEMPLATE_H
+#define MATRIX_PANEL_TEMPLATE_H
+
+#include <utility>
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+
+template <uint16_t PanelWidth, uint16_t PanelHeight, uint16_t ChainLength = 1, uint8_t ColorDepth = PIXEL_COLOR_DEPTH_BITS_DEFAULT>
+class MatrixPanel_T : public MatrixPanel_I2S_DMA
+{
+	static_assert(PanelWidth > 0 && ChainLength > 0, "Panel width and chain length must be at least 1");
+	static_assert(PanelHeight > 0 && (PanelHeight % MATRIX_ROWS_IN_PARALLEL) == 0, "Panel height must be an even number");
+	static_assert(ColorDepth >= 2 && ColorDepth <= PIXEL_COLOR_DEPTH_BITS_MAX, "ColorDepth must be between 2 and PIXEL_COLOR_DEPTH_BITS_MAX");
+#ifndef NO_CIE1931
+	static_assert(ColorDepth == PIXEL_COLOR_DEPTH_BITS, "ColorDepth must match PIXEL_COLOR_DEPTH_BITS, as that selects the CIE1931 lookup table");
+#endif
+
+public:
+	static constexpr uint16_t PIXELS_PER_ROW_T = PanelWidth * ChainLength;                 // width of the whole chain
+	static constexpr uint16_t ROWS_PER_FRAME_T = PanelHeight / MATRIX_ROWS_IN_PARALLEL;    // rows per DMA frame
+
+	MatrixPanel_T(const HUB75_I2S_CFG &opts = HUB75_I2S_CFG()) : MatrixPanel_I2S_DMA(specialise(opts)) {}
+
+	/**
+	 * @brief Returns a copy of the config with the geometry and colour depth set to the template parameters.
+	 */
+	static HUB75_I2S_CFG specialise(HUB75_I2S_CFG opts)
+	{
+		opts.mx_width = PanelWidth;
+		opts.mx_height = PanelHeight;
+		opts.chain_length = ChainLength;
+		opts.setPixelColorDepthBits(ColorDepth);
+		return opts;
+	}
+
+	using MatrixPanel_I2S_DMA::begin;
+
+	bool begin()
+	{
+		if (m_cfg.mx_width != PanelWidth || m_cfg.mx_height != PanelHeight || m_cfg.chain_length != ChainLength || m_cfg.getPixelColorDepthBits() != ColorDepth)
+		{
+			ESP_LOGE("MatrixPanel_T", "Config does not match the template parameters, use MatrixPanel_T::specialise() on it!");
+			return false;
+		}
+
+		return MatrixPanel_I2S_DMA::begin();
+	}
+
+	bool begin(const HUB75_I2S_CFG &cfg)
+	{
+		if (initialized)
+			return true;
+
+		if (!setCfg(specialise(cfg)))
+			return false;
+
+		return begin();
+	}
+
+	using MatrixPanel_I2S_DMA::drawPixel;
+
+	virtual void drawPixel(int16_t x, int16_t y, uint16_t color) override
+	{
+		uint8_t r, g, b;
+		color565to888(color, r, g, b);
+		drawPixelRGB888(x, y, r, g, b);
+	}
+
+	inline void drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b)
+	{
+		int16_t w = 1, h = 1;
+		transform(x, y, w, h);
+		updatePixel(x, y, r, g, b);
+	}
+
+#ifdef USE_GFX_LITE
+	inline void drawPixel(int16_t x, int16_t y, CRGB color)
+	{
+		drawPixelRGB888(x, y, color.red, color.green, color.blue);
+	}
+#endif
+
+protected:
+#ifdef USE_BITPLANE_LUT
+	typedef bitplane_lut_t encoded_t;
+#else
+	struct encoded_t
+	{
+		uint16_t red_val, green_val, blue_val;
+	};
+#endif
+
+	/* LED brightness compensation, same as DO_BRIGHTNESS_COMPENSATION() with the colour depth as a constant */
+	static inline uint16_t brightnessCompensate(uint8_t v)
+	{
+#ifndef NO_CIE1931
+		return lumConvTab[v];
+#else
+		constexpr uint8_t shift_amount = 16 - ColorDepth;
+		constexpr uint16_t rounding = (1 << (shift_amount - 1)) - 1;
+		constexpr uint16_t max_val = (1 << ColorDepth) - 1;
+		uint16_t val = ((uint16_t)(v * 256u) + rounding) >> shift_amount;
+		return val > max_val ? max_val : val;
+#endif
+	}
+
+	inline encoded_t encode(uint8_t red, uint8_t green, uint8_t blue) const
+	{
+#ifdef USE_BITPLANE_LUT
+		return bitplane_lut[0][red] | bitplane_lut[1][green] | bitplane_lut[2][blue];
+#else
+		return encoded_t{brightnessCompensate(red), brightnessCompensate(green), brightnessCompensate(blue)};
+#endif
+	}
+
+	/* B,G,R bits of bitplane 'Plane' in the R1G1B1 position */
+	template <uint8_t Plane>
+	static inline uint16_t planeBits(const encoded_t &c)
+	{
+#ifdef USE_BITPLANE_LUT
+		return (uint16_t)(c >> (3 * Plane)) & 0x7;
+#else
+		return (((c.blue_val >> Plane) & 1) << 2) | (((c.green_val >> Plane) & 1) << 1) | ((c.red_val >> Plane) & 1);
+#endif
+	}
+
+#if defined(SPIRAM_DMA_BUFFER)
+	/* One read-modify-write per bitplane, unrolled at compile time. The bitplanes may be split over SRAM and PSRAM,
+	 * see HUB75_I2S_CFG::psram_placement, so each one is looked up in the row */
+	template <uint8_t... Planes>
+	static inline void writePlanes(rowBitStruct &row, int16_t x, uint16_t _colourbitclear, uint8_t _colourbitoffset, const encoded_t &c, std::integer_sequence<uint8_t, Planes...>)
+	{
+		((row.getDataPtr(Planes)[x] = (row.getDataPtr(Planes)[x] & _colourbitclear) | (planeBits<Planes>(c) << _colourbitoffset)), ...);
+	}
+#else
+	/* One read-modify-write per bitplane, unrolled at compile time. The bitplanes of a row are contiguous */
+	template <uint8_t... Planes>
+	static inline void writePlanes(rowBitStruct &row, int16_t x, uint16_t _colourbitclear, uint8_t _colourbitoffset, const encoded_t &c, std::integer_sequence<uint8_t, Planes...>)
+	{
+		ESP32_I2S_DMA_STORAGE_TYPE *p = &row.data[x];
+		((p[Planes * PIXELS_PER_ROW_T] = (p[Planes * PIXELS_PER_ROW_T] & _colourbitclear) | (planeBits<Planes>(c) << _colourbitoffset)), ...);
+	}
+#endif
+
+	/* Same as MatrixPanel_I2S_DMA::updateMatrixDMABuffer(x, y, r, g, b) */
+	inline void updatePixel(int16_t x_coord, int16_t y_coord, uint8_t red, uint8_t green, uint8_t blue)
+	{
+		if (!initialized)
+			return;
+
+		if ((uint16_t)x_coord >= PIXELS_PER_ROW_T || (uint16_t)y_coord >= PanelHeight)
+			return;
+
+#ifdef USE_DIRTY_TRACKING
+		finishBackBufferSync(); // see flipDMABuffer()
+#endif
+
+#ifdef USE_SHADOW_BUFFER
+		if (shadowFill(x_coord, y_coord, 1, 1, red, green, blue))
+			return;
+#endif
+
+		STATS_ENCODE(1);
+
+		uint16_t _colourbitclear = BITMASK_RGB1_CLEAR;
+		uint8_t _colourbitoffset = 0;
+
+		if (y_coord >= ROWS_PER_FRAME_T)
+		{ // if we are drawing to the bottom part of the panel
+			_colourbitoffset = BITS_RGB2_OFFSET;
+			_colourbitclear = BITMASK_RGB2_CLEAR;
+			y_coord -= ROWS_PER_FRAME_T;
+		}
+
+		x_coord = hscrollColumn(x_coord); // see scrollHorizontal()
+		y_coord = vscrollRow(y_coord);    // and scrollVertical()
+
+#ifdef USE_DIRTY_TRACKING
+		fb->markDirty(y_coord, x_coord, x_coord + 1);
+#endif
+
+#if defined(ESP32_THE_ORIG)
+		// Account for the I2S Tx FIFO mode1 ordering, swaps the even/odd pixel
+		x_coord ^= 1;
+#endif
+
+		writePlanes(fb->rowBits[y_coord], x_coord, _colourbitclear, _colourbitoffset, encode(red, green, blue), std::make_integer_sequence<uint8_t, ColorDepth>{});
+
+#if defined(SPIRAM_DMA_BUFFER)
+		fb->unflushed[y_coord].merge(x_coord, x_coord + 1);
+		if (!m_cfg.double_buff)
+			commit();
+#endif
+	}
+};
+
+#endif
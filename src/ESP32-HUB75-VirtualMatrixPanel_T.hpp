@@ -213,13 +213,13 @@ public:
 		panel_res_x(_panel_res_x),
 		panel_res_y(_panel_res_y),
 		panel_pixel_base(_panel_res_x), // default pixel base is panel_res_x
-		vmodule_rows(_vmodule_rows),
-		vmodule_cols(_vmodule_cols),
 		virtual_res_x(_vmodule_cols * _panel_res_x),
 		virtual_res_y(_vmodule_rows * _panel_res_y),
-		dma_res_x(_panel_res_x * _vmodule_rows * _vmodule_cols - 1),
 		_virtual_res_x(virtual_res_x),
 		_virtual_res_y(virtual_res_y),
+		vmodule_rows(_vmodule_rows),
+		vmodule_cols(_vmodule_cols),
+		dma_res_x(_panel_res_x * _vmodule_rows * _vmodule_cols - 1),
 		_rotate(0)
 	{
 		// Initialize with an invalid coordinate.
@@ -331,7 +331,8 @@ public:
 	inline uint16_t color444(uint8_t r, uint8_t g, uint8_t b) { return display->color444(r, g, b); }
 	inline uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return display->color565(r, g, b); }
 
-	inline void flipDMABuffer() { display->flipDMABuffer(); }
+	inline void flipDMABuffer(bool wait = false) { display->flipDMABuffer(wait); }
+	inline bool isBackBufferFree() const { return display->isBackBufferFree(); }
 
 	// ------------------------------------------------------------------
 	// Rotation (runtime)
@@ -145,7 +145,8 @@ public:
     uint16_t color444(uint8_t r, uint8_t g, uint8_t b) { return display->color444(r, g, b); }
     uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return display->color565(r, g, b); }
 
-    void flipDMABuffer() { display->flipDMABuffer(); }
+    void flipDMABuffer(bool wait = false) { display->flipDMABuffer(wait); }
+    bool isBackBufferFree() const { return display->isBackBufferFree(); }
     void drawDisplayTest();
 
     void setPhysicalPanelScanRate(PANEL_SCAN_RATE rate);
@@ -0,0 +1,306 @@
+/**
+ * @file HUB75Planner.hpp
+ * @brief Refresh rate / memory / colour depth planner for a panel setup, without the hardware.
+ *
+ * MatrixPanel_I2S_DMA::begin() works out the lsbMsbTransitionBit (how many of the least significant
+ * bitplanes are shown for the same time as the next one up, to reach min_refresh_rate), the refresh rate
+ * that gives, and the framebuffer and DMA descriptor memory required. It uses HUB75Planner for all of that,
+ * so the same numbers can be had beforehand, or on the host when sizing the hardware for an install.
+ *
+ * Header only, and needs nothing but the C++ standard library. plan() takes a HUB75_I2S_CFG,
+ * or a HUB75Planner::Config on the host.
+ *
+ * Example:
+ *   HUB75Planner::plan_t p = HUB75Planner::plan(mxconfig);
+ *   // p.refresh_rate, p.effective_colour_depth, p.total_bytes ...
+ *
+ *   HUB75Planner::plan_t best;
+ *   if (HUB75Planner::best(mxconfig, 120 * 1024, best))
+ *     mxconfig.setPixelColorDepthBits(best.colour_depth);
+ *
+ * Refer to tools/hub75_planner.cpp for a command line version.
+ *
+ * @note plan(cfg) plans what begin() sets up for the config: two descriptors per bitplane pass with hscroll, and with
+ *       SPIRAM_DMA_BUFFER the HZ_8M clock begin() forces and room for the bitplanes to be split over SRAM and PSRAM
+ *       (psram_placement). Built with FORCE_COLOR_DEPTH the transition bit is always 0, as in begin().
+ */
+
+#ifndef HUB75_PLANNER_HPP
+#define HUB75_PLANNER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct HUB75Planner
+{
+  static constexpr uint8_t ROWS_IN_PARALLEL = 2; // MATRIX_ROWS_IN_PARALLEL
+  static constexpr uint8_t MIN_COLOUR_DEPTH = 2;
+  static constexpr uint8_t MAX_COLOUR_DEPTH = 12; // PIXEL_COLOR_DEPTH_BITS_MAX
+
+  static constexpr size_t DEFAULT_DMA_MAX = 4096 - 4;       // DMA_MAX of every platform backend
+  static constexpr size_t DEFAULT_DESCRIPTOR_BYTES = 12;    // sizeof lldesc_t / dma_descriptor_t
+
+  /* The distinct output clocks of HUB75_I2S_CFG::clk_speed */
+  static constexpr uint8_t NUM_CLOCK_OPTIONS = 3;
+  static uint32_t clockOption(uint8_t i)
+  {
+    static const uint32_t clocks[NUM_CLOCK_OPTIONS] = {8000000, 16000000, 20000000};
+    return clocks[i];
+  }
+
+  /* The HUB75_I2S_CFG members the planner uses, for the host where there isn't a HUB75_I2S_CFG */
+  struct Config
+  {
+    uint16_t mx_width = 64;
+    uint16_t mx_height = 32;
+    uint16_t chain_length = 1;
+    bool double_buff = false;
+    bool triple_buff = false;
+    uint32_t i2sspeed = 8000000;
+    uint16_t min_refresh_rate = 60;
+    uint8_t pixel_color_depth_bits = 8;
+    uint8_t psram_placement = 0;    // HUB75_I2S_CFG::psram_policy, PSRAM_ALL_PLANES
+    bool hscroll = false;
+    bool spiram_dma_buffer = false; // as if built with SPIRAM_DMA_BUFFER
+
+    uint8_t getPixelColorDepthBits() const { return pixel_color_depth_bits; }
+    void setPixelColorDepthBits(uint8_t bits) { pixel_color_depth_bits = bits; }
+  };
+
+  struct plan_t
+  {
+    uint8_t colour_depth;           // bitplanes
+    uint32_t clock_hz;              // output clock
+    int transition_bit;             // lsbMsbTransitionBit
+    uint8_t effective_colour_depth; // bitplanes shown with their proper BCM weight, colour_depth - transition_bit
+    int refresh_rate;               // whole panel, Hz
+    bool meets_min_refresh_rate;
+
+    uint8_t framebuffers;           // 1, 2 or 3
+    size_t framebuffer_bytes;       // per framebuffer
+    size_t dma_descriptors;         // per framebuffer
+    size_t dma_descriptor_bytes;    // per framebuffer
+    size_t total_bytes;
+  };
+
+  /* Refresh rate of the panel for a transition bit. Same integer arithmetic as begin() has always used,
+   * but in 64 bits so long chains at high colour depths don't overflow. */
+  static int refreshRate(uint32_t pixels_per_row, uint32_t rows_per_frame, uint8_t colour_depth, uint32_t clock_hz, int transition_bit)
+  {
+    int64_t ps_per_clock = 1000000000000LL / clock_hz;
+    int64_t ns_per_latch = ((int64_t)pixels_per_row * ps_per_clock) / 1000; // time per row
+
+    // time to shift out LSBs + LSB-MSB transition bit - this ignores fractions...
+    int64_t ns_per_row = colour_depth * ns_per_latch;
+
+    // and the time for the remaining bit depths
+    for (int i = transition_bit + 1; i < colour_depth; i++)
+      ns_per_row += (1LL << (i - transition_bit - 1)) * ns_per_latch;
+
+    int64_t ns_per_frame = ns_per_row * rows_per_frame;
+
+    return (ns_per_frame > 0) ? (int)(1000000000LL / ns_per_frame) : 0;
+  }
+
+  /* Lowest transition bit that reaches min_refresh_rate, or the highest possible one if none do */
+  static int transitionBit(uint32_t pixels_per_row, uint32_t rows_per_frame, uint8_t colour_depth, uint32_t clock_hz, int min_refresh_rate, int &refresh_rate)
+  {
+    int transition_bit = 0;
+
+    while (1)
+    {
+      refresh_rate = refreshRate(pixels_per_row, rows_per_frame, colour_depth, clock_hz, transition_bit);
+
+      if (refresh_rate >= min_refresh_rate || transition_bit >= colour_depth - 1)
+        return transition_bit;
+
+      transition_bit++;
+    }
+  }
+
+  /* DMA descriptors needed to send one row: all bitplanes once, then the planes above the transition bit repeated for their BCM weight.
+   * split_plane is rowBitStruct::split when the bitplanes are in two runs (see HUB75_I2S_CFG::psram_placement) */
+  static int descriptorsPerRow(size_t row_bytes_1cdepth, uint8_t colour_depth, int transition_bit, uint8_t split_plane = 0, size_t dma_max = DEFAULT_DMA_MAX)
+  {
+    int dma_descs_per_row_1cdepth     = (row_bytes_1cdepth + dma_max - 1) / dma_max;
+    int dma_descs_per_row_all_cdepths = (row_bytes_1cdepth * colour_depth + dma_max - 1) / dma_max;
+
+    // bitplanes split over SRAM and PSRAM, the all colour depths pass is linked as two runs
+    if (split_plane > 0 && split_plane < colour_depth)
+      dma_descs_per_row_all_cdepths = (row_bytes_1cdepth * split_plane + dma_max - 1) / dma_max + (row_bytes_1cdepth * (colour_depth - split_plane) + dma_max - 1) / dma_max;
+
+    int dma_descriptors_per_row = dma_descs_per_row_all_cdepths;
+
+    // Add descriptors for MSB bits after transition
+    for (int i = transition_bit + 1; i < colour_depth; i++)
+      dma_descriptors_per_row += (1 << (i - transition_bit - 1)) * dma_descs_per_row_1cdepth;
+
+    return dma_descriptors_per_row;
+  }
+
+  /* descriptorsPerRow() with HUB75_I2S_CFG::hscroll: every pass over a bitplane is two descriptors (a row being at most dma_max bytes) */
+  static int hscrollDescriptorsPerRow(uint8_t colour_depth, int transition_bit)
+  {
+    int passes = colour_depth;
+
+    for (int i = transition_bit + 1; i < colour_depth; i++)
+      passes += 1 << (i - transition_bit - 1);
+
+    return 2 * passes;
+  }
+
+  /**
+   * @brief Plan for a panel setup, colour depth and clock.
+   * @param force_transition_bit use this transition bit rather than the one for min_refresh_rate (-1), i.e. FORCE_COLOR_DEPTH
+   */
+  static plan_t plan(uint32_t pixels_per_row, uint16_t height, uint8_t colour_depth, uint32_t clock_hz, int min_refresh_rate, uint8_t framebuffers,
+                     size_t dma_max = DEFAULT_DMA_MAX, size_t descriptor_bytes = DEFAULT_DESCRIPTOR_BYTES, int force_transition_bit = -1)
+  {
+    const uint32_t rows_per_frame = height / ROWS_IN_PARALLEL;
+    const size_t row_bytes_1cdepth = pixels_per_row * sizeof(uint16_t); // ESP32_I2S_DMA_STORAGE_TYPE
+
+    plan_t p;
+    p.colour_depth = colour_depth;
+    p.clock_hz = clock_hz;
+
+    if (force_transition_bit < 0)
+    {
+      p.transition_bit = transitionBit(pixels_per_row, rows_per_frame, colour_depth, clock_hz, min_refresh_rate, p.refresh_rate);
+    }
+    else
+    {
+      p.transition_bit = force_transition_bit;
+      p.refresh_rate = refreshRate(pixels_per_row, rows_per_frame, colour_depth, clock_hz, force_transition_bit);
+    }
+
+    p.effective_colour_depth = colour_depth - p.transition_bit;
+    p.meets_min_refresh_rate = (p.refresh_rate >= min_refresh_rate);
+
+    p.framebuffers = framebuffers;
+    p.framebuffer_bytes = row_bytes_1cdepth * colour_depth * rows_per_frame;
+    p.dma_descriptors = descriptorsPerRow(row_bytes_1cdepth, colour_depth, p.transition_bit, 0, dma_max) * rows_per_frame;
+    p.dma_descriptor_bytes = p.dma_descriptors * descriptor_bytes;
+    p.total_bytes = framebuffers * (p.framebuffer_bytes + p.dma_descriptor_bytes);
+
+    return p;
+  }
+
+  /* Plan for a HUB75_I2S_CFG (or HUB75Planner::Config) as begin() sets it up, see the note at the top */
+  template <typename CFG>
+  static plan_t plan(const CFG &cfg, size_t dma_max = DEFAULT_DMA_MAX, size_t descriptor_bytes = DEFAULT_DESCRIPTOR_BYTES)
+  {
+    const bool psram = spiramDmaBuffer(cfg);
+    const uint8_t depth = cfg.getPixelColorDepthBits();
+    const uint32_t rows_per_frame = cfg.mx_height / ROWS_IN_PARALLEL;
+
+#if defined(FORCE_COLOR_DEPTH)
+    const int force_transition_bit = 0;
+#else
+    const int force_transition_bit = -1;
+#endif
+
+    plan_t p = plan((uint32_t)cfg.mx_width * cfg.chain_length, cfg.mx_height, depth, psram ? clockOption(0) : (uint32_t)cfg.i2sspeed,
+                    cfg.min_refresh_rate, framebuffers(cfg), dma_max, descriptor_bytes, force_transition_bit);
+
+    if (cfg.hscroll)
+    {
+      // two descriptors per pass over a bitplane, see MatrixPanel_I2S_DMA::linkHScrollRow()
+      p.dma_descriptors = hscrollDescriptorsPerRow(depth, p.transition_bit) * rows_per_frame;
+    }
+    else if (psram && cfg.psram_placement != 0)
+    {
+      // how many bitplanes fit in SRAM is only known at begin(), so allow for the split that takes the most descriptors
+      const size_t row_bytes_1cdepth = (size_t)cfg.mx_width * cfg.chain_length * sizeof(uint16_t);
+      for (uint8_t split = 1; split < depth; split++)
+      {
+        size_t descriptors = descriptorsPerRow(row_bytes_1cdepth, depth, p.transition_bit, split, dma_max) * rows_per_frame;
+        if (descriptors > p.dma_descriptors)
+          p.dma_descriptors = descriptors;
+      }
+    }
+
+    p.dma_descriptor_bytes = p.dma_descriptors * descriptor_bytes;
+    p.total_bytes = p.framebuffers * (p.framebuffer_bytes + p.dma_descriptor_bytes);
+
+    return p;
+  }
+
+  /* Plans for every colour depth and clock option (just HZ_8M with SPIRAM_DMA_BUFFER), for the rest of the config as it is */
+  template <typename CFG>
+  static std::vector<plan_t> planAll(const CFG &cfg, size_t dma_max = DEFAULT_DMA_MAX, size_t descriptor_bytes = DEFAULT_DESCRIPTOR_BYTES)
+  {
+    std::vector<plan_t> plans;
+    CFG c = cfg;
+
+    for (uint8_t depth = MIN_COLOUR_DEPTH; depth <= MAX_COLOUR_DEPTH; depth++)
+      for (uint8_t i = 0; i < (spiramDmaBuffer(cfg) ? 1 : NUM_CLOCK_OPTIONS); i++)
+      {
+        c.setPixelColorDepthBits(depth);
+        c.i2sspeed = (decltype(c.i2sspeed))clockOption(i);
+        plans.push_back(plan(c, dma_max, descriptor_bytes));
+      }
+
+    return plans;
+  }
+
+  /**
+   * @brief Best colour depth and clock for the config within 'ram_budget' bytes.
+   * Prefers plans that reach min_refresh_rate (or else the highest refresh rate), then the highest effective
+   * colour depth, then the fewest bytes, then the slowest clock (the least demanding on the wiring).
+   * @returns false if not even the smallest plan fits
+   */
+  template <typename CFG>
+  static bool best(const CFG &cfg, size_t ram_budget, plan_t &result, size_t dma_max = DEFAULT_DMA_MAX, size_t descriptor_bytes = DEFAULT_DESCRIPTOR_BYTES)
+  {
+    bool found = false;
+
+    for (const plan_t &p : planAll(cfg, dma_max, descriptor_bytes))
+    {
+      if (p.total_bytes > ram_budget)
+        continue;
+
+      if (!found || better(p, result))
+        result = p;
+
+      found = true;
+    }
+
+    return found;
+  }
+
+  /* true if plan 'a' is preferable to 'b', see best() */
+  static bool better(const plan_t &a, const plan_t &b)
+  {
+    if (a.meets_min_refresh_rate != b.meets_min_refresh_rate)
+      return a.meets_min_refresh_rate;
+    if (!a.meets_min_refresh_rate && a.refresh_rate != b.refresh_rate)
+      return a.refresh_rate > b.refresh_rate; // neither does, get as close as possible
+    if (a.effective_colour_depth != b.effective_colour_depth)
+      return a.effective_colour_depth > b.effective_colour_depth;
+    if (a.total_bytes != b.total_bytes)
+      return a.total_bytes < b.total_bytes;
+    return a.clock_hz < b.clock_hz;
+  }
+
+  template <typename CFG>
+  static uint8_t framebuffers(const CFG &cfg)
+  {
+    return (cfg.triple_buff) ? 3 : (cfg.double_buff) ? 2 : 1;
+  }
+
+  /* Are the bitplanes in PSRAM? For a HUB75_I2S_CFG that's the SPIRAM_DMA_BUFFER build flag */
+  template <typename CFG>
+  static bool spiramDmaBuffer(const CFG &)
+  {
+#if defined(SPIRAM_DMA_BUFFER)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static bool spiramDmaBuffer(const Config &cfg) { return cfg.spiram_dma_buffer; }
+};
+
+#endif
@@ -46,30 +46,68 @@ Modified heavily for the ESP32 HUB75 DMA library by:
 
 #include <esp_err.h>
 #include <esp_log.h>
+#include <freertos/task.h>
 
 // Get CPU freq function.
 #include <soc/rtc.h>
 
-/*
+	// EOF of the last descriptor in the chain, i.e. a complete frame has been sent to the panel.
+	// Level 1 / IRAM: it only counts frames, gives the semaphore to a task waiting in wait_frames_sent()
+	// and calls the user callback.
+	void IRAM_ATTR Bus_Parallel16::i2s_isr(void* arg)
+	{
+		Bus_Parallel16 *bus = (Bus_Parallel16 *)arg;
 
-	volatile bool previousBufferFree = true;
+		// Clear flag so we can get retriggered
+		bus->_dev->int_clr.out_eof = 1;
 
-	static void IRAM_ATTR i2s_isr(void* arg) {
+		bus->_frames_sent = bus->_frames_sent + 1;
 
-		// From original Sprite_TM Code
-		//REG_WRITE(I2S_INT_CLR_REG(1), (REG_READ(I2S_INT_RAW_REG(1)) & 0xffffffc0) | 0x3f);
-		
-		// Clear flag so we can get retriggered
-		SET_PERI_REG_BITS(I2S_INT_CLR_REG(ESP32_I2S_DEVICE), I2S_OUT_EOF_INT_CLR_V, 1, I2S_OUT_EOF_INT_CLR_S);                      
-		
-		// at this point, the previously active buffer is free, go ahead and write to it
-		previousBufferFree = true;
-	}
+		// Triple buffering: the DMA has just started on the buffer the last descriptor was linked to, and is
+		// nowhere near the end of it, so it is safe to relink the last descriptors to a queued buffer.
+		if (bus->_triple_dma_buffer)
+		{
+			int64_t now = esp_timer_get_time();
+
+			portENTER_CRITICAL_ISR(&bus->_output_mux);
+			if (bus->_frame_start_us) bus->_frame_period_us = now - bus->_frame_start_us;
+			bus->_frame_start_us = now;
+
+			// while start_dma_desc_relink() .. finish_dma_desc_relink() the descriptors flip_dma_output_buffer() links up
+			// aren't the ones being sent, so a queued buffer is left to finish_dma_desc_relink()
+			bus->_output_current = bus->_output_next;
+			if (bus->_output_queued >= 0 && bus->_old_dmadesc_a == nullptr)
+			{
+				bus->flip_dma_output_buffer(bus->_output_queued);
+				bus->_output_next   = bus->_output_queued;
+				bus->_output_queued = -1;
+			}
+			portEXIT_CRITICAL_ISR(&bus->_output_mux);
+		}
+
+		// Crossfade: the same goes for picking the buffer to show after the one just started
+		if (bus->_blend_left)
+		{
+			portENTER_CRITICAL_ISR(&bus->_output_mux);
+			bus->blend_step();
+			portEXIT_CRITICAL_ISR(&bus->_output_mux);
+		}
+
+#ifdef USE_STATS
+		// double buffering doesn't keep track of the buffer being sent, a flip counts as applied at the next end of frame
+		portENTER_CRITICAL_ISR(&bus->_output_mux);
+		bus->_stats.frame_end(esp_timer_get_time(), bus->_triple_dma_buffer ? bus->_output_current : -1);
+		portEXIT_CRITICAL_ISR(&bus->_output_mux);
+#endif
 
-	bool DRAM_ATTR i2s_parallel_is_previous_buffer_free() {
-		return previousBufferFree;
+		frame_callback_t cb = bus->_frame_cb;
+		if (cb) cb(bus->_frame_cb_arg);
+
+		BaseType_t higher_priority_task_woken = pdFALSE;
+		if (bus->_frame_waiting) xSemaphoreGiveFromISR(bus->_frame_sem, &higher_priority_task_woken);
+
+		if (higher_priority_task_woken) portYIELD_FROM_ISR();
 	}
-*/
 
 	// Static
 	i2s_dev_t* getDev()
@@ -400,19 +438,23 @@ Modified heavily for the ESP32 HUB75 DMA library by:
     dev->timing.val = 0;
 
 
-    // If we have double buffering, then allocate an interrupt service routine function
-    // that can be used for I2S0/I2S1 created interrupts.
+    // Allocate an interrupt on the EOF descriptor (page 322 of Tech. Ref. Manual)
+    // "I2S_OUT_EOF_INT: Triggered when rxlink has finished sending a packet" (when dma linked list with eof = 1 is hit)
+    // Only the last descriptor of a frame has eof set, so this gives us one interrupt per frame sent.
+    if (_frame_sem == nullptr)
+      _frame_sem = xSemaphoreCreateBinary();
 
-/*
-    // Setup I2S Interrupt
-    SET_PERI_REG_BITS(I2S_INT_ENA_REG(ESP32_I2S_DEVICE), I2S_OUT_EOF_INT_ENA_V, 1, I2S_OUT_EOF_INT_ENA_S);
+    dev->int_ena.val = 0;
+    dev->int_clr.val = ~0;
+    dev->int_ena.out_eof = 1;
 
-    // Allocate a level 1 intterupt: lowest priority, as ISR isn't urgent and may take a long time to complete
-    esp_intr_alloc(irq_source, (int)(ESP_INTR_FLAG_IRAM | ESP_INTR_FLAG_LEVEL1), i2s_isr, NULL, NULL);
-	
-*/
+    // Allocate a level 1 intterupt: lowest priority, as ISR isn't urgent
+    if (_isr_handle == nullptr && esp_intr_alloc(irq_source, (int)(ESP_INTR_FLAG_IRAM | ESP_INTR_FLAG_LEVEL1), i2s_isr, this, &_isr_handle) != ESP_OK)
+    {
+      ESP_LOGW("ESP32/S2", "Could not allocate the end of frame interrupt. flipDMABuffer() won't be able to wait for the panel.");
+      _isr_handle = nullptr;
+    }
 
- 
   #if defined (CONFIG_IDF_TARGET_ESP32S2)
       ESP_LOGD("ESP32-S2", "init() GPIO and clock configuration set for ESP32-S2");    
   #else
@@ -425,6 +467,19 @@ Modified heavily for the ESP32 HUB75 DMA library by:
 
   void Bus_Parallel16::release(void)
   {
+    if (_isr_handle)
+    {
+      _dev->int_ena.out_eof = 0;
+      esp_intr_free(_isr_handle);
+      _isr_handle = nullptr;
+    }
+
+    if (_frame_sem)
+    {
+      vSemaphoreDelete(_frame_sem);
+      _frame_sem = nullptr;
+    }
+
     if (_dmadesc_a)
     {
       heap_caps_free(_dmadesc_a);
@@ -438,6 +493,13 @@ Modified heavily for the ESP32 HUB75 DMA library by:
       _dmadesc_b = nullptr;
       _dmadesc_count = 0;      
     }
+
+    if (_dmadesc_c)
+    {
+      heap_caps_free(_dmadesc_c);
+      _dmadesc_c = nullptr;
+      _dmadesc_count = 0;      
+    }
   }
 
   void Bus_Parallel16::enable_double_dma_desc(void)
@@ -445,6 +507,12 @@ Modified heavily for the ESP32 HUB75 DMA library by:
     _double_dma_buffer = true;
   }
 
+  void Bus_Parallel16::enable_triple_dma_desc(void)
+  {
+    _double_dma_buffer = true;
+    _triple_dma_buffer = true;
+  }
+
   // Need this to work for double buffers etc.
   bool Bus_Parallel16::allocate_dma_desc_memory(size_t len)
   {
@@ -479,9 +547,26 @@ Modified heavily for the ESP32 HUB75 DMA library by:
         return false;
       }
     }
+
+    if (_triple_dma_buffer)
+    {
+      if (_dmadesc_c) heap_caps_free(_dmadesc_c); // free all dma descrptios previously
+
+      ESP_LOGD("ESP32/S2", "Allocating the third buffer (triple buffer enabled).");              
+
+      _dmadesc_c = (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA);
+
+      if (_dmadesc_c == nullptr)
+      {
+        ESP_LOGE("ESP32/S2", "ERROR: Couldn't malloc _dmadesc_c. Not enough memory.");
+        _triple_dma_buffer = false;
+        return false;
+      }
+    }
     
     _dmadesc_a_idx  = 0;
     _dmadesc_b_idx  = 0;
+    _dmadesc_c_idx  = 0;
 
     ESP_LOGD("ESP32/S2", "Allocating %d bytes of memory for DMA descriptors.", (int)sizeof(HUB75_DMA_DESCRIPTOR_T) * len);       
 
@@ -502,45 +587,136 @@ Modified heavily for the ESP32 HUB75 DMA library by:
 
   }
 
-  void Bus_Parallel16::create_dma_desc_link(void *data, size_t size, bool dmadesc_b)
+  bool Bus_Parallel16::start_dma_desc_relink(size_t len)
   {
-    static constexpr size_t MAX_DMA_LEN = (4096-4);
+    if (_dmadesc_a == nullptr || _old_dmadesc_a != nullptr)
+    {
+      ESP_LOGE("ESP32/S2", "Can't relink DMA descriptors that were never allocated, or while another relink is under way.");
+      return false;
+    }
 
-    if (size > MAX_DMA_LEN)
+    HUB75_DMA_DESCRIPTOR_T *a = (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA);
+    HUB75_DMA_DESCRIPTOR_T *b = _double_dma_buffer ? (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA) : nullptr;
+    HUB75_DMA_DESCRIPTOR_T *c = _triple_dma_buffer ? (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA) : nullptr;
+
+    if (a == nullptr || (_double_dma_buffer && b == nullptr) || (_triple_dma_buffer && c == nullptr))
     {
-      size = MAX_DMA_LEN;
-      ESP_LOGW("ESP32/S2", "Creating DMA descriptor which links to payload with size greater than MAX_DMA_LEN!");            
+      ESP_LOGE("ESP32/S2", "ERROR: Couldn't malloc %d DMA descriptors to relink. Not enough memory.", (int)len);
+      heap_caps_free(a);
+      heap_caps_free(b);
+      heap_caps_free(c);
+      return false;
     }
 
-    if ( !dmadesc_b )
+    // the old descriptors keep the output going until finish_dma_desc_relink(). The EOF interrupt may flip
+    // buffers meanwhile, so swap under the same lock.
+    portENTER_CRITICAL(&_output_mux);
+
+    _old_dmadesc_a     = _dmadesc_a;
+    _old_dmadesc_b     = _dmadesc_b;
+    _old_dmadesc_c     = _dmadesc_c;
+    _old_dmadesc_count = _dmadesc_count;
+
+    _dmadesc_a = a;
+    _dmadesc_b = b;
+    _dmadesc_c = c;
+
+    _dmadesc_count = len;
+    _dmadesc_last  = len-1;
+
+    _dmadesc_a_idx = 0;
+    _dmadesc_b_idx = 0;
+    _dmadesc_c_idx = 0;
+
+    portEXIT_CRITICAL(&_output_mux);
+
+    return true;
+  }
+
+  bool Bus_Parallel16::finish_dma_desc_relink(uint32_t timeout_ms)
+  {
+    if (_old_dmadesc_a == nullptr)
+      return true;
+
+    portENTER_CRITICAL(&_output_mux);
+
+    // link the new descriptors up to go on to the buffer the old ones do, or to a queued one the EOF interrupt
+    // left alone meanwhile, then point the old ones at the new start of that buffer
+    int buffer_id = (_output_queued >= 0) ? _output_queued : _output_next;
+    _output_queued = -1;
+
+    flip_dma_output_buffer(buffer_id);
+
+    HUB75_DMA_DESCRIPTOR_T *start = (buffer_id == 2) ? _dmadesc_c : (buffer_id == 1) ? _dmadesc_b : _dmadesc_a;
+
+    _old_dmadesc_a[_old_dmadesc_count-1].qe.stqe_next = start;
+
+    if (_old_dmadesc_b)
+      _old_dmadesc_b[_old_dmadesc_count-1].qe.stqe_next = start;
+
+    if (_old_dmadesc_c)
+      _old_dmadesc_c[_old_dmadesc_count-1].qe.stqe_next = start;
+
+    portEXIT_CRITICAL(&_output_mux);
+
+    // As with a flip, the DMA may be past the last descriptor's link already and loop over the old chain once more,
+    // so it's only done with the old descriptors after the second end of frame. With the output stopped it isn't
+    // using them at all, and without the EOF interrupt there's nothing to go by but the time.
+    if (_output_running)
     {
-      if ( (_dmadesc_a_idx+1) > _dmadesc_count) {
-        ESP_LOGE("ESP32/S2", "Attempted to create more DMA descriptors than allocated memory for. Expecting a maximum of %u DMA descriptors", (unsigned int)_dmadesc_count);          
-        return;
+      if (_isr_handle == nullptr)
+      {
+        vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+      }
+      else if (!wait_frames_sent(_frames_sent + 2, timeout_ms))
+      {
+        // the DMA may still be on them, so lose the memory rather than free descriptors in use
+        _old_dmadesc_a = nullptr;
+        _old_dmadesc_b = nullptr;
+        _old_dmadesc_c = nullptr;
+        _old_dmadesc_count = 0;
+        return false;
       }
     }
 
-    volatile lldesc_t *dmadesc;
-    volatile lldesc_t *next;
-    bool eof = false;
-    
-    if ( (dmadesc_b == true) ) // for primary buffer
-    {
-        dmadesc      = &_dmadesc_b[_dmadesc_b_idx];
+    heap_caps_free(_old_dmadesc_a);
+    heap_caps_free(_old_dmadesc_b);
+    heap_caps_free(_old_dmadesc_c);
 
-        next = (_dmadesc_b_idx < (_dmadesc_last) ) ? &_dmadesc_b[_dmadesc_b_idx+1]:_dmadesc_b;       
-        eof  = (_dmadesc_b_idx == (_dmadesc_last));
-    }
-    else
+    _old_dmadesc_a = nullptr;
+    _old_dmadesc_b = nullptr;
+    _old_dmadesc_c = nullptr;
+    _old_dmadesc_count = 0;
+
+    return true;
+  }
+
+  void Bus_Parallel16::create_dma_desc_link(void *data, size_t size, int buffer_id)
+  {
+    static constexpr size_t MAX_DMA_LEN = (4096-4);
+
+    if (size > MAX_DMA_LEN)
     {
-        dmadesc      = &_dmadesc_a[_dmadesc_a_idx];
+      size = MAX_DMA_LEN;
+      ESP_LOGW("ESP32/S2", "Creating DMA descriptor which links to payload with size greater than MAX_DMA_LEN!");            
+    }
+
+    // descriptor list and index for buffer 0 / 'a', 1 / 'b' or 2 / 'c'
+    HUB75_DMA_DESCRIPTOR_T *_dmadesc     = (buffer_id == 2) ? _dmadesc_c     : (buffer_id == 1) ? _dmadesc_b     : _dmadesc_a;
+    uint32_t               &_dmadesc_idx = (buffer_id == 2) ? _dmadesc_c_idx : (buffer_id == 1) ? _dmadesc_b_idx : _dmadesc_a_idx;
 
-        // https://stackoverflow.com/questions/47170740/c-negative-array-index
-        next = (_dmadesc_a_idx < (_dmadesc_last) ) ? _dmadesc_a + _dmadesc_a_idx+1:_dmadesc_a;       
-        eof  = (_dmadesc_a_idx == (_dmadesc_last));
+    if ( (_dmadesc_idx+1) > _dmadesc_count) {
+      ESP_LOGE("ESP32/S2", "Attempted to create more DMA descriptors than allocated memory for. Expecting a maximum of %u DMA descriptors", (unsigned int)_dmadesc_count);          
+      return;
     }
 
-    if ( _dmadesc_a_idx == (_dmadesc_last) ) {
+    volatile lldesc_t *dmadesc = &_dmadesc[_dmadesc_idx];
+
+    // https://stackoverflow.com/questions/47170740/c-negative-array-index
+    volatile lldesc_t *next = (_dmadesc_idx < (_dmadesc_last) ) ? _dmadesc + _dmadesc_idx+1:_dmadesc;       
+    bool eof = (_dmadesc_idx == (_dmadesc_last));
+
+    if ( eof ) {
       ESP_LOGW("ESP32/S2", "Creating final DMA descriptor and linking back to 0.");             
     } 
 
@@ -553,14 +729,29 @@ Modified heavily for the ESP32 HUB75 DMA library by:
     dmadesc->qe.stqe_next = (lldesc_t*) next;         
     dmadesc->offset   = 0;       
 
-    if ( (dmadesc_b == true) ) { // for primary buffer
-      _dmadesc_b_idx++; 
-    } else {
-      _dmadesc_a_idx++; 
-    }
+    _dmadesc_idx++; 
   
   } // end create_dma_desc_link
 
+  void Bus_Parallel16::update_dma_desc_link(size_t index, void *data, size_t size, int buffer_id)
+  {
+    HUB75_DMA_DESCRIPTOR_T *_dmadesc = (buffer_id == 2) ? _dmadesc_c : (buffer_id == 1) ? _dmadesc_b : _dmadesc_a;
+
+    if (_dmadesc == nullptr || index >= _dmadesc_count)
+    {
+      ESP_LOGE("ESP32/S2", "No DMA descriptor %u to update.", (unsigned int)index);
+      return;
+    }
+
+    volatile lldesc_t *dmadesc = &_dmadesc[index];
+
+    // the payload has to stay word aligned, see MatrixPanel_I2S_DMA::scrollHorizontal()
+    dmadesc->buf    = (uint8_t*) data;
+    dmadesc->size   = size;
+    dmadesc->length = size;
+
+  } // end update_dma_desc_link
+
   void Bus_Parallel16::dma_transfer_start()
   {
     auto dev = _dev;
@@ -577,6 +768,7 @@ Modified heavily for the ESP32 HUB75 DMA library by:
     
     dev->conf.tx_start  = 1;
 
+    _output_running = true;
    
   } // end 
   
@@ -589,41 +781,167 @@ Modified heavily for the ESP32 HUB75 DMA library by:
     dev->out_link.stop = 1;
     dev->out_link.start = 0;
     dev->conf.tx_start = 0;
+
+    _output_running = false;
         
   } // end   
 
 
-  void Bus_Parallel16::flip_dma_output_buffer(int buffer_id) // pass by reference so we can change in main matrixpanel class
+  void IRAM_ATTR Bus_Parallel16::flip_dma_output_buffer(int buffer_id) // pass by reference so we can change in main matrixpanel class
   {
-	  
-      // Setup interrupt handler which is focussed only on the (page 322 of Tech. Ref. Manual)
-      // "I2S_OUT_EOF_INT: Triggered when rxlink has finished sending a packet" (when dma linked list with eof = 1 is hit)
-  	  
-      if ( buffer_id == 1) { 
-
-		//fix _dmadesc_ loop issue #407
-		//need to connect the up comming _dmadesc_ not the old one
-		_dmadesc_b[_dmadesc_last].qe.stqe_next = &_dmadesc_b[0];	  
-
-		_dmadesc_a[_dmadesc_last].qe.stqe_next = &_dmadesc_b[0]; // Start sending out _dmadesc_b (or buffer 1)
-		      
-      } else { 
-
-        _dmadesc_a[_dmadesc_last].qe.stqe_next = &_dmadesc_a[0];
-	      
-        _dmadesc_b[_dmadesc_last].qe.stqe_next = &_dmadesc_a[0]; // Start sending out _dmadesc_a (or buffer 0)
-		
-      }
+      //fix _dmadesc_ loop issue #407
+      //need to connect the up comming _dmadesc_ not the old one, so every buffer's last descriptor
+      //(including the up comming one's, to setup the loop) links to the start of the up comming buffer
+      HUB75_DMA_DESCRIPTOR_T *start = (buffer_id == 2) ? _dmadesc_c : (buffer_id == 1) ? _dmadesc_b : _dmadesc_a;
 
-/*
-      previousBufferFree = false;  
-      while (!previousBufferFree);
-*/
-           
+      _dmadesc_a[_dmadesc_last].qe.stqe_next = start;
 
+      if (_double_dma_buffer)
+        _dmadesc_b[_dmadesc_last].qe.stqe_next = start;
+
+      if (_triple_dma_buffer)
+        _dmadesc_c[_dmadesc_last].qe.stqe_next = start;
+
+      _output_next = buffer_id;
 
   } // end flip
 
 
+  void Bus_Parallel16::queue_dma_output_buffer(int buffer_id)
+  {
+    portENTER_CRITICAL(&_output_mux);
+
+    if (_isr_handle == nullptr)
+    {
+      // no EOF interrupt to link it in, so do it now and hope for the best
+      flip_dma_output_buffer(buffer_id);
+      _output_current = _output_next = buffer_id;
+    }
+    else if (_frame_period_us && (esp_timer_get_time() - _frame_start_us) < (_frame_period_us * 3 / 4))
+    {
+      // Early enough in the frame that the DMA is nowhere near the last descriptor, so link it in now, so it is
+      // shown from the next frame. Replaces the buffer linked in next if that was never shown.
+      flip_dma_output_buffer(buffer_id);
+      _output_next   = buffer_id;
+      _output_queued = -1;
+    }
+    else
+    {
+      _output_queued = buffer_id;
+    }
+
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::blend_dma_output_buffers(int from_id, int to_id, uint16_t frames)
+  {
+    portENTER_CRITICAL(&_output_mux);
+
+    if (_isr_handle == nullptr || frames == 0)
+    {
+      // nothing to step it along, so straight across
+      flip_dma_output_buffer(to_id);
+      _blend_left = 0;
+    }
+    else
+    {
+      // from_id is on the panel, and stays linked in until the first end of frame
+      flip_dma_output_buffer(from_id);
+      _blend_from   = from_id;
+      _blend_to     = to_id;
+      _blend_frames = frames;
+      _blend_acc    = 0;
+      _blend_left   = frames;
+    }
+
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::stop_dma_output_blend()
+  {
+    portENTER_CRITICAL(&_output_mux);
+    _blend_left = 0;
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  // to_id is picked for 'frames done / frames' of the frames, the remainder carried over to the next one
+  // (error diffusion), so its share rises a little every frame rather than in runs of one buffer
+  void IRAM_ATTR Bus_Parallel16::blend_step()
+  {
+    if (_blend_left == 0 || _old_dmadesc_a != nullptr) // not while relinking, see finish_dma_desc_relink()
+      return;
+
+    _blend_left = _blend_left - 1;
+    _blend_acc += _blend_frames - _blend_left;
+
+    int buffer_id = _blend_from;
+    if (_blend_acc >= _blend_frames)
+    {
+      _blend_acc -= _blend_frames;
+      buffer_id = _blend_to;
+    }
+
+    flip_dma_output_buffer(buffer_id); // the last one is always to_id
+  }
+
+  void Bus_Parallel16::get_dma_output_buffers(int8_t &current, int8_t &next, int8_t &queued) const
+  {
+    portENTER_CRITICAL(&_output_mux);
+    current = _output_current;
+    next    = _output_next;
+    queued  = _output_queued;
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::set_frame_callback(frame_callback_t cb, void *arg)
+  {
+    _frame_cb = nullptr; // so the ISR never sees the new callback with the old arg
+    _frame_cb_arg = arg;
+    _frame_cb = cb;
+  }
+
+#ifdef USE_STATS
+  void Bus_Parallel16::get_stats(frame_stats_t &stats) const
+  {
+    portENTER_CRITICAL(&_output_mux);
+    stats = _stats;
+    portEXIT_CRITICAL(&_output_mux);
+
+    stats.now_us = esp_timer_get_time();
+  }
+
+  void Bus_Parallel16::reset_stats()
+  {
+    portENTER_CRITICAL(&_output_mux);
+    _stats.reset(esp_timer_get_time());
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::stats_flip(int buffer_id)
+  {
+    portENTER_CRITICAL(&_output_mux);
+    _stats.flip(esp_timer_get_time(), buffer_id);
+    portEXIT_CRITICAL(&_output_mux);
+  }
+#endif
+
+  bool Bus_Parallel16::wait_frames_sent(uint32_t frame_count, uint32_t timeout_ms)
+  {
+    if (_isr_handle == nullptr || _frame_sem == nullptr) return false;
+
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    if (timeout == 0) timeout = 1;
+
+    _frame_waiting = true;
+    while ((int32_t)(_frames_sent - frame_count) < 0)
+    {
+      if (xSemaphoreTake(_frame_sem, timeout) != pdTRUE) break; // no frame sent within the timeout, DMA is stopped?
+    }
+    _frame_waiting = false;
+
+    return (int32_t)(_frames_sent - frame_count) >= 0;
+  }
+
+
 
 #endif
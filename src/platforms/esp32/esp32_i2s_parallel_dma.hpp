@@ -34,6 +34,9 @@ Contributors:
 
 #include <sys/types.h>
 #include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
+#include <esp_intr_alloc.h>
 //#include <driver/i2s.h>
 #include <rom/lldesc.h>
 #include <rom/gpio.h>
@@ -46,6 +49,10 @@ Contributors:
 
 #include <soc/i2s_periph.h> //includes struct and reg
 
+#ifdef USE_STATS
+#include "../frame_stats.hpp"
+#endif
+
 
 #define DMA_MAX (4096-4)
 
@@ -115,22 +122,69 @@ i2s_dev_t* getDev();
     void release(void) ;
 
     void enable_double_dma_desc();
+    void enable_triple_dma_desc();
     bool allocate_dma_desc_memory(size_t len);
 
-    void create_dma_desc_link(void *memory, size_t size, bool dmadesc_b = false);
+    // Relink the descriptors of every buffer while the output keeps running: start_dma_desc_relink() allocates a new
+    // set of 'len' descriptors per buffer to link up with create_dma_desc_link(), finish_dma_desc_relink() hands the
+    // DMA over to them at the end of the frame it is sending and frees the old set once it's done with it.
+    // A flip queued meanwhile is linked in by finish_dma_desc_relink(), a crossfade is held till then.
+    // Returns false if no frame was sent on the new set within timeout_ms, the old set is left allocated then.
+    bool start_dma_desc_relink(size_t len);
+    bool finish_dma_desc_relink(uint32_t timeout_ms);
+
+    void create_dma_desc_link(void *memory, size_t size, int buffer_id = 0);
+
+    // Point descriptor 'index' of a buffer (as linked up by create_dma_desc_link()) at another payload, leaving the links
+    // as they are, for MatrixPanel_I2S_DMA::scrollHorizontal(). The DMA picks it up the next time it gets to that descriptor.
+    void update_dma_desc_link(size_t index, void *memory, size_t size, int buffer_id = 0);
 
     void dma_transfer_start();
     void dma_transfer_stop();
 
     void flip_dma_output_buffer(int buffer_id);
+
+    // Triple buffering: buffer_id is shown from the next frame if it's early enough in the current one to relink
+    // the last descriptors safely, otherwise it is queued and linked in by the EOF interrupt, replacing any buffer
+    // queued before that wasn't linked in yet.
+    void queue_dma_output_buffer(int buffer_id);
+    // Buffer being sent now, the one linked in after it (can be the same) and the queued one (-1 for none)
+    void get_dma_output_buffers(int8_t &current, int8_t &next, int8_t &queued) const;
+
+    // Double buffering crossfade: for the next 'frames' frames the EOF interrupt picks which of from_id / to_id the
+    // DMA goes on to after the frame it has just started, to_id in a rising share of them, then leaves to_id linked in.
+    // The panel is refreshed far faster than the eye follows, so that's a crossfade with no pixels touched.
+    // Without the EOF interrupt it's straight across to to_id. stop_dma_output_blend() leaves whichever is linked in.
+    void blend_dma_output_buffers(int from_id, int to_id, uint16_t frames);
+    void stop_dma_output_blend();
+    uint16_t get_dma_blend_frames_left() const { return _blend_left; }
+
+    // Frame complete event, raised by the EOF interrupt of the last DMA descriptor, so once per
+    // complete pass over the descriptor chain (one full refresh of the panel).
+    typedef void (*frame_callback_t)(void *arg);
+
+    uint32_t get_frames_sent() const { return _frames_sent; }
+    void set_frame_callback(frame_callback_t cb, void *arg); // called from the ISR, so cb must be IRAM_ATTR and short
+    bool wait_frames_sent(uint32_t frame_count, uint32_t timeout_ms); // block until get_frames_sent() reaches frame_count
+
+#ifdef USE_STATS
+    // End of frame / flip counters for MatrixPanel_I2S_DMA::getStats(), times in esp_timer microseconds
+    void get_stats(frame_stats_t &stats) const;
+    void reset_stats();
+    void stats_flip(int buffer_id); // a flip to buffer_id, before it is made
+#endif
   
   private:
 
+    static void i2s_isr(void *arg);
+    void blend_step(); // from the EOF interrupt, under _output_mux
+
     void _init_pins() { };    
 
     config_t _cfg;
 
     bool    _double_dma_buffer  = false;
+    bool    _triple_dma_buffer  = false;
     //bool    _dmadesc_a_active   = true;
 
     uint32_t _dmadesc_count  = 0;   // number of dma decriptors
@@ -138,9 +192,17 @@ i2s_dev_t* getDev();
 
     uint32_t _dmadesc_a_idx  = 0;
     uint32_t _dmadesc_b_idx  = 0;
+    uint32_t _dmadesc_c_idx  = 0;
 
     HUB75_DMA_DESCRIPTOR_T* _dmadesc_a = nullptr;
     HUB75_DMA_DESCRIPTOR_T* _dmadesc_b = nullptr; 
+    HUB75_DMA_DESCRIPTOR_T* _dmadesc_c = nullptr; // triple buffer only
+
+    // descriptors being replaced by start_dma_desc_relink(), until finish_dma_desc_relink()
+    HUB75_DMA_DESCRIPTOR_T* _old_dmadesc_a = nullptr;
+    HUB75_DMA_DESCRIPTOR_T* _old_dmadesc_b = nullptr;
+    HUB75_DMA_DESCRIPTOR_T* _old_dmadesc_c = nullptr;
+    uint32_t                _old_dmadesc_count = 0;
 
 /*
     HUB75_DMA_DESCRIPTOR_T* _dmadesc_blank = nullptr;     
@@ -148,6 +210,33 @@ i2s_dev_t* getDev();
 */
 
     volatile i2s_dev_t* _dev;
+
+    intr_handle_t               _isr_handle     = nullptr;
+    SemaphoreHandle_t           _frame_sem      = nullptr;
+    bool                        _output_running = false;  // between dma_transfer_start() and dma_transfer_stop()
+    volatile uint32_t           _frames_sent    = 0;
+    volatile bool               _frame_waiting  = false;
+    volatile frame_callback_t   _frame_cb       = nullptr;
+    void * volatile             _frame_cb_arg   = nullptr;
+
+    // triple buffer output state, shared with the ISR
+    mutable portMUX_TYPE        _output_mux     = portMUX_INITIALIZER_UNLOCKED;
+    volatile int8_t             _output_current = 0;
+    volatile int8_t             _output_next    = 0;    // linked in by the last flip_dma_output_buffer(), triple buffered or not
+    volatile int8_t             _output_queued  = -1;
+    volatile int64_t            _frame_start_us  = 0;   // esp_timer time of the last EOF
+    volatile int64_t            _frame_period_us = 0;
+
+    // crossfade state, see blend_dma_output_buffers(). _blend_left is read without the lock to skip it quickly
+    volatile uint16_t           _blend_frames   = 0;
+    volatile uint16_t           _blend_left     = 0;
+    uint32_t                    _blend_acc      = 0;
+    int8_t                      _blend_from     = 0;
+    int8_t                      _blend_to       = 0;
+
+#ifdef USE_STATS
+    frame_stats_t               _stats;                 // under _output_mux
+#endif
     
     
 
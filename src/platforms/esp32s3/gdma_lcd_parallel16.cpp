@@ -27,36 +27,67 @@
   #include "gdma_lcd_parallel16.hpp"
   #include "esp_attr.h"
   #include "esp_idf_version.h"
+  #include <freertos/task.h>
 
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)		
   #include "esp_private/gpio.h"
 #endif  
 
-/*
-  DRAM_ATTR volatile bool previousBufferFree = true;
- 
-  // End-of-DMA-transfer callback
-  IRAM_ATTR bool gdma_on_trans_eof_callback(gdma_channel_handle_t dma_chan,
+  // End-of-DMA-transfer callback. Only the last descriptor of a frame has suc_eof set, so this is
+  // called once per frame sent to the panel. Counts frames, wakes a task waiting in wait_frames_sent()
+  // and calls the user callback.
+  IRAM_ATTR bool Bus_Parallel16::gdma_on_trans_eof_callback(gdma_channel_handle_t dma_chan,
                                     gdma_event_data_t *event_data, void *user_data) {
-                                        
-  // This DMA callback seems to trigger a moment before the last data has
-  // issued (buffering between DMA & LCD peripheral?), so pause a moment
-  // before stopping LCD data out. The ideal delay may depend on the LCD
-  // clock rate...this one was determined empirically by monitoring on a
-  // logic analyzer. YMMV.
-    esp_rom_delay_us(100);        
-  // The LCD peripheral stops transmitting at the end of the DMA xfer, but
-  // clear the lcd_start flag anyway -- we poll it in loop() to decide when
-  // the transfer has finished, and the same flag is set later to trigger
-  // the next transfer.
-
-    //LCD_CAM.lcd_user.lcd_start = 0;
-    
-    previousBufferFree = true;
-    
-    return true;
-  }  
-*/  
+
+    Bus_Parallel16 *bus = (Bus_Parallel16 *)user_data;
+
+    bus->_frames_sent = bus->_frames_sent + 1;
+
+    // Triple buffering: the DMA has just started on the buffer the last descriptor was linked to, and is
+    // nowhere near the end of it, so it is safe to relink the last descriptors to a queued buffer.
+    if (bus->_triple_dma_buffer)
+    {
+      int64_t now = esp_timer_get_time();
+
+      portENTER_CRITICAL_ISR(&bus->_output_mux);
+      if (bus->_frame_start_us) bus->_frame_period_us = now - bus->_frame_start_us;
+      bus->_frame_start_us = now;
+
+      // while start_dma_desc_relink() .. finish_dma_desc_relink() the descriptors flip_dma_output_buffer() links up
+      // aren't the ones being sent, so a queued buffer is left to finish_dma_desc_relink()
+      bus->_output_current = bus->_output_next;
+      if (bus->_output_queued >= 0 && bus->_old_dmadesc_a == nullptr)
+      {
+        bus->flip_dma_output_buffer(bus->_output_queued);
+        bus->_output_next   = bus->_output_queued;
+        bus->_output_queued = -1;
+      }
+      portEXIT_CRITICAL_ISR(&bus->_output_mux);
+    }
+
+    // Crossfade: the same goes for picking the buffer to show after the one just started
+    if (bus->_blend_left)
+    {
+      portENTER_CRITICAL_ISR(&bus->_output_mux);
+      bus->blend_step();
+      portEXIT_CRITICAL_ISR(&bus->_output_mux);
+    }
+
+#ifdef USE_STATS
+    // double buffering doesn't keep track of the buffer being sent, a flip counts as applied at the next end of frame
+    portENTER_CRITICAL_ISR(&bus->_output_mux);
+    bus->_stats.frame_end(esp_timer_get_time(), bus->_triple_dma_buffer ? bus->_output_current : -1);
+    portEXIT_CRITICAL_ISR(&bus->_output_mux);
+#endif
+
+    frame_callback_t cb = bus->_frame_cb;
+    if (cb) cb(bus->_frame_cb_arg);
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    if (bus->_frame_waiting) xSemaphoreGiveFromISR(bus->_frame_sem, &higher_priority_task_woken);
+
+    return higher_priority_task_woken == pdTRUE;
+  }
 
   lcd_cam_dev_t* getDev()
   {
@@ -265,14 +296,17 @@
     gdma_set_transfer_ability(dma_chan, &ability);
 #endif
 
-/*
-    // Enable DMA transfer callback
+    // Enable DMA transfer callback, for the frame complete event
+    if (_frame_sem == nullptr)
+      _frame_sem = xSemaphoreCreateBinary();
+
     static gdma_tx_event_callbacks_t tx_cbs = {
        // .on_trans_eof is literally the only gdma tx event type available
       .on_trans_eof = gdma_on_trans_eof_callback 
     };
-    gdma_register_tx_event_callbacks(dma_chan, &tx_cbs, NULL);
-*/
+    _frame_event = (gdma_register_tx_event_callbacks(dma_chan, &tx_cbs, this) == ESP_OK);
+    if (!_frame_event)
+      ESP_LOGW("S3", "Could not register the end of frame callback. flipDMABuffer() won't be able to wait for the panel.");
 
     // This uses a busy loop to wait for each DMA transfer to complete...
     // but the whole point of DMA is that one's code can do other work in
@@ -295,6 +329,19 @@
 
   void Bus_Parallel16::release(void)
   {
+    if (_frame_event)
+    {
+      static gdma_tx_event_callbacks_t no_cbs = {
+        .on_trans_eof = NULL
+      };
+      gdma_register_tx_event_callbacks(dma_chan, &no_cbs, NULL);
+      _frame_event = false;
+    }
+    if (_frame_sem)
+    {
+      vSemaphoreDelete(_frame_sem);
+      _frame_sem = nullptr;
+    }
     if (_i80_bus)
     {
       esp_lcd_del_i80_bus(_i80_bus);
@@ -306,6 +353,16 @@
       _dmadesc_a = nullptr;
       _dmadesc_count = 0;
     }
+    if (_dmadesc_b)
+    {
+      heap_caps_free(_dmadesc_b);
+      _dmadesc_b = nullptr;
+    }
+    if (_dmadesc_c)
+    {
+      heap_caps_free(_dmadesc_c);
+      _dmadesc_c = nullptr;
+    }
 
   }
 
@@ -315,6 +372,13 @@
        _double_dma_buffer = true;
   }
 
+  void Bus_Parallel16::enable_triple_dma_desc(void)
+  {
+        ESP_LOGI("S3", "Enabled support for secondary and tertiary DMA buffers.");    
+       _double_dma_buffer = true;
+       _triple_dma_buffer = true;
+  }
+
   // Need this to work for double buffers etc.
   bool Bus_Parallel16::allocate_dma_desc_memory(size_t len)
   {
@@ -342,78 +406,189 @@
       }
     }
 
+    if (_triple_dma_buffer)
+    {
+      _dmadesc_c= (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA);
+    
+      if (_dmadesc_c == nullptr)
+      {
+        ESP_LOGE("S3", "ERROR: Couldn't malloc _dmadesc_c. Not enough memory.");
+        _triple_dma_buffer = false;
+        return false;
+      }
+    }
+
     /// override static 
     _dmadesc_a_idx = 0;
     _dmadesc_b_idx = 0;
+    _dmadesc_c_idx = 0;
 
     return true;
 
   }
 
-  void Bus_Parallel16::create_dma_desc_link(void *data, size_t size, bool dmadesc_b)
+  bool Bus_Parallel16::start_dma_desc_relink(size_t len)
   {
-    static constexpr size_t MAX_DMA_LEN = (4096-4);
-
-    if (size > MAX_DMA_LEN) {
-      size = MAX_DMA_LEN;
-      ESP_LOGW("S3", "Creating DMA descriptor which links to payload with size greater than MAX_DMA_LEN!");            
+    if (_dmadesc_a == nullptr || _old_dmadesc_a != nullptr)
+    {
+      ESP_LOGE("S3", "Can't relink DMA descriptors that were never allocated, or while another relink is under way.");
+      return false;
     }
 
-    if ( dmadesc_b == true)
+    HUB75_DMA_DESCRIPTOR_T *a = (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA);
+    HUB75_DMA_DESCRIPTOR_T *b = _double_dma_buffer ? (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA) : nullptr;
+    HUB75_DMA_DESCRIPTOR_T *c = _triple_dma_buffer ? (HUB75_DMA_DESCRIPTOR_T*)heap_caps_malloc(sizeof(HUB75_DMA_DESCRIPTOR_T) * len, MALLOC_CAP_DMA) : nullptr;
+
+    if (a == nullptr || (_double_dma_buffer && b == nullptr) || (_triple_dma_buffer && c == nullptr))
     {
+      ESP_LOGE("S3", "ERROR: Couldn't malloc %d DMA descriptors to relink. Not enough memory.", (int)len);
+      heap_caps_free(a);
+      heap_caps_free(b);
+      heap_caps_free(c);
+      return false;
+    }
 
-      _dmadesc_b[_dmadesc_b_idx].dw0.owner = DMA_DESCRIPTOR_BUFFER_OWNER_DMA;
-      //_dmadesc_b[_dmadesc_b_idx].dw0.suc_eof = 0;   
-      _dmadesc_b[_dmadesc_b_idx].dw0.suc_eof = (_dmadesc_b_idx == (_dmadesc_count-1));
-      _dmadesc_b[_dmadesc_b_idx].dw0.size = _dmadesc_b[_dmadesc_b_idx].dw0.length = size; //sizeof(data);
-      _dmadesc_b[_dmadesc_b_idx].buffer = data; //data;
+    // the old descriptors keep the output going until finish_dma_desc_relink(). The EOF callback may flip
+    // buffers meanwhile, so swap under the same lock.
+    portENTER_CRITICAL(&_output_mux);
 
-      if (_dmadesc_b_idx == _dmadesc_count-1) {
-          _dmadesc_b[_dmadesc_b_idx].next =  (dma_descriptor_t *) &_dmadesc_b[0]; 
-      }
-      else {
-          _dmadesc_b[_dmadesc_b_idx].next =  (dma_descriptor_t *) &_dmadesc_b[_dmadesc_b_idx+1]; 
-      }
+    _old_dmadesc_a     = _dmadesc_a;
+    _old_dmadesc_b     = _dmadesc_b;
+    _old_dmadesc_c     = _dmadesc_c;
+    _old_dmadesc_count = _dmadesc_count;
 
-      _dmadesc_b_idx++;
+    _dmadesc_a = a;
+    _dmadesc_b = b;
+    _dmadesc_c = c;
 
+    _dmadesc_count = len;
 
-    }
-    else
+    _dmadesc_a_idx = 0;
+    _dmadesc_b_idx = 0;
+    _dmadesc_c_idx = 0;
+
+    portEXIT_CRITICAL(&_output_mux);
+
+    return true;
+  }
+
+  bool Bus_Parallel16::finish_dma_desc_relink(uint32_t timeout_ms)
+  {
+    if (_old_dmadesc_a == nullptr)
+      return true;
+
+    portENTER_CRITICAL(&_output_mux);
+
+    // link the new descriptors up to go on to the buffer the old ones do, or to a queued one the EOF callback
+    // left alone meanwhile, then point the old ones at the new start of that buffer
+    int buffer_id = (_output_queued >= 0) ? _output_queued : _output_next;
+    _output_queued = -1;
+
+    flip_dma_output_buffer(buffer_id);
+
+    dma_descriptor_t *start = (buffer_id == 2) ? &_dmadesc_c[0] : (buffer_id == 1) ? &_dmadesc_b[0] : &_dmadesc_a[0];
+
+    _old_dmadesc_a[_old_dmadesc_count-1].next = start;
+
+    if (_old_dmadesc_b)
+      _old_dmadesc_b[_old_dmadesc_count-1].next = start;
+
+    if (_old_dmadesc_c)
+      _old_dmadesc_c[_old_dmadesc_count-1].next = start;
+
+    portEXIT_CRITICAL(&_output_mux);
+
+    // As with a flip, the DMA may be past the last descriptor's link already and loop over the old chain once more,
+    // so it's only done with the old descriptors after the second end of frame. With the output stopped it isn't
+    // using them at all, and without the EOF callback there's nothing to go by but the time.
+    if (_output_running)
     {
-        
-      if ( _dmadesc_a_idx >= _dmadesc_count)
+      if (!_frame_event)
       {
-        ESP_LOGE("S3", "Attempted to create more DMA descriptors than allocated. Expecting max %u descriptors.", (unsigned int)_dmadesc_count);          
-        return;
+        vTaskDelay(pdMS_TO_TICKS(timeout_ms));
       }
+      else if (!wait_frames_sent(_frames_sent + 2, timeout_ms))
+      {
+        // the DMA may still be on them, so lose the memory rather than free descriptors in use
+        _old_dmadesc_a = nullptr;
+        _old_dmadesc_b = nullptr;
+        _old_dmadesc_c = nullptr;
+        _old_dmadesc_count = 0;
+        return false;
+      }
+    }
 
-      _dmadesc_a[_dmadesc_a_idx].dw0.owner = DMA_DESCRIPTOR_BUFFER_OWNER_DMA;
-      //_dmadesc_a[_dmadesc_a_idx].dw0.suc_eof = 0;
-      _dmadesc_a[_dmadesc_a_idx].dw0.suc_eof = (_dmadesc_a_idx == (_dmadesc_count-1));    
-      _dmadesc_a[_dmadesc_a_idx].dw0.size = _dmadesc_a[_dmadesc_a_idx].dw0.length = size; //sizeof(data);
-      _dmadesc_a[_dmadesc_a_idx].buffer = data; //data;
+    heap_caps_free(_old_dmadesc_a);
+    heap_caps_free(_old_dmadesc_b);
+    heap_caps_free(_old_dmadesc_c);
 
-      if (_dmadesc_a_idx == _dmadesc_count-1) {
-          _dmadesc_a[_dmadesc_a_idx].next =  (dma_descriptor_t *) &_dmadesc_a[0]; 
-			ESP_LOGV("S3", "Creating last _dmadesc_a descriptor which loops back to _dmadesc_a[0]!");     		  
-      }
-      else {
-          _dmadesc_a[_dmadesc_a_idx].next =  (dma_descriptor_t *) &_dmadesc_a[_dmadesc_a_idx+1]; 
-      }
+    _old_dmadesc_a = nullptr;
+    _old_dmadesc_b = nullptr;
+    _old_dmadesc_c = nullptr;
+    _old_dmadesc_count = 0;
+
+    return true;
+  }
+
+  void Bus_Parallel16::create_dma_desc_link(void *data, size_t size, int buffer_id)
+  {
+    static constexpr size_t MAX_DMA_LEN = (4096-4);
 
-      _dmadesc_a_idx++;
+    if (size > MAX_DMA_LEN) {
+      size = MAX_DMA_LEN;
+      ESP_LOGW("S3", "Creating DMA descriptor which links to payload with size greater than MAX_DMA_LEN!");            
+    }
 
+    // descriptor list and index for buffer 0 / 'a', 1 / 'b' or 2 / 'c'
+    HUB75_DMA_DESCRIPTOR_T *_dmadesc     = (buffer_id == 2) ? _dmadesc_c     : (buffer_id == 1) ? _dmadesc_b     : _dmadesc_a;
+    uint32_t               &_dmadesc_idx = (buffer_id == 2) ? _dmadesc_c_idx : (buffer_id == 1) ? _dmadesc_b_idx : _dmadesc_a_idx;
 
+    if ( _dmadesc_idx >= _dmadesc_count)
+    {
+      ESP_LOGE("S3", "Attempted to create more DMA descriptors than allocated. Expecting max %u descriptors.", (unsigned int)_dmadesc_count);          
+      return;
     }
 
+    _dmadesc[_dmadesc_idx].dw0.owner = DMA_DESCRIPTOR_BUFFER_OWNER_DMA;
+    //_dmadesc[_dmadesc_idx].dw0.suc_eof = 0;
+    _dmadesc[_dmadesc_idx].dw0.suc_eof = (_dmadesc_idx == (_dmadesc_count-1));    
+    _dmadesc[_dmadesc_idx].dw0.size = _dmadesc[_dmadesc_idx].dw0.length = size; //sizeof(data);
+    _dmadesc[_dmadesc_idx].buffer = data; //data;
+
+    if (_dmadesc_idx == _dmadesc_count-1) {
+        _dmadesc[_dmadesc_idx].next =  (dma_descriptor_t *) &_dmadesc[0]; 
+        ESP_LOGV("S3", "Creating last _dmadesc descriptor which loops back to _dmadesc[0]!");     		  
+    }
+    else {
+        _dmadesc[_dmadesc_idx].next =  (dma_descriptor_t *) &_dmadesc[_dmadesc_idx+1]; 
+    }
+
+    _dmadesc_idx++;
+
   } // end create_dma_desc_link
 
+  void Bus_Parallel16::update_dma_desc_link(size_t index, void *data, size_t size, int buffer_id)
+  {
+    HUB75_DMA_DESCRIPTOR_T *_dmadesc = (buffer_id == 2) ? _dmadesc_c : (buffer_id == 1) ? _dmadesc_b : _dmadesc_a;
+
+    if (_dmadesc == nullptr || index >= _dmadesc_count)
+    {
+      ESP_LOGE("S3", "No DMA descriptor %u to update.", (unsigned int)index);
+      return;
+    }
+
+    _dmadesc[index].buffer = data;
+    _dmadesc[index].dw0.size = _dmadesc[index].dw0.length = size;
+
+  } // end update_dma_desc_link
+
   void Bus_Parallel16::dma_transfer_start()
   {
     gdma_start(dma_chan, (intptr_t)&_dmadesc_a[0]); // Start DMA w/updated descriptor(s)
     esp_rom_delay_us(100);              // Must 'bake' a moment before...
     LCD_CAM.lcd_user.lcd_start = 1;        // Trigger LCD DMA transfer
+
+    _output_running = true;
     
   } // end 
 
@@ -424,29 +599,165 @@
         LCD_CAM.lcd_user.lcd_update = 1;        // Trigger LCD DMA transfer
 
         gdma_stop(dma_chan);   
+
+        _output_running = false;
         
   } // end   
 
 
-  void Bus_Parallel16::flip_dma_output_buffer(int back_buffer_id)
+  void IRAM_ATTR Bus_Parallel16::flip_dma_output_buffer(int back_buffer_id)
   {
-	  
-    if ( back_buffer_id == 1) // change across to everything 'b''
+    // every buffer's last descriptor links to the start of the buffer to change across to,
+    // including that buffer's own to setup the loop
+    dma_descriptor_t *start = (back_buffer_id == 2) ? &_dmadesc_c[0] : (back_buffer_id == 1) ? &_dmadesc_b[0] : &_dmadesc_a[0];
+
+    _dmadesc_a[_dmadesc_count-1].next = start;
+
+    if (_double_dma_buffer)
+      _dmadesc_b[_dmadesc_count-1].next = start;
+
+    if (_triple_dma_buffer)
+      _dmadesc_c[_dmadesc_count-1].next = start;
+
+    _output_next = back_buffer_id;
+    
+  } // end flip
+
+
+  void Bus_Parallel16::queue_dma_output_buffer(int buffer_id)
+  {
+    portENTER_CRITICAL(&_output_mux);
+
+    if (!_frame_event)
     {
-       _dmadesc_b[_dmadesc_count-1].next =  (dma_descriptor_t *) &_dmadesc_b[0];  // setup loop     
-       _dmadesc_a[_dmadesc_count-1].next =  (dma_descriptor_t *) &_dmadesc_b[0];  // flip across    
+      // no EOF callback to link it in, so do it now and hope for the best
+      flip_dma_output_buffer(buffer_id);
+      _output_current = _output_next = buffer_id;
+    }
+    else if (_frame_period_us && (esp_timer_get_time() - _frame_start_us) < (_frame_period_us * 3 / 4))
+    {
+      // Early enough in the frame that the DMA is nowhere near the last descriptor, so link it in now, so it is
+      // shown from the next frame. Replaces the buffer linked in next if that was never shown.
+      flip_dma_output_buffer(buffer_id);
+      _output_next   = buffer_id;
+      _output_queued = -1;
     }
     else
     {
-       _dmadesc_a[_dmadesc_count-1].next =  (dma_descriptor_t *) &_dmadesc_a[0];  // setup loop    
-       _dmadesc_b[_dmadesc_count-1].next =  (dma_descriptor_t *) &_dmadesc_a[0];  // flip across         
+      _output_queued = buffer_id;
     }
-/*   
-    previousBufferFree = false;  
-    while (!previousBufferFree);
-*/
-    
-  } // end flip
+
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::blend_dma_output_buffers(int from_id, int to_id, uint16_t frames)
+  {
+    portENTER_CRITICAL(&_output_mux);
+
+    if (!_frame_event || frames == 0)
+    {
+      // nothing to step it along, so straight across
+      flip_dma_output_buffer(to_id);
+      _blend_left = 0;
+    }
+    else
+    {
+      // from_id is on the panel, and stays linked in until the first end of frame
+      flip_dma_output_buffer(from_id);
+      _blend_from   = from_id;
+      _blend_to     = to_id;
+      _blend_frames = frames;
+      _blend_acc    = 0;
+      _blend_left   = frames;
+    }
+
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::stop_dma_output_blend()
+  {
+    portENTER_CRITICAL(&_output_mux);
+    _blend_left = 0;
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  // to_id is picked for 'frames done / frames' of the frames, the remainder carried over to the next one
+  // (error diffusion), so its share rises a little every frame rather than in runs of one buffer
+  void IRAM_ATTR Bus_Parallel16::blend_step()
+  {
+    if (_blend_left == 0 || _old_dmadesc_a != nullptr) // not while relinking, see finish_dma_desc_relink()
+      return;
+
+    _blend_left = _blend_left - 1;
+    _blend_acc += _blend_frames - _blend_left;
+
+    int buffer_id = _blend_from;
+    if (_blend_acc >= _blend_frames)
+    {
+      _blend_acc -= _blend_frames;
+      buffer_id = _blend_to;
+    }
+
+    flip_dma_output_buffer(buffer_id); // the last one is always to_id
+  }
+
+  void Bus_Parallel16::get_dma_output_buffers(int8_t &current, int8_t &next, int8_t &queued) const
+  {
+    portENTER_CRITICAL(&_output_mux);
+    current = _output_current;
+    next    = _output_next;
+    queued  = _output_queued;
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::set_frame_callback(frame_callback_t cb, void *arg)
+  {
+    _frame_cb = nullptr; // so the ISR never sees the new callback with the old arg
+    _frame_cb_arg = arg;
+    _frame_cb = cb;
+  }
+
+#ifdef USE_STATS
+  void Bus_Parallel16::get_stats(frame_stats_t &stats) const
+  {
+    portENTER_CRITICAL(&_output_mux);
+    stats = _stats;
+    portEXIT_CRITICAL(&_output_mux);
+
+    stats.now_us = esp_timer_get_time();
+  }
+
+  void Bus_Parallel16::reset_stats()
+  {
+    portENTER_CRITICAL(&_output_mux);
+    _stats.reset(esp_timer_get_time());
+    portEXIT_CRITICAL(&_output_mux);
+  }
+
+  void Bus_Parallel16::stats_flip(int buffer_id)
+  {
+    portENTER_CRITICAL(&_output_mux);
+    _stats.flip(esp_timer_get_time(), buffer_id);
+    portEXIT_CRITICAL(&_output_mux);
+  }
+#endif
+
+  bool Bus_Parallel16::wait_frames_sent(uint32_t frame_count, uint32_t timeout_ms)
+  {
+    if (!_frame_event || _frame_sem == nullptr) return false;
+
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    if (timeout == 0) timeout = 1;
+
+    _frame_waiting = true;
+    while ((int32_t)(_frames_sent - frame_count) < 0)
+    {
+      if (xSemaphoreTake(_frame_sem, timeout) != pdTRUE) break; // no frame sent within the timeout, DMA is stopped?
+    }
+    _frame_waiting = false;
+
+    return (int32_t)(_frames_sent - frame_count) >= 0;
+  }
 
 
 #endif
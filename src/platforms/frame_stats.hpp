@@ -0,0 +1,76 @@
+/*----------------------------------------------------------------------------/
+ End of frame and flip counters, only built with USE_STATS.
+
+ Kept by the Bus_Parallel16 of every platform, updated from its end of frame
+ interrupt and by flipDMABuffer(), and copied out for MatrixPanel_I2S_DMA::getStats().
+ There is no locking in here, the buses hold their own lock around all of it.
+/----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <stdint.h>
+
+struct frame_stats_t
+{
+  int64_t  reset_us = 0;               // bus time of the last reset()
+  int64_t  now_us = 0;                 // bus time the copy was taken at, filled in by the bus
+
+  uint32_t frames = 0;                 // ends of frame since reset()
+  int64_t  first_frame_us = 0;         // time of the first of them
+  int64_t  last_frame_us = 0;          // and of the last
+  uint32_t max_frame_us = 0;           // longest time between two ends of frame
+
+  uint32_t flips_applied = 0;          // flips that got to the panel
+  uint64_t flip_latency_total_us = 0;  // from the flip being requested to the end of frame the DMA moved to the new buffer at
+  uint32_t flip_latency_max_us = 0;
+
+  bool     flip_pending = false;
+  int8_t   flip_buffer = -1;
+  int64_t  flip_request_us = 0;
+
+  void reset(int64_t now)
+  {
+    *this = frame_stats_t();
+    reset_us = now;
+  }
+
+  // A flip to buffer_id was requested. A flip replacing one that hasn't reached the panel yet keeps the time of the first.
+  void flip(int64_t now, int buffer_id)
+  {
+    if (!flip_pending)
+      flip_request_us = now;
+
+    flip_pending = true;
+    flip_buffer = buffer_id;
+  }
+
+  // End of frame. 'sending' is the buffer the DMA goes on to send, or -1 if the bus doesn't keep track of it, in which case
+  // a pending flip is taken to be applied at this end of frame (it always is, unless it was made during the last descriptor).
+  // Called from the ISR, so always inlined into it.
+  inline __attribute__((always_inline)) void frame_end(int64_t now, int sending)
+  {
+    if (frames == 0)
+    {
+      first_frame_us = now;
+    }
+    else if ((uint32_t)(now - last_frame_us) > max_frame_us)
+    {
+      max_frame_us = (uint32_t)(now - last_frame_us);
+    }
+
+    last_frame_us = now;
+    frames++;
+
+    if (flip_pending && (sending < 0 || sending == flip_buffer))
+    {
+      const uint32_t latency = (uint32_t)(now - flip_request_us);
+
+      flip_latency_total_us += latency;
+      if (latency > flip_latency_max_us)
+        flip_latency_max_us = latency;
+
+      flips_applied++;
+      flip_pending = false;
+    }
+  }
+};
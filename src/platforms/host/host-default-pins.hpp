@@ -0,0 +1,21 @@
+#pragma once
+
+// Nothing is wired up on the host, these are only the numbers the output words and
+// the gpio_* shims see. Same as the original ESP32, plus an E pin for 1/32 scan panels.
+
+#define R1_PIN_DEFAULT  25
+#define G1_PIN_DEFAULT  26
+#define B1_PIN_DEFAULT  27
+#define R2_PIN_DEFAULT  14
+#define G2_PIN_DEFAULT  12
+#define B2_PIN_DEFAULT  13
+
+#define A_PIN_DEFAULT   23
+#define B_PIN_DEFAULT   19
+#define C_PIN_DEFAULT   5
+#define D_PIN_DEFAULT   17
+#define E_PIN_DEFAULT   18
+
+#define LAT_PIN_DEFAULT 4
+#define OE_PIN_DEFAULT  15
+#define CLK_PIN_DEFAULT 16
@@ -0,0 +1,556 @@
+/*********************************************************************************************
+  Host stand-in for Bus_Parallel16, plus the bits of ESP-IDF the library uses
+  (heap_caps_*, gpio_*) that the headers in platforms/host/include declare.
+
+  Refer to platforms/host/README.md
+ ********************************************************************************************/
+#if !defined(ESP_PLATFORM)
+
+  #include "host_parallel16.hpp"
+  #include <driver/gpio.h>
+
+  #include <stdlib.h>
+  #include <string.h>
+
+
+  /* ---------------------------- ESP-IDF shims ---------------------------- */
+
+  size_t host_heap_free_size          = 16 * 1024 * 1024;
+  size_t host_heap_largest_free_block = 16 * 1024 * 1024;
+
+  void *heap_caps_malloc(size_t size, uint32_t /* caps */)
+  {
+    return malloc(size);
+  }
+
+  void *heap_caps_calloc(size_t n, size_t size, uint32_t /* caps */)
+  {
+    return calloc(n, size);
+  }
+
+  void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t /* caps */)
+  {
+    void *p = nullptr;
+    if (alignment < sizeof(void *)) alignment = sizeof(void *);
+    return (posix_memalign(&p, alignment, size) == 0) ? p : nullptr;
+  }
+
+  void heap_caps_free(void *ptr)
+  {
+    free(ptr);
+  }
+
+  size_t heap_caps_get_free_size(uint32_t /* caps */)
+  {
+    return host_heap_free_size;
+  }
+
+  size_t heap_caps_get_largest_free_block(uint32_t /* caps */)
+  {
+    return host_heap_largest_free_block;
+  }
+
+  static int8_t               _gpio_levels[GPIO_NUM_MAX];
+  static host_gpio_callback_t _gpio_cb     = nullptr;
+  static void *               _gpio_cb_arg = nullptr;
+
+  esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+  {
+    return gpio_set_level(gpio_num, 0);
+  }
+
+  esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t /* mode */)
+  {
+    return (gpio_num >= 0 && gpio_num < GPIO_NUM_MAX) ? ESP_OK : ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+  {
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+      return ESP_ERR_INVALID_ARG;
+
+    _gpio_levels[gpio_num] = level ? 1 : 0;
+
+    if (_gpio_cb) _gpio_cb(gpio_num, level ? 1 : 0, _gpio_cb_arg);
+
+    return ESP_OK;
+  }
+
+  int gpio_get_level(gpio_num_t gpio_num)
+  {
+    return (gpio_num >= 0 && gpio_num < GPIO_NUM_MAX) ? _gpio_levels[gpio_num] : 0;
+  }
+
+  void host_gpio_set_callback(host_gpio_callback_t cb, void *arg)
+  {
+    _gpio_cb = cb;
+    _gpio_cb_arg = arg;
+  }
+
+
+  /* ---------------------------- Bus_Parallel16 ---------------------------- */
+
+  void Bus_Parallel16::config(const config_t& cfg)
+  {
+    _cfg = cfg;
+  }
+
+  bool Bus_Parallel16::init(void)
+  {
+    if (_cfg.bus_freq == 0)
+    {
+      ESP_LOGE("Host", "No output clock set.");
+      return false;
+    }
+
+    ESP_LOGI("Host", "Host DMA emulation, %u Hz output clock.", (unsigned int)_cfg.bus_freq);
+    return true;
+  }
+
+  void Bus_Parallel16::release(void)
+  {
+    dma_transfer_stop();
+
+    heap_caps_free(_dmadesc_a);
+    heap_caps_free(_dmadesc_b);
+    heap_caps_free(_dmadesc_c);
+
+    _dmadesc_a = nullptr;
+    _dmadesc_b = nullptr;
+    _dmadesc_c = nullptr;
+    _dmadesc_count = 0;
+  }
+
+  void Bus_Parallel16::enable_double_dma_desc(void)
+  {
+        ESP_LOGI("Host", "Enabled support for secondary DMA buffer.");
+       _double_dma_buffer = true;
+  }
+
+  void Bus_Parallel16::enable_triple_dma_desc(void)
+  {
+        ESP_LOGI("Host", "Enabled support for secondary and tertiary DMA buffers.");
+       _double_dma_buffer = true;
+       _triple_dma_buffer = true;
+  }
+
+  bool Bus_Parallel16::allocate_dma_desc_memory(size_t len)
+  {
+    heap_caps_free(_dmadesc_a);
+    heap_caps_free(_dmadesc_b);
+    heap_caps_free(_dmadesc_c);
+    _dmadesc_a = _dmadesc_b = _dmadesc_c = nullptr;
+
+    _dmadesc_count = len;
+
+    ESP_LOGD("Host", "Allocating %d bytes memory for DMA descriptors.", (int)(sizeof(HUB75_DMA_DESCRIPTOR_T) * len));
+
+    _dmadesc_a = (HUB75_DMA_DESCRIPTOR_T*)heap_caps_calloc(len, sizeof(HUB75_DMA_DESCRIPTOR_T), MALLOC_CAP_DMA);
+
+    if (_dmadesc_a == nullptr)
+    {
+      ESP_LOGE("Host", "ERROR: Couldn't malloc _dmadesc_a. Not enough memory.");
+      return false;
+    }
+
+    if (_double_dma_buffer)
+    {
+      _dmadesc_b = (HUB75_DMA_DESCRIPTOR_T*)heap_caps_calloc(len, sizeof(HUB75_DMA_DESCRIPTOR_T), MALLOC_CAP_DMA);
+
+      if (_dmadesc_b == nullptr)
+      {
+        ESP_LOGE("Host", "ERROR: Couldn't malloc _dmadesc_b. Not enough memory.");
+        _double_dma_buffer = false;
+      }
+    }
+
+    if (_triple_dma_buffer)
+    {
+      _dmadesc_c = (HUB75_DMA_DESCRIPTOR_T*)heap_caps_calloc(len, sizeof(HUB75_DMA_DESCRIPTOR_T), MALLOC_CAP_DMA);
+
+      if (_dmadesc_c == nullptr)
+      {
+        ESP_LOGE("Host", "ERROR: Couldn't malloc _dmadesc_c. Not enough memory.");
+        _triple_dma_buffer = false;
+        return false;
+      }
+    }
+
+    _dmadesc_a_idx = 0;
+    _dmadesc_b_idx = 0;
+    _dmadesc_c_idx = 0;
+
+    return true;
+  }
+
+  bool Bus_Parallel16::start_dma_desc_relink(size_t len)
+  {
+    if (_dmadesc_a == nullptr || _old_dmadesc_a != nullptr)
+    {
+      ESP_LOGE("Host", "Can't relink DMA descriptors that were never allocated, or while another relink is under way.");
+      return false;
+    }
+
+    HUB75_DMA_DESCRIPTOR_T *a = (HUB75_DMA_DESCRIPTOR_T*)heap_caps_calloc(len, sizeof(HUB75_DMA_DESCRIPTOR_T), MALLOC_CAP_DMA);
+    HUB75_DMA_DESCRIPTOR_T *b = _double_dma_buffer ? (HUB75_DMA_DESCRIPTOR_T*)heap_caps_calloc(len, sizeof(HUB75_DMA_DESCRIPTOR_T), MALLOC_CAP_DMA) : nullptr;
+    HUB75_DMA_DESCRIPTOR_T *c = _triple_dma_buffer ? (HUB75_DMA_DESCRIPTOR_T*)heap_caps_calloc(len, sizeof(HUB75_DMA_DESCRIPTOR_T), MALLOC_CAP_DMA) : nullptr;
+
+    if (a == nullptr || (_double_dma_buffer && b == nullptr) || (_triple_dma_buffer && c == nullptr))
+    {
+      ESP_LOGE("Host", "ERROR: Couldn't malloc %d DMA descriptors to relink. Not enough memory.", (int)len);
+      heap_caps_free(a);
+      heap_caps_free(b);
+      heap_caps_free(c);
+      return false;
+    }
+
+    // the old descriptors keep the output going until finish_dma_desc_relink()
+    _old_dmadesc_a     = _dmadesc_a;
+    _old_dmadesc_b     = _dmadesc_b;
+    _old_dmadesc_c     = _dmadesc_c;
+    _old_dmadesc_count = _dmadesc_count;
+
+    _dmadesc_a = a;
+    _dmadesc_b = b;
+    _dmadesc_c = c;
+
+    _dmadesc_count = len;
+
+    _dmadesc_a_idx = 0;
+    _dmadesc_b_idx = 0;
+    _dmadesc_c_idx = 0;
+
+    return true;
+  }
+
+  bool Bus_Parallel16::finish_dma_desc_relink(uint32_t timeout_ms)
+  {
+    if (_old_dmadesc_a == nullptr)
+      return true;
+
+    // as on the ESP32-S3: link the new descriptors up to go on to the buffer the old ones do, or to a queued one,
+    // and point the old ones at the new start of that buffer
+    int buffer_id = (_output_queued >= 0) ? _output_queued : _output_next;
+    _output_queued = -1;
+
+    flip_dma_output_buffer(buffer_id);
+
+    HUB75_DMA_DESCRIPTOR_T *start = (buffer_id == 2) ? &_dmadesc_c[0] : (buffer_id == 1) ? &_dmadesc_b[0] : &_dmadesc_a[0];
+
+    _old_dmadesc_a[_old_dmadesc_count-1].next = start;
+
+    if (_old_dmadesc_b)
+      _old_dmadesc_b[_old_dmadesc_count-1].next = start;
+
+    if (_old_dmadesc_c)
+      _old_dmadesc_c[_old_dmadesc_count-1].next = start;
+
+    // the DMA is done with the old descriptors once it has finished the frame it's sending, and with the output
+    // stopped it isn't using them at all
+    wait_frames_sent(_frames_sent + 2, timeout_ms);
+
+    heap_caps_free(_old_dmadesc_a);
+    heap_caps_free(_old_dmadesc_b);
+    heap_caps_free(_old_dmadesc_c);
+
+    _old_dmadesc_a = nullptr;
+    _old_dmadesc_b = nullptr;
+    _old_dmadesc_c = nullptr;
+    _old_dmadesc_count = 0;
+
+    return true;
+  }
+
+  void Bus_Parallel16::create_dma_desc_link(void *data, size_t size, int buffer_id)
+  {
+    if (size > DMA_MAX) {
+      size = DMA_MAX;
+      ESP_LOGW("Host", "Creating DMA descriptor which links to payload with size greater than MAX_DMA_LEN!");
+    }
+
+    // descriptor list and index for buffer 0 / 'a', 1 / 'b' or 2 / 'c'
+    HUB75_DMA_DESCRIPTOR_T *_dmadesc     = (buffer_id == 2) ? _dmadesc_c     : (buffer_id == 1) ? _dmadesc_b     : _dmadesc_a;
+    uint32_t               &_dmadesc_idx = (buffer_id == 2) ? _dmadesc_c_idx : (buffer_id == 1) ? _dmadesc_b_idx : _dmadesc_a_idx;
+
+    if (_dmadesc == nullptr || _dmadesc_idx >= _dmadesc_count)
+    {
+      ESP_LOGE("Host", "Attempted to create more DMA descriptors than allocated. Expecting max %u descriptors.", (unsigned int)_dmadesc_count);
+      return;
+    }
+
+    _dmadesc[_dmadesc_idx].suc_eof = (_dmadesc_idx == (_dmadesc_count-1));
+    _dmadesc[_dmadesc_idx].size = size;
+    _dmadesc[_dmadesc_idx].buffer = data;
+
+    if (_dmadesc_idx == _dmadesc_count-1) {
+        _dmadesc[_dmadesc_idx].next = &_dmadesc[0];
+        ESP_LOGV("Host", "Creating last _dmadesc descriptor which loops back to _dmadesc[0]!");
+    }
+    else {
+        _dmadesc[_dmadesc_idx].next = &_dmadesc[_dmadesc_idx+1];
+    }
+
+    _dmadesc_idx++;
+
+  } // end create_dma_desc_link
+
+  void Bus_Parallel16::update_dma_desc_link(size_t index, void *data, size_t size, int buffer_id)
+  {
+    HUB75_DMA_DESCRIPTOR_T *_dmadesc = (buffer_id == 2) ? _dmadesc_c : (buffer_id == 1) ? _dmadesc_b : _dmadesc_a;
+
+    if (_dmadesc == nullptr || index >= _dmadesc_count)
+    {
+      ESP_LOGE("Host", "No DMA descriptor %u to update.", (unsigned int)index);
+      return;
+    }
+
+    _dmadesc[index].buffer = data;
+    _dmadesc[index].size = size;
+
+  } // end update_dma_desc_link
+
+  void Bus_Parallel16::dma_transfer_start()
+  {
+    if (_dmadesc_a == nullptr || _dmadesc_a_idx == 0)
+    {
+      ESP_LOGE("Host", "No DMA descriptors to start the output with.");
+      return;
+    }
+
+    _dma_desc = &_dmadesc_a[0];
+    _dma_desc_pos = 0;
+    _frame_pos = 0;
+    _words_sent = 0;
+
+  } // end
+
+  void Bus_Parallel16::dma_transfer_stop()
+  {
+    _dma_desc = nullptr;
+    _dma_desc_pos = 0;
+
+  } // end
+
+  void Bus_Parallel16::flip_dma_output_buffer(int back_buffer_id)
+  {
+    // every buffer's last descriptor links to the start of the buffer to change across to,
+    // including that buffer's own to setup the loop
+    HUB75_DMA_DESCRIPTOR_T *start = (back_buffer_id == 2) ? &_dmadesc_c[0] : (back_buffer_id == 1) ? &_dmadesc_b[0] : &_dmadesc_a[0];
+
+    _dmadesc_a[_dmadesc_count-1].next = start;
+
+    if (_double_dma_buffer)
+      _dmadesc_b[_dmadesc_count-1].next = start;
+
+    if (_triple_dma_buffer)
+      _dmadesc_c[_dmadesc_count-1].next = start;
+
+    _output_next = back_buffer_id;
+
+  } // end flip
+
+  void Bus_Parallel16::queue_dma_output_buffer(int buffer_id)
+  {
+    if (_frame_words && _frame_pos < (_frame_words * 3 / 4))
+    {
+      // early enough in the frame, shown from the next one
+      flip_dma_output_buffer(buffer_id);
+      _output_next   = buffer_id;
+      _output_queued = -1;
+    }
+    else
+    {
+      _output_queued = buffer_id;
+    }
+  }
+
+  void Bus_Parallel16::blend_dma_output_buffers(int from_id, int to_id, uint16_t frames)
+  {
+    flip_dma_output_buffer(frames ? from_id : to_id);
+    _blend_from   = from_id;
+    _blend_to     = to_id;
+    _blend_frames = frames;
+    _blend_acc    = 0;
+    _blend_left   = frames;
+  }
+
+  void Bus_Parallel16::stop_dma_output_blend()
+  {
+    _blend_left = 0;
+  }
+
+  // as on the ESP32-S3: to_id for 'frames done / frames' of the frames, the remainder carried over
+  void Bus_Parallel16::blend_step()
+  {
+    if (_blend_left == 0 || _old_dmadesc_a != nullptr) // not while relinking, see finish_dma_desc_relink()
+      return;
+
+    _blend_left--;
+    _blend_acc += _blend_frames - _blend_left;
+
+    int buffer_id = _blend_from;
+    if (_blend_acc >= _blend_frames)
+    {
+      _blend_acc -= _blend_frames;
+      buffer_id = _blend_to;
+    }
+
+    flip_dma_output_buffer(buffer_id);
+  }
+
+  void Bus_Parallel16::get_dma_output_buffers(int8_t &current, int8_t &next, int8_t &queued) const
+  {
+    current = _output_current;
+    next    = _output_next;
+    queued  = _output_queued;
+  }
+
+  void Bus_Parallel16::set_frame_callback(frame_callback_t cb, void *arg)
+  {
+    _frame_cb = cb;
+    _frame_cb_arg = arg;
+  }
+
+#ifdef USE_STATS
+  void Bus_Parallel16::get_stats(frame_stats_t &stats) const
+  {
+    stats = _stats;
+    stats.now_us = get_time_us();
+  }
+
+  void Bus_Parallel16::reset_stats()
+  {
+    _stats.reset(get_time_us());
+  }
+
+  void Bus_Parallel16::stats_flip(int buffer_id)
+  {
+    _stats.flip(get_time_us(), buffer_id);
+  }
+#endif
+
+  bool Bus_Parallel16::wait_frames_sent(uint32_t frame_count, uint32_t /* timeout_ms */)
+  {
+    while ((int32_t)(_frames_sent - frame_count) < 0)
+    {
+      if (output_frame() == 0) break; // output stopped
+    }
+
+    return (int32_t)(_frames_sent - frame_count) >= 0;
+  }
+
+  // What the EOF callback does on the ESP32-S3
+  void Bus_Parallel16::on_frame_eof()
+  {
+    _frames_sent++;
+    _frame_words = _frame_pos;
+    _frame_pos = 0;
+
+    if (_triple_dma_buffer)
+    {
+      _output_current = _output_next;
+      if (_output_queued >= 0 && _old_dmadesc_a == nullptr) // left to finish_dma_desc_relink() while relinking
+      {
+        flip_dma_output_buffer(_output_queued);
+        _output_next   = _output_queued;
+        _output_queued = -1;
+      }
+    }
+
+    blend_step();
+
+#ifdef USE_STATS
+    // the descriptor after the last is the first of the buffer the DMA goes on to
+    _stats.frame_end(get_time_us(), get_dma_output_buffer());
+#endif
+
+    if (_frame_cb) _frame_cb(_frame_cb_arg);
+  }
+
+  size_t Bus_Parallel16::output_words(uint16_t *words, size_t count)
+  {
+    size_t sent = 0;
+
+    while (_dma_desc != nullptr && sent < count)
+    {
+      const HUB75_DMA_DESCRIPTOR_T *desc = _dma_desc;
+
+      // (update_dma_desc_link() may have shortened the payload part way through it)
+      size_t n = (desc->size > _dma_desc_pos) ? (desc->size - _dma_desc_pos) / sizeof(uint16_t) : 0;
+      if (n > count - sent) n = count - sent;
+
+      if (words)
+        memcpy(words + sent, (const uint8_t *)desc->buffer + _dma_desc_pos, n * sizeof(uint16_t));
+
+      sent          += n;
+      _dma_desc_pos += n * sizeof(uint16_t);
+      _frame_pos    += n;
+      _words_sent   += n;
+      _words_total  += n;
+
+      if (_dma_desc_pos + sizeof(uint16_t) > desc->size)
+      {
+        // payload sent, the DMA only reads 'next' now, so a flip before this point is picked up
+        _dma_desc = desc->next;
+        _dma_desc_pos = 0;
+
+        if (desc->suc_eof)
+        {
+          on_frame_eof();
+          break;
+        }
+      }
+    }
+
+    return sent;
+  }
+
+  size_t Bus_Parallel16::output_frame(std::vector<uint16_t> *words)
+  {
+    static constexpr size_t CHUNK_WORDS = 4096;
+
+    const uint32_t frame = _frames_sent;
+    size_t sent = 0;
+
+    while (_dma_desc != nullptr && _frames_sent == frame)
+    {
+      if (words == nullptr)
+      {
+        sent += output_words(nullptr, SIZE_MAX);
+        continue;
+      }
+
+      size_t at = words->size();
+      words->resize(at + CHUNK_WORDS);
+      size_t n = output_words(words->data() + at, CHUNK_WORDS);
+      words->resize(at + n);
+      sent += n;
+    }
+
+    return sent;
+  }
+
+  int Bus_Parallel16::buffer_of(const HUB75_DMA_DESCRIPTOR_T *desc) const
+  {
+    const HUB75_DMA_DESCRIPTOR_T *const lists[2][3] = { { _dmadesc_a, _dmadesc_b, _dmadesc_c }, { _old_dmadesc_a, _old_dmadesc_b, _old_dmadesc_c } };
+    const uint32_t counts[2] = { _dmadesc_count, _old_dmadesc_count };
+
+    for (int l = 0; l < 2; l++)
+      for (int id = 0; id < 3; id++)
+        if (lists[l][id] && desc >= lists[l][id] && desc < lists[l][id] + counts[l])
+          return id;
+
+    return -1;
+  }
+
+  int Bus_Parallel16::get_dma_output_buffer() const
+  {
+    return _dma_desc ? buffer_of(_dma_desc) : -1;
+  }
+
+  const HUB75_DMA_DESCRIPTOR_T *Bus_Parallel16::get_dma_descriptors(int buffer_id) const
+  {
+    return (buffer_id == 2) ? _dmadesc_c : (buffer_id == 1) ? _dmadesc_b : _dmadesc_a;
+  }
+
+#endif
@@ -0,0 +1,223 @@
+/*----------------------------------------------------------------------------/
+ Host (Linux / macOS / Windows) stand-in for the Bus_Parallel16 of the ESP32
+ and ESP32-S3 backends, so the library compiles and runs under g++ / clang.
+
+ There is no parallel output peripheral. The DMA descriptors are linked up into
+ a ring exactly as on the ESP32-S3 (every buffer's last descriptor raises the
+ end of frame and links to the start of the buffer being shown), and output_words()
+ / output_frame() walk that ring the way the GDMA does, following each descriptor's
+ 'next' pointer when its payload has been sent, and hand back the 16-bit words
+ that would have gone out on the pins.
+
+ Time on the host only moves on when the DMA is stepped, so anything waiting on
+ frames being sent (wait_frames_sent(), i.e. flipDMABuffer() and friends) runs
+ the DMA for those frames.
+
+ Refer to platforms/host/README.md
+/----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+
+#ifdef USE_STATS
+#include "../frame_stats.hpp"
+#endif
+
+#define DMA_MAX (4096-4)
+
+// Same fields as the GDMA's dma_descriptor_t that the library uses
+struct host_dma_descriptor_t
+{
+  uint32_t size;                 // payload bytes
+  uint32_t suc_eof;              // last descriptor of a frame, raises the end of frame
+  void *buffer;
+  host_dma_descriptor_t *next;
+};
+
+// The type used for this platform
+#define HUB75_DMA_DESCRIPTOR_T host_dma_descriptor_t
+
+
+//----------------------------------------------------------------------------
+
+  class Bus_Parallel16
+  {
+  public:
+    Bus_Parallel16()
+    {
+
+    }
+
+    struct config_t
+    {
+      // output clock, only used to work out timings from the words sent
+      uint32_t bus_freq = 10000000;
+      int8_t pin_wr = -1;
+      int8_t pin_rd = -1;
+      int8_t pin_rs = -1;  // D/C
+      bool   invert_pclk = false;
+      union
+      {
+        int8_t pin_data[16];
+        struct
+        {
+          int8_t pin_d0;
+          int8_t pin_d1;
+          int8_t pin_d2;
+          int8_t pin_d3;
+          int8_t pin_d4;
+          int8_t pin_d5;
+          int8_t pin_d6;
+          int8_t pin_d7;
+          int8_t pin_d8;
+          int8_t pin_d9;
+          int8_t pin_d10;
+          int8_t pin_d11;
+          int8_t pin_d12;
+          int8_t pin_d13;
+          int8_t pin_d14;
+          int8_t pin_d15;
+        };
+      };
+    };
+
+    const config_t& config(void) const { return _cfg; }
+    void  config(const config_t& config);
+
+    bool init(void) ;
+
+    void release(void) ;
+
+    void enable_double_dma_desc();
+    void enable_triple_dma_desc();
+    bool allocate_dma_desc_memory(size_t len);
+
+    // Relink the descriptors of every buffer while the output keeps running, see the ESP32-S3 backend
+    bool start_dma_desc_relink(size_t len);
+    bool finish_dma_desc_relink(uint32_t timeout_ms);
+
+    void create_dma_desc_link(void *memory, size_t size, int buffer_id = 0);
+
+    // Point descriptor 'index' of a buffer (as linked up by create_dma_desc_link()) at another payload, leaving the links
+    // as they are, for MatrixPanel_I2S_DMA::scrollHorizontal(). The DMA picks it up the next time it gets to that descriptor.
+    void update_dma_desc_link(size_t index, void *memory, size_t size, int buffer_id = 0);
+
+    void dma_transfer_start();
+    void dma_transfer_stop();
+
+    void flip_dma_output_buffer(int back_buffer_id);
+
+    // Triple buffering: linked in now if the DMA is less than 3/4 of the way through the frame, otherwise
+    // queued and linked in at the end of frame, as on the ESP32-S3.
+    void queue_dma_output_buffer(int buffer_id);
+    void get_dma_output_buffers(int8_t &current, int8_t &next, int8_t &queued) const;
+
+    // Double buffering crossfade, as on the ESP32-S3: stepped at every end of frame
+    void blend_dma_output_buffers(int from_id, int to_id, uint16_t frames);
+    void stop_dma_output_blend();
+    uint16_t get_dma_blend_frames_left() const { return _blend_left; }
+
+    // Frame complete event, raised when the DMA is done with the last (suc_eof) descriptor of a buffer
+    typedef void (*frame_callback_t)(void *arg);
+
+    uint32_t get_frames_sent() const { return _frames_sent; }
+    void set_frame_callback(frame_callback_t cb, void *arg);
+    bool wait_frames_sent(uint32_t frame_count, uint32_t timeout_ms); // runs the DMA until get_frames_sent() reaches frame_count
+
+#ifdef USE_STATS
+    // End of frame / flip counters for MatrixPanel_I2S_DMA::getStats(), times in microseconds of output (get_time_us())
+    void get_stats(frame_stats_t &stats) const;
+    void reset_stats();
+    void stats_flip(int buffer_id); // a flip to buffer_id, before it is made
+#endif
+
+    /* -------------------- Host only -------------------- */
+
+    /**
+     * @brief Run the DMA for up to 'count' words, stopping early at the end of a frame or if the output is stopped.
+     * @param words where to put the words sent, or nullptr to throw them away
+     * @returns the number of words sent
+     */
+    size_t output_words(uint16_t *words, size_t count);
+
+    /**
+     * @brief Run the DMA to the end of the frame it is sending (a whole frame if it is at the start of one).
+     * @param words the words sent are appended to it, unless nullptr
+     * @returns the number of words sent, 0 if the output isn't running
+     */
+    size_t output_frame(std::vector<uint16_t> *words = nullptr);
+
+    bool     is_running() const { return _dma_desc != nullptr; }
+    uint64_t get_words_sent() const { return _words_sent; }                   // since dma_transfer_start()
+    int64_t  get_time_us() const { return _words_total * 1000000 / _cfg.bus_freq; } // output time, all the words ever sent at bus_freq
+    size_t   get_frame_words() const { return _frame_words; }                 // words in the last complete frame
+    int      get_dma_output_buffer() const;                                   // buffer the DMA is sending from, -1 if stopped
+
+    // Descriptors of a buffer, as linked up
+    const HUB75_DMA_DESCRIPTOR_T *get_dma_descriptors(int buffer_id) const;
+    size_t get_dma_descriptor_count() const { return _dmadesc_count; }
+
+  private:
+
+    void on_frame_eof();
+    void blend_step();
+    int  buffer_of(const HUB75_DMA_DESCRIPTOR_T *desc) const;
+
+    config_t _cfg;
+
+    uint32_t _dmadesc_count  = 0;   // number of dma decriptors
+
+    uint32_t _dmadesc_a_idx  = 0;
+    uint32_t _dmadesc_b_idx  = 0;
+    uint32_t _dmadesc_c_idx  = 0;
+
+    HUB75_DMA_DESCRIPTOR_T* _dmadesc_a = nullptr;
+    HUB75_DMA_DESCRIPTOR_T* _dmadesc_b = nullptr;
+    HUB75_DMA_DESCRIPTOR_T* _dmadesc_c = nullptr; // triple buffer only
+
+    // descriptors being replaced by start_dma_desc_relink(), until finish_dma_desc_relink()
+    HUB75_DMA_DESCRIPTOR_T* _old_dmadesc_a = nullptr;
+    HUB75_DMA_DESCRIPTOR_T* _old_dmadesc_b = nullptr;
+    HUB75_DMA_DESCRIPTOR_T* _old_dmadesc_c = nullptr;
+    uint32_t                _old_dmadesc_count = 0;
+
+    bool    _double_dma_buffer = false;
+    bool    _triple_dma_buffer = false;
+
+    // the DMA: descriptor being sent (nullptr when stopped) and how far into its payload it is
+    const HUB75_DMA_DESCRIPTOR_T* _dma_desc = nullptr;
+    size_t                        _dma_desc_pos = 0;   // bytes
+
+    uint64_t                _words_sent     = 0;
+    uint64_t                _words_total    = 0;
+    size_t                  _frame_pos      = 0;       // words sent of the current frame
+    size_t                  _frame_words    = 0;       // words of the last complete frame
+
+    uint32_t                _frames_sent    = 0;
+    frame_callback_t        _frame_cb       = nullptr;
+    void *                  _frame_cb_arg   = nullptr;
+
+    // triple buffer output state
+    int8_t                  _output_current = 0;
+    int8_t                  _output_next    = 0;    // linked in by the last flip_dma_output_buffer(), triple buffered or not
+    int8_t                  _output_queued  = -1;
+
+    // crossfade state, see blend_dma_output_buffers()
+    uint16_t                _blend_frames   = 0;
+    uint16_t                _blend_left     = 0;
+    uint32_t                _blend_acc      = 0;
+    int8_t                  _blend_from     = 0;
+    int8_t                  _blend_to       = 0;
+
+#ifdef USE_STATS
+    frame_stats_t           _stats;
+#endif
+
+  };
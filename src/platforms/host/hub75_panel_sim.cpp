@@ -0,0 +1,363 @@
+/*********************************************************************************************
+  HUB75 panel simulator for the host build, see hub75_panel_sim.hpp
+
+  Refer to platforms/host/README.md
+ ********************************************************************************************/
+#if !defined(ESP_PLATFORM)
+
+  #include "hub75_panel_sim.hpp"
+  #include <driver/gpio.h>
+
+  #include <algorithm>
+  #include <stdio.h>
+  #include <string.h>
+
+  static HUB75PanelSim *_gpio_sim = nullptr;
+
+  static inline int singleBit(uint32_t v)
+  {
+    return (v != 0 && (v & (v - 1)) == 0) ? __builtin_ctz(v) : -1;
+  }
+
+  HUB75PanelSim::HUB75PanelSim(const HUB75_I2S_CFG &cfg)
+    : _cfg(cfg)
+  {
+    _width  = cfg.mx_width * cfg.chain_length;
+    _height = cfg.mx_height;
+    _rows   = cfg.mx_height / MATRIX_ROWS_IN_PARALLEL;
+
+    _counted_latch = (cfg.driver == HUB75_I2S_CFG::DP3246 || cfg.driver == HUB75_I2S_CFG::FM6124 ||
+                      cfg.driver == HUB75_I2S_CFG::FM6126A || cfg.driver == HUB75_I2S_CFG::ICN2038S);
+
+    // the library's comment on REG2 is that a single bit of it turns the output on
+    _output_enabled = !(cfg.driver == HUB75_I2S_CFG::FM6124 || cfg.driver == HUB75_I2S_CFG::FM6126A);
+
+    _shift.assign(_width, 0);
+    _latch.assign(_width, 0);
+    _on.assign((size_t)_width * _height * 3, 0);
+  }
+
+  HUB75PanelSim::~HUB75PanelSim()
+  {
+    detachGpio();
+  }
+
+  int HUB75PanelSim::selectedRow() const
+  {
+    const uint16_t addr = (_prev >> BITS_ADDR_OFFSET) & 0x1F;
+    int row;
+
+    switch (_cfg.line_decoder)
+    {
+    case HUB75_I2S_CFG::TYPE_DIRECT:
+      {
+        // active low, a line per row
+        const uint16_t mask = (_rows == 2) ? 0x3 : 0xf;
+        row = singleBit(~addr & mask);
+      }
+      break;
+
+    case HUB75_I2S_CFG::TYPE595: // SM5368: A row clock, B blanking, C row data
+      if (_prev & BIT_B)
+        return -1;
+      row = singleBit(_row_shift & (uint32_t)((1ULL << _rows) - 1));
+      break;
+
+    case HUB75_I2S_CFG::SM5266P: // A row clock, B row data, C blanking, D and E the upper address bits
+      if (_prev & BIT_C)
+        return -1;
+      row = singleBit(_row_shift & 0xFF);
+      if (row >= 0)
+        row |= addr & 0x18;
+      break;
+
+    case HUB75_I2S_CFG::TYPE138:
+    default:
+      row = addr;
+      break;
+    }
+
+    return (row < _rows) ? row : -1;
+  }
+
+  void HUB75PanelSim::clock(uint16_t word)
+  {
+    const bool lat = word & BIT_LAT;
+
+    // LAT commands act on the falling edge, before this clock shifts anything in
+    if (!lat && _lat_clocks)
+    {
+      if (_counted_latch)
+        latchCommand(_lat_clocks);
+
+      _lat_clocks = 0;
+    }
+
+    _shift[_shift_head] = word & 0x3F;
+    _shift_head = (_shift_head + 1 == (size_t)_width) ? 0 : _shift_head + 1;
+
+    if (lat)
+    {
+      _lat_clocks++;
+
+      if (!_counted_latch)
+        latchData();
+    }
+
+    // shift register row decoders clock on the rising edge of A
+    if ((word & BIT_A) && !(_prev & BIT_A))
+    {
+      if (_cfg.line_decoder == HUB75_I2S_CFG::TYPE595)
+        _row_shift = (_row_shift << 1) | ((word & BIT_C) ? 1 : 0);
+      else if (_cfg.line_decoder == HUB75_I2S_CFG::SM5266P)
+        _row_shift = (_row_shift << 1) | ((word & BIT_B) ? 1 : 0);
+    }
+
+    _prev = word;
+
+    const int selected = selectedRow();
+    const int row = ((word & BIT_OE) || !_output_enabled) ? -1 : selected; // BIT_OE high is output disabled
+
+    if (row != _run_row)
+    {
+      flush();
+      _run_row = row;
+    }
+
+    if (row >= 0)
+      _run_clocks++;
+
+    // a frame starts when row 0 is selected again
+    if (selected >= 0)
+    {
+      if (selected == 0 && _last_row != 0)
+      {
+        if (_frames_seen++ == 0)
+          _first_frame_clock = _clocks;
+        _last_frame_clock = _clocks;
+      }
+      _last_row = selected;
+    }
+
+    _clocks++;
+  }
+
+  void HUB75PanelSim::clock(const uint16_t *words, size_t count)
+  {
+    for (size_t i = 0; i < count; i++)
+      clock(words[i]);
+  }
+
+  void HUB75PanelSim::latchData()
+  {
+    flush(); // what was lit up to now was the old latch
+
+    for (int x = 0; x < _width; x++)
+    {
+      size_t i = _shift_head + x;
+      _latch[x] = _shift[(i >= (size_t)_width) ? i - _width : i];
+    }
+  }
+
+  void HUB75PanelSim::latchCommand(int lat_clocks)
+  {
+    if (lat_clocks == 11 || lat_clocks == 12)
+    {
+      // configuration register: the last 16 columns of R1, i.e. the chip at the end of the chain
+      uint16_t reg = 0;
+      for (int i = 0; i < 16 && i < _width; i++)
+      {
+        size_t col = _shift_head + (_width - 16 + i);
+        if (_shift[col % _width] & BIT_R1)
+          reg |= 1 << (15 - i);
+      }
+
+      const int n = lat_clocks - 11;
+      _reg[n] = reg;
+      _reg_writes++;
+
+      if (n == 1 && (_cfg.driver == HUB75_I2S_CFG::FM6124 || _cfg.driver == HUB75_I2S_CFG::FM6126A))
+      {
+        flush();
+        _output_enabled = (reg & (1 << (15 - 9))) != 0;
+      }
+
+      return;
+    }
+
+    // data latch: the DP3246 wants LAT for exactly 3 clocks, 3 is a vsync for the FM612x
+    if (_cfg.driver == HUB75_I2S_CFG::DP3246 ? (lat_clocks == 3) : (lat_clocks < 3))
+      latchData();
+  }
+
+  void HUB75PanelSim::flush() const
+  {
+    if (_run_row < 0 || _run_clocks == 0)
+      return;
+
+    uint64_t *upper = &_on[(size_t)_run_row * _width * 3];
+    uint64_t *lower = &_on[(size_t)(_run_row + _rows) * _width * 3];
+
+    for (int x = 0; x < _width; x++)
+    {
+      const uint8_t l = _latch[x];
+
+      for (int ch = 0; ch < 3; ch++)
+      {
+        if (l & (BIT_R1 << ch)) upper[x * 3 + ch] += _run_clocks;
+        if (l & (BIT_R2 << ch)) lower[x * 3 + ch] += _run_clocks;
+      }
+    }
+
+    _run_clocks = 0;
+  }
+
+  void HUB75PanelSim::resetExposure()
+  {
+    flush();
+    std::fill(_on.begin(), _on.end(), 0);
+
+    _exposure_start = _clocks;
+    _frames_seen = 0;
+  }
+
+  uint64_t HUB75PanelSim::onTime(int x, int y, int channel) const
+  {
+    if (x < 0 || x >= _width || y < 0 || y >= _height || channel < 0 || channel > 2)
+      return 0;
+
+    flush();
+    return _on[((size_t)y * _width + x) * 3 + channel];
+  }
+
+  std::vector<uint16_t> HUB75PanelSim::image() const
+  {
+    flush();
+
+    std::vector<uint16_t> img(_on.size(), 0);
+    const uint64_t full = (_clocks - _exposure_start) / _rows; // clocks each row is selected for, on average
+
+    if (full == 0)
+      return img;
+
+    for (size_t i = 0; i < _on.size(); i++)
+    {
+      uint64_t v = _on[i] * 65535 / full;
+      img[i] = (v > 65535) ? 65535 : (uint16_t)v;
+    }
+
+    return img;
+  }
+
+  // the PPM samples image() gives at maxval
+  static std::vector<uint8_t> ppmSamples(const std::vector<uint16_t> &img, uint16_t maxval)
+  {
+    std::vector<uint8_t> out;
+    out.reserve(img.size() * 2);
+
+    for (uint16_t v : img)
+    {
+      uint32_t s = (uint32_t)v * maxval / 65535;
+      if (maxval > 255)
+        out.push_back(s >> 8);
+      out.push_back(s & 0xFF);
+    }
+
+    return out;
+  }
+
+  bool HUB75PanelSim::writePPM(const char *path, uint16_t maxval) const
+  {
+    FILE *f = fopen(path, "wb");
+    if (f == nullptr)
+      return false;
+
+    std::vector<uint8_t> samples = ppmSamples(image(), maxval);
+
+    fprintf(f, "P6\n%d %d\n%u\n", _width, _height, (unsigned)maxval);
+    bool ok = fwrite(samples.data(), 1, samples.size(), f) == samples.size();
+
+    return (fclose(f) == 0) && ok;
+  }
+
+  long HUB75PanelSim::comparePPM(const char *path, uint16_t maxval) const
+  {
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr)
+      return -1;
+
+    int w = 0, h = 0;
+    unsigned m = 0;
+    bool header = fscanf(f, "P6 %d %d %u", &w, &h, &m) == 3 && fgetc(f) != EOF; // one whitespace after maxval
+
+    std::vector<uint8_t> samples = ppmSamples(image(), maxval);
+    std::vector<uint8_t> file(samples.size());
+
+    bool ok = header && w == _width && h == _height && m == maxval && fread(file.data(), 1, file.size(), f) == file.size();
+    fclose(f);
+
+    if (!ok)
+      return -1;
+
+    const size_t bytes = (maxval > 255) ? 2 : 1;
+    long differ = 0;
+
+    for (size_t i = 0; i < samples.size(); i += bytes)
+      if (memcmp(&samples[i], &file[i], bytes) != 0)
+        differ++;
+
+    return differ;
+  }
+
+  int HUB75PanelSim::measuredRefreshRate() const
+  {
+    if (_frames_seen < 2 || _last_frame_clock == _first_frame_clock)
+      return 0;
+
+    return (int)((uint64_t)_cfg.i2sspeed * (_frames_seen - 1) / (_last_frame_clock - _first_frame_clock));
+  }
+
+  void HUB75PanelSim::attachGpio()
+  {
+    _gpio_sim = this;
+    host_gpio_set_callback(onGpio, this);
+  }
+
+  void HUB75PanelSim::detachGpio()
+  {
+    if (_gpio_sim != this)
+      return;
+
+    _gpio_sim = nullptr;
+    host_gpio_set_callback(nullptr, nullptr);
+  }
+
+  // Clocks a word made up of the pin levels on every rising edge of CLK
+  void HUB75PanelSim::onGpio(int gpio_num, uint32_t level, void *arg)
+  {
+    HUB75PanelSim *sim = (HUB75PanelSim *)arg;
+    const HUB75_I2S_CFG::i2s_pins &p = sim->_cfg.gpio;
+
+    if (gpio_num < 0 || gpio_num >= 64)
+      return;
+
+    const uint64_t bit = 1ULL << gpio_num;
+    const bool rising = level && !(sim->_gpio_levels & bit);
+
+    sim->_gpio_levels = level ? (sim->_gpio_levels | bit) : (sim->_gpio_levels & ~bit);
+
+    if (gpio_num != p.clk || !rising)
+      return;
+
+    // same bit order as the DMA output, see BIT_R1 ... BIT_E
+    const int8_t pins[13] = {p.r1, p.g1, p.b1, p.r2, p.g2, p.b2, p.lat, p.oe, p.a, p.b, p.c, p.d, p.e};
+    uint16_t word = 0;
+
+    for (int i = 0; i < 13; i++)
+      if (pins[i] >= 0 && (sim->_gpio_levels & (1ULL << pins[i])))
+        word |= 1 << i;
+
+    sim->clock(word);
+  }
+
+#endif
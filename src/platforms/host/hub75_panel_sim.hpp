@@ -0,0 +1,106 @@
+/*----------------------------------------------------------------------------/
+ HUB75 panel simulator for the host build.
+
+ Clocks the 16-bit words the library outputs (from Bus_Parallel16::output_frame(),
+ or a logic analyser capture in the same bit order) through a model of a chain of
+ HUB75 panels: the column driver shift registers and output latches, LAT, OE, the
+ row selection of each line_decoder and the LAT pulse commands of the DP3246 and
+ FM6124 / FM6126A / ICN2038S drivers. Each clock with OE enabled lights the latched
+ columns of the selected row pair, so integrated over some frames that is the
+ brightness of every LED, BCM weighting, brightness and latch blanking included.
+
+ Refer to platforms/host/README.md
+/----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+
+class HUB75PanelSim
+{
+public:
+  explicit HUB75PanelSim(const HUB75_I2S_CFG &cfg);
+  ~HUB75PanelSim();
+
+  /* One clock of the output, i.e. one word sent */
+  void clock(uint16_t word);
+  void clock(const uint16_t *words, size_t count);
+  void clock(const std::vector<uint16_t> &words) { clock(words.data(), words.size()); }
+
+  /* Also clock the panel from the host gpio_* shims, i.e. the driver register setup begin() bit bangs.
+   * Only one simulator can be attached at a time. */
+  void attachGpio();
+  void detachGpio();
+
+  /* Start integrating the brightness and measuring the refresh rate afresh, i.e. after a warm up frame */
+  void resetExposure();
+
+  /* Clocks the LED at x, y was lit for since resetExposure(), channel 0 red, 1 green, 2 blue */
+  uint64_t onTime(int x, int y, int channel) const;
+
+  /* Brightness of every LED, RGB, 0 to 65535: the share of the time its row is selected (all clocks / rows) it was lit */
+  std::vector<uint16_t> image() const;
+
+  /* image() as a 16-bit PPM (8-bit with maxval 255) */
+  bool writePPM(const char *path, uint16_t maxval = 65535) const;
+
+  /* Number of samples that differ from a PPM written by writePPM() with the same maxval, -1 if it can't be read or is another size */
+  long comparePPM(const char *path, uint16_t maxval = 65535) const;
+
+  /* Refresh rate from the clocks between row 0 being selected, at the config's output clock. 0 until two frames are seen. */
+  int measuredRefreshRate() const;
+
+  int width() const { return _width; }
+  int height() const { return _height; }
+  uint64_t clocks() const { return _clocks; }
+  int selectedRow() const;                                  // row pair lit when OE is enabled, -1 for none
+
+  // Driver configuration registers written with LAT held for 11 / 12 clocks (DP3246, FM6124 / FM6126A / ICN2038S),
+  // the 16 bits of the chip nearest the end of the chain, first shifted in as bit 15
+  uint16_t driverReg(int n) const { return _reg[n & 1]; }
+  int driverRegWrites() const { return _reg_writes; }
+  bool outputEnabled() const { return _output_enabled; }    // FM6124 / FM6126A: not until REG2 turns the output on
+
+private:
+  void latchCommand(int lat_clocks);
+  void latchData();
+  void flush() const;
+  static void onGpio(int gpio_num, uint32_t level, void *arg);
+
+  HUB75_I2S_CFG _cfg;
+
+  int _width;                           // pixels per row, across the chain
+  int _height;
+  int _rows;                            // row pairs, i.e. rows per frame
+  bool _counted_latch;                  // LAT acts on the number of clocks it is held for (DP3246, FM612x)
+
+  std::vector<uint8_t> _shift;          // column shift registers, 6 bits a column, as a ring
+  size_t _shift_head = 0;               // oldest column = column 0
+  std::vector<uint8_t> _latch;          // column output latches
+  int _lat_clocks = 0;                  // clocks LAT has been high for
+
+  uint16_t _prev = 0;
+  uint32_t _row_shift = 0;              // TYPE595 / SM5368 / SM5266P row select shift register
+  bool _output_enabled = true;
+  uint16_t _reg[2] = {0, 0};
+  int _reg_writes = 0;
+
+  // integrated brightness, counted in runs of clocks lighting the same row with the same latch
+  mutable std::vector<uint64_t> _on;    // per LED and channel
+  int _run_row = -1;
+  mutable uint64_t _run_clocks = 0;
+
+  uint64_t _clocks = 0;
+  uint64_t _exposure_start = 0;
+  int _last_row = -1;
+  uint64_t _first_frame_clock = 0;
+  uint64_t _last_frame_clock = 0;
+  uint32_t _frames_seen = 0;
+
+  // gpio decoding
+  uint64_t _gpio_levels = 0;
+};
@@ -0,0 +1,27 @@
+// Host stand-in for the ESP-IDF header, just what the library uses. Refer to platforms/host/README.md
+//
+// The levels set are kept, and can be watched with host_gpio_set_callback(), e.g. to see the
+// FM6124 / FM6126A / ICN2038S register setup the library bit bangs before begin() starts the DMA.
+#pragma once
+
+#include <stdint.h>
+#include <esp_err.h>
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_MAX 64
+
+typedef enum {
+    GPIO_MODE_DISABLE = 0,
+    GPIO_MODE_INPUT   = 1,
+    GPIO_MODE_OUTPUT  = 2,
+} gpio_mode_t;
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num);
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+int       gpio_get_level(gpio_num_t gpio_num);
+
+// Host only: called for every gpio_set_level()
+typedef void (*host_gpio_callback_t)(gpio_num_t gpio_num, uint32_t level, void *arg);
+void host_gpio_set_callback(host_gpio_callback_t cb, void *arg);
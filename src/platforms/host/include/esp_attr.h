@@ -0,0 +1,6 @@
+// Host stand-in for the ESP-IDF header, just what the library uses. Refer to platforms/host/README.md
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
@@ -0,0 +1,28 @@
+// Host stand-in for the ESP-IDF header, just what the library uses. Refer to platforms/host/README.md
+//
+// Every allocation comes from the host heap whatever the caps. What heap_caps_get_free_size() and
+// heap_caps_get_largest_free_block() report can be set, to try out the library's memory planning
+// (e.g. the SPIRAM_DMA_BUFFER bitplane placement, or framebuffers split over several blocks).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_EXEC     (1 << 0)
+#define MALLOC_CAP_32BIT    (1 << 1)
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+
+void  *heap_caps_malloc(size_t size, uint32_t caps);
+void  *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void  *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps);
+void   heap_caps_free(void *ptr);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+// Host only: what the two above return, 16MB each to start with
+extern size_t host_heap_free_size;
+extern size_t host_heap_largest_free_block;
@@ -0,0 +1,8 @@
+// Host stand-in for the ESP-IDF header, just what the library uses. Refer to platforms/host/README.md
+//
+// There is no cache between the CPU and the 'PSRAM' on the host, so writing it back is a no-op.
+#pragma once
+
+#include <stdint.h>
+
+static inline void Cache_WriteBack_Addr(uint32_t addr, uint32_t size) { (void)addr; (void)size; }
@@ -42,8 +42,8 @@ Modified heavily for the ESP32 HUB75 DMA library by:
   #if defined(SPIRAM_DMA_BUFFER) && defined (CONFIG_IDF_TARGET_ESP32S3)       
    #pragma message "Enabling use of PSRAM/SPIRAM based DMA Buffer"
    
-   // Disable fast functions because I don't understand the interaction with DMA PSRAM and the CPU->DMA->SPIRAM Cache implications..
-   #define NO_FAST_FUNCTIONS 1
+   // The fast functions are fine with a PSRAM DMA buffer, every drawing function records the row spans it
+   // changes and MatrixPanel_I2S_DMA::commit() writes those back from the CPU cache to PSRAM in one go.
 
   #endif
 
@@ -87,6 +87,12 @@ Modified heavily for the ESP32 HUB75 DMA library by:
   
  #endif
 
+#else
+
+ // Not an ESP32 at all: build for the host (Linux, macOS, ...) to run the library under g++ / clang,
+ // with the ESP-IDF headers from platforms/host/include. Refer to platforms/host/README.md
+ #include "host/host_parallel16.hpp"
+ #include "host/host-default-pins.hpp"
 
 #endif
 
@@ -0,0 +1,389 @@
+// Host micro-benchmarks of the drawing calls, run on the PC with the host backend (src/platforms/host), across panel
+// sizes, chain lengths and colour depths. Google Benchmark style: every benchmark is run for enough iterations to take
+// --benchmark_min_time, and the results can be written as the same JSON Google Benchmark writes, so two runs can be
+// compared with its tools/compare.py, i.e. before and after a change:
+//
+//   compare.py benchmarks before.json after.json
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_bench.exe host_bench.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line)
+//
+// host_bench.exe [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>] [--benchmark_format=console|json]
+//                [--benchmark_out=<file>] [--benchmark_list_tests]
+//
+// Each iteration is one call, items_per_second is pixels written per second (buffer rows for clearFrameBuffer and
+// setBrightness, panel pixels for fadeFrame and dimFrame). setBrightnessOE() is private, so it is timed through setBrightness8() with a single buffer.
+// MatrixPanel_T::drawPixelRGB888 is only run for the setups at the build's colour depth, see panelT().
+//
+// A single 64x32 panel is run at every colour depth from 4 to 12, so building it again with -DUSE_BITPLANE_LUT and
+// comparing the two runs shows what the bitplane LUT encoder gains (or loses) at each depth. The JSON context has
+// "bitplane_lut" for which encoder a run used.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "ESP32-HUB75-MatrixPanel_T.hpp"
+#include "ESP32-HUB75-VirtualMatrixPanel_T.hpp"
+
+// The protected drawing calls, to time them directly
+class BenchPanel : public MatrixPanel_I2S_DMA
+{
+public:
+  using MatrixPanel_I2S_DMA::MatrixPanel_I2S_DMA;
+  using MatrixPanel_I2S_DMA::clearFrameBuffer;
+  using MatrixPanel_I2S_DMA::fillRectDMA;
+  using MatrixPanel_I2S_DMA::hlineDMA;
+  using MatrixPanel_I2S_DMA::vlineDMA;
+};
+
+struct Setup
+{
+  int width, height, chain, depth;
+};
+
+struct Result
+{
+  std::string name;
+  int64_t iterations;
+  double real_ns, cpu_ns;   // per iteration
+  double items_per_second;
+};
+
+// Runs 'iters' iterations of the benchmark and returns the items they processed
+typedef std::function<int64_t(int64_t iters)> bench_fn;
+
+static double min_time = 0.1;
+static FILE *console = stdout;
+
+static Result measure(const std::string &name, const bench_fn &fn)
+{
+  int64_t iters = 1;
+
+  for (;;)
+  {
+    const std::clock_t c0 = std::clock();
+    const auto t0 = std::chrono::steady_clock::now();
+    const int64_t items = fn(iters);
+    const double real = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double cpu = (double)(std::clock() - c0) / CLOCKS_PER_SEC;
+
+    // as Google Benchmark does: done once it takes min_time, otherwise again with enough more iterations to get there
+    if (real >= min_time || iters >= 1000000000)
+      return Result{name, iters, real * 1e9 / iters, cpu * 1e9 / iters, items / real};
+
+    const double multiplier = (real > min_time / 10) ? min_time * 1.4 / real : 10.0;
+    iters = (int64_t)(iters * multiplier) + 1;
+  }
+}
+
+// MatrixPanel_T::drawPixelRGB888 on a panel of its own, if the setup is the template's geometry at the build's colour depth
+template <uint16_t W, uint16_t H, uint16_t C>
+static bench_fn panelT(const Setup &s)
+{
+  if (s.width != W || s.height != H || s.chain != C || s.depth != PIXEL_COLOR_DEPTH_BITS_DEFAULT)
+    return nullptr;
+
+  auto panel = std::make_shared<MatrixPanel_T<W, H, C>>();
+  if (!panel->begin())
+    return nullptr;
+
+  return [panel](int64_t n) {
+    int x = 0, y = 0;
+    for (int64_t i = 0; i < n; i++)
+    {
+      panel->drawPixelRGB888(x, y, (uint8_t)i, (uint8_t)(i >> 3), (uint8_t)(i >> 6));
+      if (++x == W * C) { x = 0; if (++y == H) y = 0; }
+    }
+    return n;
+  };
+}
+
+static std::string setupName(const Setup &s)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%dx%d/chain:%d/depth:%d", s.width, s.height, s.chain, s.depth);
+  return buf;
+}
+
+// Benchmarks of one panel setup, appended to 'out' if their name matches the filter
+static void runSetup(const Setup &s, const std::regex &filter, bool list, std::vector<Result> &out)
+{
+  HUB75_I2S_CFG cfg(s.width, s.height, s.chain);
+  cfg.setPixelColorDepthBits(s.depth);
+
+  BenchPanel panel(cfg);
+  if (!panel.begin())
+  {
+    fprintf(stderr, "%s: begin() failed\n", setupName(s).c_str());
+    return;
+  }
+
+  const int w = s.width * s.chain;
+  const int h = s.height;
+  const int rows = h / 2; // DMA rows, each has both halves of the panel
+
+  // the chain as a virtual display, panels side by side, two rows of them from four up
+  const int vrows = (s.chain >= 4) ? 2 : 1;
+  VirtualMatrixPanel_T<CHAIN_TOP_RIGHT_DOWN> virt(vrows, s.chain / vrows, s.width, s.height);
+  virt.setDisplay(panel);
+  const int vw = s.width * (s.chain / vrows);
+  const int vh = s.height * vrows;
+
+  // a 32x32 icon (or the whole display if it's smaller), and the same encoded once as a sprite
+  const int iw = std::min(w, 32), ih = std::min(h, 32);
+  std::vector<int> icon(iw * ih);
+  std::vector<uint16_t> icon565(iw * ih);
+  for (int i = 0; i < iw * ih; i++)
+    icon[i] = icon565[i] = (uint16_t)(i * 2654435761u >> 16);
+  BitplaneSprite sprite;
+  panel.encodeSprite(sprite, icon565.data(), iw, ih);
+
+  // MatrixPanel_T has the geometry as template parameters, so only the setups it's built for here have it
+  bench_fn panel_t;
+  for (const bench_fn &fn : {panelT<64, 32, 1>(s), panelT<64, 32, 2>(s), panelT<64, 32, 4>(s), panelT<64, 64, 1>(s), panelT<64, 64, 2>(s), panelT<64, 64, 4>(s)})
+    if (fn)
+      panel_t = fn;
+
+  struct Bench
+  {
+    const char *name;
+    bench_fn fn;
+  };
+
+  const Bench benches[] = {
+    {"drawPixelRGB888", [&](int64_t n) {
+       int x = 0, y = 0;
+       for (int64_t i = 0; i < n; i++)
+       {
+         panel.drawPixelRGB888(x, y, (uint8_t)i, (uint8_t)(i >> 3), (uint8_t)(i >> 6));
+         if (++x == w) { x = 0; if (++y == h) y = 0; }
+       }
+       return n;
+     }},
+    {"MatrixPanel_T::drawPixelRGB888", panel_t},
+    {"fillScreenRGB888", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.fillScreenRGB888((uint8_t)i, 128, (uint8_t)~i);
+       return n * w * h;
+     }},
+    {"hlineDMA", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.hlineDMA(0, (int16_t)(i % h), w, (uint8_t)i, 64, 200);
+       return n * w;
+     }},
+    {"vlineDMA", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.vlineDMA((int16_t)(i % w), 0, h, (uint8_t)i, 64, 200);
+       return n * h;
+     }},
+    {"fillRectDMA", [&](int64_t n) {
+       // a quarter of the display, moving around
+       const int rw = w / 2, rh = h / 2;
+       for (int64_t i = 0; i < n; i++)
+         panel.fillRectDMA((int16_t)(i % (w - rw)), (int16_t)(i % (h - rh)), rw, rh, 200, (uint8_t)i, 64);
+       return n * rw * rh;
+     }},
+    {"copyRect", [&](int64_t n) {
+       // a quarter of the display, moved one way and back, across the halves
+       const int rw = w / 2, rh = h / 2;
+       for (int64_t i = 0; i < n; i++)
+         panel.copyRect((i & 1) ? 3 : 0, (i & 1) ? h / 2 - 3 : 0, rw, rh, (i & 1) ? 0 : 3, (i & 1) ? 0 : h / 2 - 3);
+       return n * rw * rh;
+     }},
+    {"drawIcon", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.drawIcon(icon.data(), (int16_t)(i % (w - iw + 1)), (int16_t)(i % (h - ih + 1)), iw, ih);
+       return n * iw * ih;
+     }},
+    {"drawSprite", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.drawSprite(sprite, (int16_t)(i % (w - iw + 1)), (int16_t)(i % (h - ih + 1)));
+       return n * iw * ih;
+     }},
+    {"clearFrameBuffer", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.clearFrameBuffer(0);
+       return n * rows;
+     }},
+    {"fadeFrame", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.fadeFrame(1);
+       return n * w * h;
+     }},
+    {"dimFrame", [&](int64_t n) {
+       // black is skipped, so the frame is drawn again every 8 calls (and that timed too) to keep it from getting there
+       for (int64_t i = 0; i < n; i++)
+       {
+         if ((i & 7) == 0)
+           panel.fillScreenRGB888(200, (uint8_t)i, 90);
+         panel.dimFrame(201);
+       }
+       return n * w * h;
+     }},
+    {"setBrightnessOE", [&](int64_t n) {
+       for (int64_t i = 0; i < n; i++)
+         panel.setBrightness8((uint8_t)(i & 1 ? 64 : 192));
+       return n * rows;
+     }},
+    {"VirtualMatrixPanel_T::drawPixel", [&](int64_t n) {
+       int x = 0, y = 0;
+       for (int64_t i = 0; i < n; i++)
+       {
+         virt.drawPixel(x, y, (uint16_t)(i * 2654435761u));
+         if (++x == vw) { x = 0; if (++y == vh) y = 0; }
+       }
+       return n;
+     }},
+  };
+
+  for (const Bench &b : benches)
+  {
+    const std::string name = std::string(b.name) + "/" + setupName(s);
+    if (!b.fn || !std::regex_search(name, filter))
+      continue;
+
+    if (list)
+    {
+      fprintf(console, "%s\n", name.c_str());
+      continue;
+    }
+
+    Result r = measure(name, b.fn);
+    fprintf(console, "%-56s %12.1f ns %12.1f ns %12lld %10.3fM items/s\n", r.name.c_str(), r.real_ns, r.cpu_ns, (long long)r.iterations,
+           r.items_per_second / 1e6);
+    fflush(console);
+    out.push_back(r);
+  }
+}
+
+static void writeJSON(FILE *f, const char *executable, const std::vector<Result> &results)
+{
+  char date[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+  fprintf(f, "{\n  \"context\": {\n");
+  fprintf(f, "    \"date\": \"%s\",\n", date);
+  fprintf(f, "    \"executable\": \"%s\",\n", executable);
+  fprintf(f, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+#ifdef __OPTIMIZE__
+  fprintf(f, "    \"library_build_type\": \"release\",\n");
+#else
+  fprintf(f, "    \"library_build_type\": \"debug\",\n");
+#endif
+#ifdef USE_BITPLANE_LUT
+  fprintf(f, "    \"bitplane_lut\": true,\n");
+#else
+  fprintf(f, "    \"bitplane_lut\": false,\n");
+#endif
+  fprintf(f, "    \"pixel_color_depth_bits\": %d\n", PIXEL_COLOR_DEPTH_BITS);
+  fprintf(f, "  },\n  \"benchmarks\": [\n");
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const Result &r = results[i];
+    fprintf(f, "    {\n");
+    fprintf(f, "      \"name\": \"%s\",\n", r.name.c_str());
+    fprintf(f, "      \"family_index\": %zu,\n", i);
+    fprintf(f, "      \"per_family_instance_index\": 0,\n");
+    fprintf(f, "      \"run_name\": \"%s\",\n", r.name.c_str());
+    fprintf(f, "      \"run_type\": \"iteration\",\n");
+    fprintf(f, "      \"repetitions\": 1,\n");
+    fprintf(f, "      \"repetition_index\": 0,\n");
+    fprintf(f, "      \"threads\": 1,\n");
+    fprintf(f, "      \"iterations\": %lld,\n", (long long)r.iterations);
+    fprintf(f, "      \"real_time\": %.6e,\n", r.real_ns);
+    fprintf(f, "      \"cpu_time\": %.6e,\n", r.cpu_ns);
+    fprintf(f, "      \"time_unit\": \"ns\",\n");
+    fprintf(f, "      \"items_per_second\": %.6e\n", r.items_per_second);
+    fprintf(f, "    }%s\n", (i + 1 < results.size()) ? "," : "");
+  }
+
+  fprintf(f, "  ]\n}\n");
+}
+
+static const char *option(const char *arg, const char *name)
+{
+  const size_t len = strlen(name);
+  return (strncmp(arg, name, len) == 0 && arg[len] == '=') ? arg + len + 1 : nullptr;
+}
+
+int main(int argc, char **argv)
+{
+  std::string filter = ".";
+  const char *out_path = nullptr;
+  bool json = false, list = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const char *v;
+    if ((v = option(argv[i], "--benchmark_filter")))
+      filter = v;
+    else if ((v = option(argv[i], "--benchmark_min_time")))
+      min_time = atof(v);
+    else if ((v = option(argv[i], "--benchmark_format")))
+      json = !strcmp(v, "json");
+    else if ((v = option(argv[i], "--benchmark_out")))
+      out_path = v;
+    else if (!strcmp(argv[i], "--benchmark_list_tests"))
+      list = true;
+    else
+    {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  const Setup setups[] = {
+    {64, 32, 1, 4}, {64, 32, 1, 5}, {64, 32, 1, 6}, {64, 32, 1, 7}, {64, 32, 1, 8}, // every depth, see USE_BITPLANE_LUT above
+    {64, 32, 1, 9}, {64, 32, 1, 10}, {64, 32, 1, 11}, {64, 32, 1, 12},
+    {64, 32, 2, 8},
+    {64, 32, 4, 4}, {64, 32, 4, 8}, {64, 32, 4, 12},
+    {64, 64, 1, 8},
+    {64, 64, 2, 4}, {64, 64, 2, 8}, {64, 64, 2, 12},
+    {64, 64, 4, 8},
+  };
+
+  // the console table goes to stderr when the JSON goes to stdout
+  if (json && !out_path)
+    console = stderr;
+
+  const std::regex re(filter);
+  std::vector<Result> results;
+
+  if (!list)
+    fprintf(console, "%-56s %15s %15s %12s %21s\n", "Benchmark", "Time", "CPU", "Iterations", "");
+
+  for (const Setup &s : setups)
+    runSetup(s, re, list, results);
+
+  if (list)
+    return 0;
+
+  if (out_path)
+  {
+    FILE *f = fopen(out_path, "w");
+    if (f == nullptr)
+    {
+      fprintf(stderr, "can't write %s\n", out_path);
+      return 1;
+    }
+    writeJSON(f, argv[0], results);
+    fclose(f);
+  }
+  else if (json)
+    writeJSON(stdout, argv[0], results);
+
+  return results.empty() ? 1 : 0;
+}
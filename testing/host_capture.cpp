@@ -0,0 +1,260 @@
+// Runs the library on the host (platforms/host) and checks the 16-bit words the emulated DMA sends out:
+// the length of a frame, every bitplane of every row with the LAT pulse at its end, flips only showing
+// from the next frame, a crossfade between the two buffers, a colour depth change made half way through a frame (or
+// a crossfade), and triple buffered flips early and late in a frame (and queued over a colour depth change).
+// Add -DUSE_DIRTY_TRACKING to check a flip leaves the buffer still on the panel alone until it's free.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_capture.exe host_capture.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line)
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+
+// Words in a frame: every bitplane of a row once, then the ones above the transition bit repeated for their weight
+static size_t wordsPerFrame(const HUB75_I2S_CFG &cfg, int depth)
+{
+  HUB75_I2S_CFG c = cfg;
+  c.setPixelColorDepthBits(depth);
+  const int transition_bit = HUB75Planner::plan(c).transition_bit; // 0 with FORCE_COLOR_DEPTH
+
+  size_t planes = depth;
+  for (int i = transition_bit + 1; i < depth; i++)
+    planes += 1 << (i - transition_bit - 1);
+
+  return planes * cfg.mx_width * cfg.chain_length * (cfg.mx_height / 2);
+}
+
+// Every word of the first pass over the bitplanes of each row has 'rgb' as its colour bits, and the last of each plane latches
+static bool allPlanes(const std::vector<uint16_t> &frame, const HUB75_I2S_CFG &cfg, int depth, uint16_t rgb)
+{
+  const size_t width = cfg.mx_width * cfg.chain_length;
+  const size_t row_words = frame.size() / (cfg.mx_height / 2);
+
+  for (size_t row = 0; row < cfg.mx_height / 2u; row++)
+    for (int plane = 0; plane < depth; plane++)
+      for (size_t x = 0; x < width; x++)
+      {
+        uint16_t w = frame[row * row_words + plane * width + x];
+        if ((w & RGB_BITS) != rgb || ((w & LAT_BIT) != 0) != (x == width - 1))
+          return false;
+      }
+
+  return true;
+}
+
+// Triple buffered: a flip early in a frame is shown from the next one, a late one (past 3/4 of the frame) is queued and
+// shown from the one after, and the buffer handed back for drawing is never the one being sent or the one linked in next
+static void tripleBuffer()
+{
+  HUB75_I2S_CFG cfg(64, 32, 2);
+  cfg.triple_buff = true;
+
+  MatrixPanel_I2S_DMA panel(cfg);
+  CHECK(panel.begin());
+  const int depth = cfg.getPixelColorDepthBits();
+  const size_t frame_words = wordsPerFrame(cfg, depth);
+  const uint16_t RED = 0x09; // R1 and R2
+
+  Bus_Parallel16 &bus = panel.getHostBus();
+  std::vector<uint16_t> frame;
+  int8_t current, next, queued;
+
+  // begin() shows buffer 0 and draws into 1
+  bus.output_frame();
+
+  bus.output_words(nullptr, frame_words / 4);
+  panel.fillScreenRGB888(255, 255, 255);
+  panel.flipDMABuffer();
+  bus.get_dma_output_buffers(current, next, queued);
+  CHECK(current == 0 && next == 1 && queued == -1 && panel.isBackBufferFree());
+
+  frame.clear();
+  bus.output_frame(&frame);
+  CHECK(frame.size() == frame_words - frame_words / 4 && (frame.back() & RGB_BITS) == 0); // the rest of the black one
+  frame.clear();
+  bus.output_frame(&frame);
+  CHECK(allPlanes(frame, cfg, depth, RGB_BITS));
+
+  bus.output_words(nullptr, frame_words * 7 / 8);
+  panel.fillScreenRGB888(255, 0, 0);
+  panel.flipDMABuffer();
+  bus.get_dma_output_buffers(current, next, queued);
+  CHECK(current == 1 && next == 1 && queued == 2 && panel.isBackBufferFree());
+
+  // linked in at the end of this frame, the DMA is on to the next one by then
+  bus.output_frame();
+  bus.get_dma_output_buffers(current, next, queued);
+  CHECK(current == 1 && next == 2 && queued == -1);
+  frame.clear();
+  bus.output_frame(&frame);
+  CHECK(allPlanes(frame, cfg, depth, RGB_BITS));
+  frame.clear();
+  bus.output_frame(&frame);
+  CHECK(allPlanes(frame, cfg, depth, RED));
+
+  // a flip still queued when the colour depth changes is shown all the same, from the new descriptors
+  const uint16_t BLUE = 0x24; // B1 and B2
+  bus.output_words(nullptr, frame_words * 7 / 8);
+  panel.fillScreenRGB888(0, 0, 255);
+  panel.flipDMABuffer();
+  CHECK(panel.setColorDepth(depth - 2) && panel.isBackBufferFree());
+
+  bool blue = false;
+  for (int i = 0; i < 3 && !blue; i++)
+  {
+    frame.clear();
+    bus.output_frame(&frame);
+    blue = allPlanes(frame, cfg, depth - 2, BLUE);
+  }
+  CHECK(blue && frame.size() == wordsPerFrame(cfg, depth - 2));
+
+  // a flip anywhere in a frame, up to several a frame
+  srand(11);
+  int flips = 0, waited = 0;
+  for (int i = 0; i < 300; i++)
+  {
+    bus.output_words(nullptr, rand() % (frame_words / 2));
+    const uint32_t frames = bus.get_frames_sent();
+    panel.flipDMABuffer();
+    waited += bus.get_frames_sent() != frames;
+    flips += panel.isBackBufferFree();
+  }
+  CHECK(flips == 300 && waited > 0);
+
+  printf("64x32 x2, triple buffered: %d flips, %d waited for a frame\n", flips, waited);
+}
+
+int main()
+{
+  HUB75_I2S_CFG cfg(64, 32, 2);
+  cfg.double_buff = true;
+
+  MatrixPanel_I2S_DMA panel(cfg);
+  CHECK(panel.begin());
+  const int depth = cfg.getPixelColorDepthBits();
+
+  Bus_Parallel16 &bus = panel.getHostBus();
+  CHECK(bus.is_running());
+
+  // the DMA starts on buffer 0 and white drawn into the back buffer only shows from the frame after the flip
+  panel.fillScreenRGB888(255, 255, 255);
+  panel.flipDMABuffer();
+
+  std::vector<uint16_t> frame;
+  CHECK(bus.get_dma_output_buffer() == 0);
+  CHECK(bus.output_frame(&frame) == wordsPerFrame(cfg, depth));
+  CHECK(frame.size() == wordsPerFrame(cfg, depth) && bus.get_frames_sent() == 1);
+  CHECK(allPlanes(frame, cfg, depth, 0));
+
+  frame.clear();
+  CHECK(bus.get_dma_output_buffer() == 1);
+  bus.output_frame(&frame);
+  CHECK(allPlanes(frame, cfg, depth, RGB_BITS));
+  printf("64x32 x2, %d bit: %zu words a frame, %u Hz at %u Hz clock, calculated %d Hz\n", depth, frame.size(),
+         (unsigned)(bus.config().bus_freq / frame.size()), (unsigned)bus.config().bus_freq, panel.calculated_refresh_rate);
+
+#ifdef USE_DIRTY_TRACKING
+  // built with -DUSE_DIRTY_TRACKING: the old front buffer was left alone while it could still be sent (above),
+  // and is brought up to the flipped frame once it's free
+  uint16_t r, g, b;
+  CHECK(panel.waitBackBufferFree());
+  CHECK(panel.getPixelRaw(5, 20, r, g, b) && r == 255 && g == 255 && b == 255);
+#endif
+
+  // a flip half way through a frame: the rest of the frame is still the old buffer
+  bus.output_words(nullptr, wordsPerFrame(cfg, depth) / 2);
+  panel.flipDMABuffer();
+  CHECK(bus.get_dma_output_buffer() == 1);
+  bus.output_frame();
+  CHECK(bus.get_dma_output_buffer() == 0);
+
+  // crossfade from black (0) to white (1) over 10 frames: the first one is still black, then white for 1 / 10,
+  // 2 / 10... of them, 5 in all, the last for good. The black buffer isn't free until it can't be sent again.
+  const int fade_frames = 10;
+  bus.output_words(nullptr, 1000);
+  panel.crossfadeDMABuffer(fade_frames);
+  CHECK(panel.isCrossfading() && !panel.isBackBufferFree());
+
+  std::vector<int> shown;
+  for (int i = 0; i < fade_frames + 2; i++)
+  {
+    bus.output_frame();
+    shown.push_back(bus.get_dma_output_buffer());
+  }
+  int white = 0, white_first_half = 0;
+  for (int i = 1; i <= fade_frames; i++)
+  {
+    white += shown[i];
+    white_first_half += (i <= fade_frames / 2) ? shown[i] : 0;
+  }
+  CHECK(shown[0] == 0 && white == 5 && white_first_half < 2);
+  CHECK(shown[fade_frames] == 1 && shown[fade_frames + 1] == 1);
+  CHECK(!panel.isCrossfading() && panel.isBackBufferFree());
+
+  // a flip ends a crossfade there and then
+  panel.crossfadeDMABuffer(200);
+  bus.output_frame();
+  bus.output_frame();
+  panel.flipDMABuffer();
+  CHECK(!panel.isCrossfading());
+  bus.output_frame();
+  bus.output_frame();
+  for (int i = 0; i < 20; i++)
+  {
+    CHECK(bus.get_dma_output_buffer() == 1);
+    bus.output_frame();
+  }
+
+  // a crossfade under way when the colour depth changes goes straight to its end, the black buffer 0
+  panel.crossfadeDMABuffer(200);
+  bus.output_frame();
+  bus.output_frame();
+  CHECK(panel.setColorDepth(7) && !panel.isCrossfading());
+  for (int i = 0; i < 5; i++)
+  {
+    CHECK(bus.get_dma_output_buffer() == 0);
+    bus.output_frame();
+  }
+
+  // colour depth change with the DMA part way through a frame, relinked at the end of one
+  uint32_t frames = bus.get_frames_sent();
+  bus.output_words(nullptr, 1000);
+  CHECK(panel.setColorDepth(5));
+  CHECK(bus.get_frames_sent() >= frames + 2);
+
+  frame.clear();
+  bus.output_frame(&frame);
+  CHECK(frame.size() == wordsPerFrame(cfg, 5));
+  CHECK(bus.get_frame_words() == wordsPerFrame(cfg, 5));
+
+#ifdef USE_STATS
+  // built with -DUSE_STATS: ten frames at the bus clock, a flip part way through one of them visible from the next
+  panel.resetStats();
+  bus.output_words(nullptr, frame.size() / 3);
+  panel.drawPixelRGB888(0, 0, 255, 0, 0);
+  panel.flipDMABuffer();
+  for (int i = 0; i < 10; i++)
+    bus.output_frame();
+
+  MatrixPanel_I2S_DMA::stats_t stats = panel.getStats();
+  const uint32_t frame_us = (uint32_t)(frame.size() * 1000000ull / bus.config().bus_freq);
+  CHECK(stats.frames_output == 10 && stats.max_frame_us == frame_us);
+  CHECK(stats.measured_refresh_rate > 0.99f * bus.config().bus_freq / frame.size());
+  CHECK(stats.flips_requested == 1 && stats.flips_applied == 1);
+  CHECK(stats.flip_latency_avg_us > frame_us / 2 && stats.flip_latency_avg_us < frame_us);
+  CHECK(stats.pixels_written == 1);
+#endif
+
+  // stopped, nothing is sent and waiting for frames gives up
+  panel.stopDMAoutput();
+  CHECK(!bus.is_running() && bus.output_frame() == 0 && !bus.wait_frames_sent(bus.get_frames_sent() + 1, 10));
+
+  tripleBuffer();
+
+  return report();
+}
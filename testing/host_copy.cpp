@@ -0,0 +1,105 @@
+// Runs the library on the host and checks copyRect(): the colour depth values read back from the bitplanes must be
+// those of a plain copy of the rectangle (memmove() style where it overlaps, clipped to the panel), and the control
+// bits of every word sent must stay as they were, with and without hscroll / vscroll. Add -DUSE_SHADOW_BUFFER to check
+// the shadow buffer is moved to match.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_copy.exe host_copy.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line)
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+
+struct copy_t
+{
+  int sx, sy, w, h, dx, dy;
+};
+
+// overlapping every way, across the halves, odd column offsets, and off the panel at either end
+static const copy_t COPIES[] = {
+  {0, 0, 10, 6, 3, 0},   {3, 0, 10, 6, 0, 0},     {5, 5, 20, 20, 6, 7},  {6, 7, 20, 20, 5, 5},
+  {2, 10, 30, 12, 2, 9}, {2, 9, 30, 12, 2, 10},   {0, 0, 64, 16, 1, 16}, {40, 20, 50, 50, 10, -5},
+  {-8, -3, 20, 10, 30, 3}, {100, 2, 40, 5, 0, 0}, {7, 1, 1, 1, 8, 30},   {0, 0, 300, 300, 0, 0},
+};
+
+// the same copy of the model frame (see rawFrame()), pixel by pixel from a snapshot
+static void modelCopy(std::vector<uint16_t> &frame, int width, int height, const copy_t &c)
+{
+  const std::vector<uint16_t> before = frame;
+  for (int j = 0; j < c.h; j++)
+    for (int i = 0; i < c.w; i++)
+    {
+      int sx = c.sx + i, sy = c.sy + j, dx = c.dx + i, dy = c.dy + j;
+      if (sx >= 0 && sy >= 0 && dx >= 0 && dy >= 0 && sx < width && dx < width && sy < height && dy < height)
+        for (int k = 0; k < 3; k++)
+          frame[(dy * width + dx) * 3 + k] = before[(sy * width + sx) * 3 + k];
+    }
+}
+
+static void run(const char *name, HUB75_I2S_CFG cfg, int scroll_x, int scroll_y)
+{
+  const int width = cfg.mx_width * cfg.chain_length, height = cfg.mx_height;
+
+  cfg.hscroll = scroll_x != 0;
+  MatrixPanel_I2S_DMA panel(cfg);
+  CHECK(panel.begin());
+  panel.setBrightness8(150);
+
+  if (scroll_x)
+    CHECK(panel.scrollHorizontal(scroll_x));
+  if (scroll_y)
+    CHECK(panel.scrollVertical(scroll_y));
+
+  // a different colour everywhere, so a pixel out of place shows
+  srand(3);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      panel.drawPixelRGB888(x, y, (x * 7 + y) & 0xFF, rand() & 0xFF, (y * 9) & 0xFF);
+
+#ifdef USE_SHADOW_BUFFER
+  panel.reencode(); // the colours as the shadow buffer has them, i.e. rounded to RGB565
+#endif
+
+  const std::vector<uint16_t> ctrl = controlBits(panel);
+  std::vector<uint16_t> model = rawFrame(panel, width, height);
+
+  int matched = 0;
+  for (const copy_t &c : COPIES)
+  {
+    panel.copyRect(c.sx, c.sy, c.w, c.h, c.dx, c.dy);
+    modelCopy(model, width, height, c);
+
+    bool same = (rawFrame(panel, width, height) == model) && (controlBits(panel) == ctrl);
+    if (!same)
+      printf("%s: copyRect(%d, %d, %d, %d, %d, %d) doesn't match\n", name, c.sx, c.sy, c.w, c.h, c.dx, c.dy);
+    matched += same;
+  }
+  CHECK(matched == (int)(sizeof(COPIES) / sizeof(COPIES[0])));
+
+#ifdef USE_SHADOW_BUFFER
+  // the shadow buffer encodes to the same frame again
+  panel.reencode();
+  CHECK(rawFrame(panel, width, height) == model);
+#endif
+
+  printf("%-10s %dx%d, scrolled %d,%d: %d copies\n", name, width, height, scroll_x, scroll_y, matched);
+}
+
+int main()
+{
+  for (const test_cfg_t &t : depthConfigs())
+  {
+    run(t.name, t.cfg, 0, 0);
+    run(t.name, t.cfg, 38, t.cfg.mx_height / 3); // even, for the ESP32 FIFO order
+  }
+
+  // nothing before begin()
+  MatrixPanel_I2S_DMA panel(HUB75_I2S_CFG(64, 32, 1));
+  panel.copyRect(0, 0, 10, 10, 5, 5);
+
+  return report();
+}
@@ -0,0 +1,86 @@
+// Runs the library on the host and checks fadeFrame() and dimFrame(): the colour depth values read back from the bitplanes
+// must be exactly the ones drawn shifted down / multiplied by numerator / 256, and the control bits of every word sent must
+// stay as they were. Add -DUSE_SHADOW_BUFFER to check the shadow buffer is faded to match.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_fade.exe host_fade.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line)
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+
+static void run(const char *name, HUB75_I2S_CFG cfg)
+{
+  const int width = cfg.mx_width * cfg.chain_length, height = cfg.mx_height;
+
+  MatrixPanel_I2S_DMA panel(cfg);
+  CHECK(panel.begin());
+  panel.setBrightness8(150);
+
+  // every level of every channel somewhere, and some black
+  srand(7);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      if ((x + y) % 5)
+        panel.drawPixelRGB888(x, y, rand() & 0xFF, (x * 4 + y) & 0xFF, (rand() % 3) ? 255 : rand() & 0xFF);
+
+  const std::vector<uint16_t> ctrl = controlBits(panel);
+  std::vector<uint16_t> before = rawFrame(panel, width, height);
+
+  int steps = 0;
+  auto expect = [&](const char *what, uint32_t numerator, int shift)
+  {
+    for (uint16_t &v : before)
+      v = (uint16_t)((v * numerator) >> shift);
+
+    bool same = (rawFrame(panel, width, height) == before) && (controlBits(panel) == ctrl);
+    if (!same)
+      printf("%s: %s doesn't match\n", name, what);
+    CHECK(same);
+    steps++;
+  };
+
+  panel.fadeFrame(1);
+  expect("fadeFrame(1)", 1, 1);
+
+  // finer steps, odd and even, and one that's a power of two
+  const uint8_t numerators[] = {250, 201, 77, 255, 64, 3};
+  for (uint8_t n : numerators)
+  {
+    panel.dimFrame(n);
+    expect("dimFrame()", n, 8);
+  }
+
+  panel.fadeFrame(2);
+  expect("fadeFrame(2)", 1, 2);
+
+#ifdef USE_SHADOW_BUFFER
+  // the shadow buffer encodes to the faded frame again
+  before = rawFrame(panel, width, height);
+  panel.reencode();
+  CHECK(rawFrame(panel, width, height) == before);
+#endif
+
+  // all the way down
+  panel.fadeFrame(200);
+  expect("fadeFrame(200)", 0, 0);
+
+  // black after numerator 0, from a redrawn frame
+  panel.fillScreenRGB888(255, 255, 255);
+  panel.dimFrame(0);
+  expect("dimFrame(0)", 0, 0);
+
+  printf("%-12s %dx%d, %d bit: %d fades\n", name, width, height, cfg.getPixelColorDepthBits(), steps);
+}
+
+int main()
+{
+  for (const test_cfg_t &t : depthConfigs())
+    run(t.name, t.cfg);
+
+  return report();
+}
@@ -0,0 +1,101 @@
+// Runs the library on the host and clocks what the emulated DMA sends out through the HUB75 panel simulator
+// (src/platforms/host/hub75_panel_sim.hpp), for a test pattern on a few driver / line decoder setups. Each
+// brightness image is checked against the golden one in golden/, and the refresh rate the simulated panel sees
+// against calculated_refresh_rate.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_panel_sim.exe host_panel_sim.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp
+//     ../src/platforms/host/host_parallel16.cpp ../src/platforms/host/hub75_panel_sim.cpp
+// (all on one line)
+//
+// host_panel_sim.exe [-u]     -u writes the golden images afresh, after a change that is meant to alter the output
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+#include "platforms/host/hub75_panel_sim.hpp"
+
+static bool update = false;
+
+// colour ramps across, down and diagonally, with a white and a black column either side
+static void drawPattern(MatrixPanel_I2S_DMA &panel, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+      if (x == 0)
+        panel.drawPixelRGB888(x, y, 255, 255, 255);
+      else if (x == width - 1)
+        panel.drawPixelRGB888(x, y, 0, 0, 0);
+      else
+        panel.drawPixelRGB888(x, y, x * 255 / (width - 1), y * 255 / (height - 1), ((x + y) * 4) & 0xFF);
+    }
+}
+
+static void run(const char *name, HUB75_I2S_CFG cfg)
+{
+  HUB75PanelSim sim(cfg);
+  sim.attachGpio(); // for the register setup of the FM6126A and DP3246
+
+  MatrixPanel_I2S_DMA panel(cfg);
+  CHECK(panel.begin());
+  panel.setBrightness8(200);
+  drawPattern(panel, cfg.mx_width * cfg.chain_length, cfg.mx_height);
+
+  Bus_Parallel16 &bus = panel.getHostBus();
+  std::vector<uint16_t> words;
+
+  // one frame to get the latches and row selection going, then three to expose
+  bus.output_frame(&words);
+  sim.clock(words);
+  sim.resetExposure();
+
+  for (int i = 0; i < 3; i++)
+  {
+    words.clear();
+    bus.output_frame(&words);
+    sim.clock(words);
+  }
+
+  const int measured = sim.measuredRefreshRate();
+  printf("%-16s %dx%d: calculated %d Hz, measured %d Hz, white %.3f, registers %04x %04x\n", name, sim.width(), sim.height(),
+         panel.calculated_refresh_rate, measured, sim.image()[0] / 65535.0,
+         sim.driverReg(0), sim.driverReg(1));
+
+  CHECK(sim.outputEnabled());
+  CHECK(measured >= panel.calculated_refresh_rate && measured <= panel.calculated_refresh_rate + 1);
+
+  // brighter to the right for red, nothing in the black column
+  CHECK(sim.onTime(cfg.mx_width - 2, 5, 0) > sim.onTime(8, 5, 0));
+  CHECK(sim.onTime(sim.width() - 1, 5, 0) == 0 && sim.onTime(sim.width() - 1, cfg.mx_height - 1, 1) == 0);
+
+  std::string path = std::string("golden/") + name + ".ppm";
+
+  if (update)
+  {
+    CHECK(sim.writePPM(path.c_str()));
+    return;
+  }
+
+  long differ = sim.comparePPM(path.c_str());
+  if (differ != 0)
+  {
+    printf("%s: %ld samples differ from %s, written to %s.new.ppm\n", name, differ, path.c_str(), name);
+    sim.writePPM((std::string(name) + ".new.ppm").c_str());
+    failures++;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  update = (argc > 1 && !strcmp(argv[1], "-u"));
+
+  for (const test_cfg_t &t : driverConfigs())
+    run(t.name, t.cfg);
+
+  return report();
+}
@@ -0,0 +1,90 @@
+// Runs the library on the host and checks MatrixPanel_T, the compile-time geometry panel, against MatrixPanel_I2S_DMA:
+// the same pixels drawn through drawPixelRGB888() and drawPixel() (both halves of the panel, off it at every edge,
+// with hscroll / vscroll) have to give every word sent the same, bitplane for bitplane and control bits and all.
+// Add -DUSE_STATS to check getStats() counts the pixels drawn through MatrixPanel_T as well, and -DUSE_DIRTY_TRACKING
+// or -DUSE_SHADOW_BUFFER to check those paths.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_panel_t.exe host_panel_t.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line)
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel_T.hpp"
+#include "host_test.hpp"
+
+template <uint16_t W, uint16_t H, uint16_t C>
+static void run(int scroll_x, int scroll_y)
+{
+  const int width = W * C, height = H;
+
+  HUB75_I2S_CFG cfg(W, H, C);
+  cfg.hscroll = scroll_x != 0;
+  MatrixPanel_T<W, H, C> panel(cfg);
+  MatrixPanel_I2S_DMA model(cfg);
+  CHECK(panel.begin() && model.begin());
+
+  for (MatrixPanel_I2S_DMA *p : {(MatrixPanel_I2S_DMA *)&panel, &model})
+  {
+    p->setBrightness8(150);
+    if (scroll_x)
+      CHECK(p->scrollHorizontal(scroll_x));
+    if (scroll_y)
+      CHECK(p->scrollVertical(scroll_y));
+  }
+
+  // every pixel, and a border of them off the panel all round
+  srand(W + H + C);
+  int drawn = 0;
+  for (int y = -3; y < height + 3; y++)
+    for (int x = -3; x < width + 3; x++)
+    {
+      const uint8_t r = rand(), g = rand(), b = rand();
+      panel.drawPixelRGB888(x, y, r, g, b);
+      model.drawPixelRGB888(x, y, r, g, b);
+      drawn += (x >= 0 && x < width && y >= 0 && y < height);
+    }
+  CHECK(drawn == width * height);
+  const bool rgb888 = frameWords(panel) == frameWords(model);
+
+  // and drawn over again, as RGB565, here and there
+  for (int i = 0; i < width * height / 3; i++)
+  {
+    const int16_t x = rand() % (width + 8) - 4, y = rand() % (height + 8) - 4;
+    const uint16_t c = rand();
+    panel.drawPixel(x, y, c);
+    model.drawPixel(x, y, c);
+  }
+  const bool rgb565 = frameWords(panel) == frameWords(model);
+
+  CHECK(rgb888);
+  CHECK(rgb565);
+
+#ifdef USE_STATS
+  CHECK(panel.getStats().pixels_written == model.getStats().pixels_written);
+#endif
+
+  printf("%dx%d, chain %d, scrolled %d,%d: %s\n", W, H, C, scroll_x, scroll_y, (rgb888 && rgb565) ? "same" : "different");
+}
+
+int main()
+{
+  run<64, 32, 2>(0, 0);
+  run<64, 32, 2>(38, 5); // even, for the ESP32 FIFO order
+  run<64, 64, 1>(0, 20);
+  run<32, 16, 3>(10, 3);
+
+  // a config for some other geometry is made to fit, begin() refuses one set with setCfg() that doesn't
+  MatrixPanel_T<64, 32, 1> panel(HUB75_I2S_CFG(128, 64, 4));
+  CHECK(panel.begin());
+  CHECK(panel.width() == 64 && panel.height() == 32);
+
+  MatrixPanel_T<64, 32, 1> other;
+  CHECK(other.setCfg(HUB75_I2S_CFG(128, 64, 1)));
+  CHECK(!other.begin());
+  CHECK(other.begin(HUB75_I2S_CFG(128, 64, 1)) && other.width() == 64);
+
+  return report();
+}
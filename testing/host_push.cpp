@@ -0,0 +1,162 @@
+// Runs the library on the host and checks the bulk drawing calls against drawPixelRGB888() / drawPixel(): pushFrameRGB888(),
+// pushRectRGB888() (whole, partial, one half of the panel, across the halves and off it at every edge), drawRowRGB888() /
+// drawRowRGB565() and updateMatrixDMABufferRowPair() with either half left out have to give every word sent the same as
+// the same pixels drawn one by one, with and without hscroll / vscroll. Add -DUSE_BITPLANE_LUT, -DUSE_DIRTY_TRACKING or
+// -DUSE_SHADOW_BUFFER to check those paths.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_push.exe host_push.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line)
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+
+// updateMatrixDMABufferRowPair() is protected
+struct Panel : public MatrixPanel_I2S_DMA
+{
+  using MatrixPanel_I2S_DMA::MatrixPanel_I2S_DMA;
+  using MatrixPanel_I2S_DMA::updateMatrixDMABufferRowPair;
+};
+
+struct rect_t
+{
+  int x, y, w, h;
+};
+
+// all of it, a corner, within the top half, the bottom half, across the two, one pixel, a column, off the panel at every
+// edge, all round it, and nothing at all
+static const rect_t RECTS[] = {
+  {0, 0, 64, 32},  {0, 0, 17, 9},   {5, 2, 40, 10},   {7, 20, 33, 9},  {3, 10, 50, 13},  {63, 31, 1, 1}, {9, 0, 1, 64},
+  {-5, 4, 20, 6},  {100, 3, 40, 8}, {20, -7, 12, 15}, {30, 25, 8, 20}, {-10, -10, 300, 300}, {200, 5, 3, 3}, {4, 4, 0, 5}, {4, 4, 5, -2},
+};
+
+static std::vector<uint8_t> randomRGB(size_t pixels)
+{
+  std::vector<uint8_t> rgb(pixels * 3);
+  for (uint8_t &c : rgb)
+    c = rand();
+  return rgb;
+}
+
+static void run(const char *name, HUB75_I2S_CFG cfg, int scroll_x, int scroll_y)
+{
+  const int width = cfg.mx_width * cfg.chain_length, height = cfg.mx_height, rows = height / 2;
+
+  cfg.hscroll = scroll_x != 0;
+  Panel panel(cfg), model(cfg);
+  CHECK(panel.begin() && model.begin());
+
+  for (MatrixPanel_I2S_DMA *p : {(MatrixPanel_I2S_DMA *)&panel, (MatrixPanel_I2S_DMA *)&model})
+  {
+    p->setBrightness8(150);
+    if (scroll_x)
+      CHECK(p->scrollHorizontal(scroll_x));
+    if (scroll_y)
+      CHECK(p->scrollVertical(scroll_y));
+  }
+
+  srand(width + height + scroll_x);
+  int matched = 0, tried = 0;
+
+  // the whole frame
+  std::vector<uint8_t> rgb = randomRGB(width * height);
+  panel.pushFrameRGB888(rgb.data());
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      model.drawPixelRGB888(x, y, rgb[(y * width + x) * 3], rgb[(y * width + x) * 3 + 1], rgb[(y * width + x) * 3 + 2]);
+  CHECK(frameWords(panel) == frameWords(model));
+
+  // rectangles, scaled to the panel
+  for (const rect_t &r : RECTS)
+  {
+    const int x = r.x * width / 64, y = r.y * height / 32, w = r.w * width / 64, h = r.h * height / 32;
+    rgb = randomRGB(w > 0 && h > 0 ? w * h : 0);
+
+    panel.pushRectRGB888(x, y, w, h, rgb.data());
+    for (int j = 0; j < h; j++)
+      for (int i = 0; i < w; i++)
+        model.drawPixelRGB888(x + i, y + j, rgb[(j * w + i) * 3], rgb[(j * w + i) * 3 + 1], rgb[(j * w + i) * 3 + 2]);
+
+    const bool same = (frameWords(panel) == frameWords(model));
+    if (!same)
+      printf("%s: pushRectRGB888(%d, %d, %d, %d) doesn't match\n", name, x, y, w, h);
+    matched += same;
+    tried++;
+  }
+
+  // rows, RGB888 and RGB565, hanging off either end or not
+  for (int i = 0; i < 40; i++)
+  {
+    const int y = rand() % (height + 4) - 2, x0 = rand() % (width + 20) - 10, len = rand() % (width + 10);
+    if (i & 1)
+    {
+      std::vector<uint16_t> rgb565(len);
+      for (uint16_t &c : rgb565)
+        c = rand();
+      panel.drawRowRGB565(y, rgb565.data(), x0, len);
+      for (int k = 0; k < len; k++)
+        model.drawPixel(x0 + k, y, rgb565[k]);
+    }
+    else
+    {
+      rgb = randomRGB(len);
+      panel.drawRowRGB888(y, rgb.data(), x0, len);
+      for (int k = 0; k < len; k++)
+        model.drawPixelRGB888(x0 + k, y, rgb[k * 3], rgb[k * 3 + 1], rgb[k * 3 + 2]);
+    }
+
+    const bool same = (frameWords(panel) == frameWords(model));
+    if (!same)
+      printf("%s: drawRowRGB%s(%d, %d, %d) doesn't match\n", name, (i & 1) ? "565" : "888", y, x0, len);
+    matched += same;
+    tried++;
+  }
+
+  // both halves of a DMA row, or just the top or the bottom one
+  for (int i = 0; i < 30; i++)
+  {
+    const int row = rand() % rows, x = rand() % width, len = 1 + rand() % (width - x);
+    std::vector<uint8_t> upper = randomRGB(len), lower = randomRGB(len);
+    const bool has_upper = (i % 3) != 1, has_lower = (i % 3) != 2;
+
+    panel.updateMatrixDMABufferRowPair(x, row, len, has_upper ? upper.data() : nullptr, has_lower ? lower.data() : nullptr);
+    for (int k = 0; k < len; k++)
+    {
+      if (has_upper)
+        model.drawPixelRGB888(x + k, row, upper[k * 3], upper[k * 3 + 1], upper[k * 3 + 2]);
+      if (has_lower)
+        model.drawPixelRGB888(x + k, row + rows, lower[k * 3], lower[k * 3 + 1], lower[k * 3 + 2]);
+    }
+
+    const bool same = (frameWords(panel) == frameWords(model));
+    if (!same)
+      printf("%s: updateMatrixDMABufferRowPair(%d, %d, %d, %s) doesn't match\n", name, x, row, len, has_upper ? (has_lower ? "both" : "upper") : "lower");
+    matched += same;
+    tried++;
+  }
+
+  CHECK(matched == tried);
+
+  printf("%-10s %dx%d, scrolled %d,%d: %d of %d match\n", name, width, height, scroll_x, scroll_y, matched, tried);
+}
+
+int main()
+{
+  for (const test_cfg_t &t : depthConfigs())
+  {
+    run(t.name, t.cfg, 0, 0);
+    run(t.name, t.cfg, 38, t.cfg.mx_height / 3); // even, for the ESP32 FIFO order
+  }
+
+  // nothing before begin()
+  MatrixPanel_I2S_DMA panel(HUB75_I2S_CFG(64, 32, 1));
+  const uint8_t pixel[3] = {255, 255, 255};
+  panel.pushRectRGB888(0, 0, 1, 1, pixel);
+  panel.pushFrameRGB888(nullptr);
+
+  return report();
+}
@@ -0,0 +1,201 @@
+// Runs the library on the host and checks scrollHorizontal() and scrollVertical() with the HUB75 panel simulator:
+// a panel scrolled by some amounts must light exactly the same as one that isn't, with the pattern drawn moved
+// along by the same amount, for a few driver / line decoder setups. Drawing, reading back, brightness and colour
+// depth changes after scrolling are checked the same way.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_scroll.exe host_scroll.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp
+//     ../src/platforms/host/host_parallel16.cpp ../src/platforms/host/hub75_panel_sim.cpp
+// (all on one line)
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+#include "platforms/host/hub75_panel_sim.hpp"
+
+// a different colour in every column and row, so any column out of place shows
+static void colourAt(int x, int y, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+  r = (x * 37) & 0xFF;
+  g = (y * 53 + x) & 0xFF;
+  b = (x == 0) ? 255 : ((x * y) & 0x7F);
+}
+
+// the pattern as it is after scrolling by 'sx' columns and 'sy' rows, i.e. x,y showing what was drawn at x + sx, y + sy
+static void drawPattern(MatrixPanel_I2S_DMA &panel, int width, int height, int sx, int sy = 0)
+{
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+      uint8_t r, g, b;
+      colourAt(((x + sx) % width + width) % width, ((y + sy) % height + height) % height, r, g, b);
+      panel.drawPixelRGB888(x, y, r, g, b);
+    }
+}
+
+// a panel on its own simulator, set up with begin()
+struct SimPanel
+{
+  HUB75PanelSim sim;
+  MatrixPanel_I2S_DMA panel;
+
+  SimPanel(const HUB75_I2S_CFG &cfg) : sim(cfg), panel(cfg)
+  {
+    sim.attachGpio(); // for the register setup of the FM6126A and DP3246
+    CHECK(panel.begin());
+    sim.detachGpio();
+  }
+
+  std::vector<uint16_t> image()
+  {
+    Bus_Parallel16 &bus = panel.getHostBus();
+    std::vector<uint16_t> words;
+
+    // finish the frame being sent, the next one is the first all of whose rows have the latest changes
+    bus.output_frame();
+    bus.output_frame(&words);
+    sim.clock(words);
+    sim.resetExposure();
+
+    words.clear();
+    bus.output_frame(&words);
+    sim.clock(words);
+    return sim.image();
+  }
+};
+
+struct step_t
+{
+  int dx, dy;
+};
+
+// small steps, back again, past the end and round the other way, horizontally and then, with hscroll, both ways at once
+static const step_t H_STEPS[] = {{1, 0}, {5, 0}, {-3, 0}, {37, 0}, {-64, 0}, {200, 0}, {16, 0}, {-17, 0}, {2, 3}, {-6, -20}};
+
+// one row, the halves of just one row swapping, all of them, and all of them but one
+static const step_t V_STEPS[] = {{0, 1}, {0, 3}, {0, -2}, {0, 16}, {0, 17}, {0, -40}, {0, 31}, {0, 32}, {0, -1}};
+
+static void run(const char *name, HUB75_I2S_CFG cfg, bool hscroll)
+{
+  const int width = cfg.mx_width * cfg.chain_length, height = cfg.mx_height;
+
+  cfg.hscroll = hscroll;
+  SimPanel scrolled(cfg);
+  // the reference is always drawn on and shown straight away
+  HUB75_I2S_CFG ref_cfg = cfg;
+  ref_cfg.hscroll = false;
+  ref_cfg.double_buff = false;
+  SimPanel reference(ref_cfg);
+
+  // two descriptors per bitplane pass with hscroll
+  Bus_Parallel16 &bus = scrolled.panel.getHostBus();
+  CHECK(bus.get_dma_descriptor_count() == MatrixPanel_I2S_DMA::getMemoryReport(scrolled.panel.getCfg()).dma_descriptors);
+
+  scrolled.panel.setBrightness8(200);
+  reference.panel.setBrightness8(200);
+  drawPattern(scrolled.panel, width, height, 0);
+
+  // double buffered, both buffers get the pattern and scroll together
+  if (cfg.double_buff)
+  {
+    scrolled.panel.flipDMABuffer();
+    drawPattern(scrolled.panel, width, height, 0);
+  }
+
+  // part way through a frame, as a sketch would be
+  const step_t *steps = hscroll ? H_STEPS : V_STEPS;
+  const int n_steps = hscroll ? sizeof(H_STEPS) / sizeof(H_STEPS[0]) : sizeof(V_STEPS) / sizeof(V_STEPS[0]);
+  int sx = 0, sy = 0, matched = 0;
+
+  for (int i = 0; i < n_steps; i++)
+  {
+    bus.output_words(nullptr, 1234);
+    if (steps[i].dx)
+      CHECK(scrolled.panel.scrollHorizontal(steps[i].dx));
+    if (steps[i].dy)
+      CHECK(scrolled.panel.scrollVertical(steps[i].dy));
+
+    sx = ((sx + steps[i].dx) % width + width) % width;
+    sy = ((sy + steps[i].dy) % height + height) % height;
+    CHECK(scrolled.panel.getScrollX() == sx && scrolled.panel.getScrollY() == sy);
+
+    drawPattern(reference.panel, width, height, sx, sy);
+    std::vector<uint16_t> expected = reference.image();
+    bool same = (scrolled.image() == expected);
+
+    if (cfg.double_buff)
+    {
+      scrolled.panel.flipDMABuffer();
+      same = same && (scrolled.image() == expected);
+    }
+
+    matched += same;
+  }
+
+  CHECK(matched == n_steps);
+
+  const char *how = hscroll ? (sy ? "hscroll + vertical" : "hscroll") : "vertical";
+
+  if (cfg.double_buff)
+  {
+    printf("%-16s %dx%d x2, %s: %d scrolls, %u descriptors a buffer\n", name, width, height, how, matched, (unsigned)bus.get_dma_descriptor_count());
+    return;
+  }
+
+  // drawing and reading back are in panel co-ordinates, whatever the scroll
+  uint8_t r, g, b, er, eg, eb;
+  CHECK(scrolled.panel.getPixelRGB(3, 7, r, g, b));
+  colourAt((3 + sx) % width, (7 + sy) % height, er, eg, eb);
+  CHECK(abs(r - er) < 8 && abs(g - eg) < 8 && abs(b - eb) < 8);
+
+  for (MatrixPanel_I2S_DMA *p : {&scrolled.panel, &reference.panel})
+  {
+    p->fillRect(width - 9, 2, 12, 20, 0x07E0);      // runs across the ends of the scrolled rows
+    p->drawFastVLine(width - 1, 0, height, 0xF800);
+    p->drawPixelRGB888(0, height - 1, 255, 255, 255);
+
+    std::vector<uint8_t> rgb(width * 3, 0x40);
+    p->drawRowRGB888(height / 2 + 1, rgb.data(), 0, width);
+  }
+  CHECK(scrolled.image() == reference.image());
+
+  std::vector<uint8_t> row_a(width * 3), row_b(width * 3);
+  CHECK(scrolled.panel.readRow(5, row_a.data(), 0, width) == width && reference.panel.readRow(5, row_b.data(), 0, width) == width);
+  CHECK(row_a == row_b);
+
+  // brightness and colour depth changes keep the control bits where the rows start now, and the row addresses
+  scrolled.panel.setBrightness8(90);
+  reference.panel.setBrightness8(90);
+  CHECK(scrolled.panel.setColorDepth(5) && reference.panel.setColorDepth(5));
+  CHECK(hscroll ? scrolled.panel.scrollHorizontal(-2) : scrolled.panel.scrollVertical(-2));
+  drawPattern(reference.panel, width, height, 0);
+  drawPattern(scrolled.panel, width, height, 0);
+  CHECK(scrolled.image() == reference.image());
+
+  printf("%-16s %dx%d, %s: %d scrolls, %u descriptors a buffer\n", name, width, height, how, matched, (unsigned)bus.get_dma_descriptor_count());
+}
+
+int main()
+{
+  for (bool hscroll : {true, false})
+  {
+    for (const test_cfg_t &t : driverConfigs())
+      run(t.name, t.cfg, hscroll);
+
+    HUB75_I2S_CFG cfg(64, 32, 2);
+    cfg.double_buff = true;
+    run("shiftreg_138", cfg, hscroll);
+  }
+
+  // not before begin() or without hscroll
+  HUB75_I2S_CFG plain(64, 32, 1);
+  MatrixPanel_I2S_DMA panel(plain);
+  CHECK(!panel.scrollHorizontal(1) && !panel.scrollVertical(1));
+  CHECK(panel.begin() && !panel.scrollHorizontal(1));
+
+  return report();
+}
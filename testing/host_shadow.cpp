@@ -0,0 +1,248 @@
+// Runs the library on the host and checks the shadow buffer: readPixel() gives back what was drawn (rounded to RGB565 with
+// USE_SHADOW_BUFFER=565), drawing with setDeferredEncode() leaves every word sent alone until reencodeDirty() / reencode()
+// and then gives the same words as drawing straight away, blendPixelRGB888() blends over what readPixel() has, and after
+// copyRect() the shadow buffer is copied along and still encodes to the words sent, and after fadeFrame(), dimFrame() and
+// drawSprite() it has what getPixelRGB() reads back. Build it both ways, and add -DUSE_STATS to check reencodeDirty()
+// only encodes the row spans drawn to.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -DUSE_SHADOW_BUFFER -I../src -I../src/platforms/host/include -o host_shadow.exe host_shadow.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line, and again with -DUSE_SHADOW_BUFFER=565)
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+
+#ifndef USE_SHADOW_BUFFER
+#error "Build with -DUSE_SHADOW_BUFFER or -DUSE_SHADOW_BUFFER=565"
+#endif
+
+struct rgb_t
+{
+  uint8_t r, g, b;
+  bool operator==(const rgb_t &o) const { return r == o.r && g == o.g && b == o.b; }
+};
+
+// a colour as the shadow buffer keeps it
+static rgb_t stored(uint8_t r, uint8_t g, uint8_t b)
+{
+#if SHADOW_BYTES_PER_PIXEL == 2
+  MatrixPanel_I2S_DMA::color565to888(MatrixPanel_I2S_DMA::color565(r, g, b), r, g, b);
+#endif
+  return {r, g, b};
+}
+
+// readPixel() of every pixel
+static std::vector<rgb_t> shadowFrame(MatrixPanel_I2S_DMA &panel, int width, int height)
+{
+  std::vector<rgb_t> shadow(width * height);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      CHECK(panel.readPixel(x, y, shadow[y * width + x].r, shadow[y * width + x].g, shadow[y * width + x].b));
+  return shadow;
+}
+
+// the shadow buffer has what getPixelRGB() reads back from the bitplanes, as it keeps it
+static bool readsBack(MatrixPanel_I2S_DMA &panel, int width, int height)
+{
+#ifndef NO_CIE1931
+  // the CIE1931 table is for PIXEL_COLOR_DEPTH_BITS, with fewer bitplanes only its low bits are kept, they don't read back
+  if (panel.getCfg().getPixelColorDepthBits() < PIXEL_COLOR_DEPTH_BITS)
+    return true;
+#endif
+
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+      rgb_t shadow, planes;
+      panel.readPixel(x, y, shadow.r, shadow.g, shadow.b);
+      panel.getPixelRGB(x, y, planes.r, planes.g, planes.b);
+      if (!(shadow == stored(planes.r, planes.g, planes.b)))
+        return false;
+    }
+  return true;
+}
+
+// the shadow buffer encodes to exactly the words being sent. Not so with an RGB565 one, drawn to with RGB888 colours.
+static bool encodesTo(MatrixPanel_I2S_DMA &panel)
+{
+#if SHADOW_BYTES_PER_PIXEL == 3
+  const std::vector<uint16_t> words = frameWords(panel);
+  panel.reencode();
+  return frameWords(panel) == words;
+#else
+  (void)panel;
+  return true;
+#endif
+}
+
+static void drawRandom(MatrixPanel_I2S_DMA &panel, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      panel.drawPixelRGB888(x, y, rand(), rand(), rand());
+}
+
+static void run(const char *name, HUB75_I2S_CFG cfg, int scroll_x, int scroll_y)
+{
+  const int width = cfg.mx_width * cfg.chain_length, height = cfg.mx_height;
+
+  cfg.hscroll = scroll_x != 0;
+  MatrixPanel_I2S_DMA panel(cfg), model(cfg);
+  CHECK(panel.begin() && model.begin());
+
+  for (MatrixPanel_I2S_DMA *p : {&panel, &model})
+  {
+    p->setBrightness8(150);
+    if (scroll_x)
+      CHECK(p->scrollHorizontal(scroll_x));
+    if (scroll_y)
+      CHECK(p->scrollVertical(scroll_y));
+  }
+
+  srand(width + height + scroll_x);
+
+  // read back what was drawn, as RGB888 and RGB565, nothing off the panel
+  std::vector<rgb_t> drawn(width * height);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+      rgb_t &c = drawn[y * width + x];
+      c = {(uint8_t)rand(), (uint8_t)rand(), (uint8_t)rand()};
+      panel.drawPixelRGB888(x, y, c.r, c.g, c.b);
+      c = stored(c.r, c.g, c.b);
+    }
+  CHECK(shadowFrame(panel, width, height) == drawn);
+
+  const uint16_t c565 = 0xA5D3;
+  panel.drawPixel(3, height - 2, c565);
+  CHECK(panel.readPixel(3, height - 2) == c565);
+
+  uint8_t r, g, b;
+  CHECK(!panel.readPixel(-1, 0, r, g, b) && !panel.readPixel(width, 0, r, g, b) && !panel.readPixel(0, height, r, g, b));
+  CHECK(panel.readPixel(0, -1) == 0);
+
+  // blending over what's there: alpha 0 leaves it, 255 replaces it, anything else mixes the two, rounded
+  for (int i = 0; i < 200; i++)
+  {
+    const int x = rand() % width, y = rand() % height;
+    const uint8_t alpha = (i == 0) ? 0 : (i == 1) ? 255 : rand();
+    const rgb_t c = {(uint8_t)rand(), (uint8_t)rand(), (uint8_t)rand()};
+
+    rgb_t old;
+    panel.readPixel(x, y, old.r, old.g, old.b);
+    panel.blendPixelRGB888(x, y, c.r, c.g, c.b, alpha);
+
+    const rgb_t expected = stored((c.r * alpha + old.r * (255 - alpha) + 127) / 255, (c.g * alpha + old.g * (255 - alpha) + 127) / 255,
+                                  (c.b * alpha + old.b * (255 - alpha) + 127) / 255);
+    rgb_t now;
+    CHECK(panel.readPixel(x, y, now.r, now.g, now.b) && now == expected);
+  }
+  panel.blendPixelRGB888(-1, 2, 255, 255, 255, 255); // off the panel, nothing
+  CHECK(encodesTo(panel));
+
+  // deferred: nothing sent changes until the shadow buffer is encoded, then it's as if drawn straight away
+  drawRandom(panel, width, height);
+  panel.reencode();
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+      panel.readPixel(x, y, r, g, b);
+      model.drawPixelRGB888(x, y, r, g, b);
+    }
+  CHECK(frameWords(panel) == frameWords(model));
+
+  const std::vector<uint16_t> before = frameWords(panel);
+  panel.setDeferredEncode(true);
+
+  for (MatrixPanel_I2S_DMA *p : {&panel, &model})
+  {
+    srand(99);
+    for (int i = 0; i < 100; i++)
+      p->drawPixelRGB888(rand() % width, rand() % height, rand(), rand(), rand());
+    p->fillRect(5, 3, 20, height - 6, 0x07E0);
+    p->drawFastHLine(width - 10, height / 2, 30, 0xF81F);
+
+    std::vector<uint8_t> rgb(width * 3);
+    for (uint8_t &c : rgb)
+      c = rand();
+    p->drawRowRGB888(1, rgb.data(), 0, width);
+    p->pushRectRGB888(width / 2, height / 4, 6, height / 2, rgb.data());
+    p->blendPixelRGB888(7, 7, 255, 0, 0, 100);
+  }
+  CHECK(frameWords(panel) == before);
+
+  panel.reencodeDirty();
+  panel.setDeferredEncode(false);
+#if SHADOW_BYTES_PER_PIXEL == 2
+  model.reencode(); // drawn straight away it's encoded from the RGB888 colours, not the RGB565 ones kept
+#endif
+  CHECK(frameWords(panel) == frameWords(model));
+
+#ifdef USE_STATS
+  // only the rows drawn to, each as far as it was drawn
+  panel.setDeferredEncode(true);
+  panel.fillRect(10, 2, 7, 3, 0xFFFF);
+  panel.resetStats();
+  panel.reencodeDirty();
+  CHECK(panel.getStats().pixels_written == 7 * 3 * 2); // both halves of each DMA row are encoded
+  panel.setDeferredEncode(false);
+#endif
+
+  // the shadow buffer follows everything done to the bitplanes directly
+  drawRandom(panel, width, height);
+  panel.reencode();
+  std::vector<rgb_t> shadow = shadowFrame(panel, width, height);
+  panel.copyRect(4, 3, 30, height / 2, 9, height / 3);
+  for (int j = height / 2 - 1; j >= 0; j--)
+    for (int i = 29; i >= 0; i--)
+      if (9 + i < width && height / 3 + j < height)
+        shadow[(height / 3 + j) * width + 9 + i] = shadow[(3 + j) * width + 4 + i];
+  CHECK(shadowFrame(panel, width, height) == shadow);
+  CHECK(encodesTo(panel));
+
+  // a fade can leave bitplane values the shadow buffer colours don't encode back to (several 8 bit values encode the
+  // same), it gets the colours read back from them then. Each fade starts from the words the shadow buffer encodes to.
+  panel.fadeFrame(1);
+  CHECK(readsBack(panel, width, height));
+  panel.reencode();
+  panel.dimFrame(200);
+  CHECK(readsBack(panel, width, height));
+
+  // and a sprite the colours read back from it, only where it was drawn
+  shadow = shadowFrame(panel, width, height);
+  const int sw = 12, sh = height / 2 + 3;
+  std::vector<uint8_t> sprite_rgb(sw * sh * 3);
+  for (uint8_t &c : sprite_rgb)
+    c = rand();
+  BitplaneSprite sprite;
+  CHECK(panel.encodeSprite(sprite, sprite_rgb.data(), sw, sh));
+  panel.drawSprite(sprite, width - 7, height / 3);
+  CHECK(readsBack(panel, width, height));
+
+  for (int j = 0; j < sh; j++)
+    for (int i = 0; i < sw; i++)
+      if (width - 7 + i < width && height / 3 + j < height)
+      {
+        rgb_t &c = shadow[(height / 3 + j) * width + width - 7 + i];
+        panel.getPixelRGB(width - 7 + i, height / 3 + j, c.r, c.g, c.b);
+        c = stored(c.r, c.g, c.b);
+      }
+  CHECK(shadowFrame(panel, width, height) == shadow);
+
+  printf("%-10s %dx%d, scrolled %d,%d, RGB%d shadow: done\n", name, width, height, scroll_x, scroll_y, SHADOW_BYTES_PER_PIXEL == 2 ? 565 : 888);
+}
+
+int main()
+{
+  for (const test_cfg_t &t : depthConfigs())
+  {
+    run(t.name, t.cfg, 0, 0);
+    run(t.name, t.cfg, 38, t.cfg.mx_height / 3); // even, for the ESP32 FIFO order
+  }
+
+  return report();
+}
@@ -0,0 +1,139 @@
+// Runs the library on the host and checks encodeSprite() / drawSprite() and drawIcon(): a sprite drawn anywhere (across
+// the halves of the panel, partly off it, with hscroll / vscroll) has to leave the bitplanes exactly as drawing its pixels
+// one by one does, its transparent pixels leaving what's under them alone, and the control bits of every word sent must
+// stay as they were. Add -DUSE_SHADOW_BUFFER to check the shadow buffer gets the sprite's colours too.
+//
+// g++ -std=gnu++17 -O2 -DNO_GFX -I../src -I../src/platforms/host/include -o host_sprite.exe host_sprite.cpp
+//     ../src/ESP32-HUB75-MatrixPanel-I2S-DMA.cpp ../src/ESP32-HUB75-MatrixPanel-leddrivers.cpp ../src/platforms/host/host_parallel16.cpp
+// (all on one line)
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "host_test.hpp"
+
+static const uint16_t KEY = 0xF81F; // magenta, the transparent colour
+
+// the same picture in both panels
+static void background(MatrixPanel_I2S_DMA &panel, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      panel.drawPixelRGB888(x, y, (x * 5) & 0xFF, (y * 11) & 0xFF, ((x + y) * 3) & 0xFF);
+}
+
+struct place_t
+{
+  int x, y;
+};
+
+// inside, across the halves, and off the panel at every edge
+static const place_t PLACES[] = {{0, 0}, {5, 10}, {40, 20}, {-7, 3}, {3, -9}, {110, 25}, {60, 28}, {-20, -20}};
+
+static void run(const char *name, HUB75_I2S_CFG cfg, int scroll_x, int scroll_y)
+{
+  const int width = cfg.mx_width * cfg.chain_length, height = cfg.mx_height;
+  const int sw = 23, sh = 13;
+
+  cfg.hscroll = scroll_x != 0;
+  MatrixPanel_I2S_DMA panel(cfg), model(cfg);
+  CHECK(panel.begin() && model.begin());
+
+  for (MatrixPanel_I2S_DMA *p : {&panel, &model})
+  {
+    p->setBrightness8(150);
+    if (scroll_x)
+      CHECK(p->scrollHorizontal(scroll_x));
+    if (scroll_y)
+      CHECK(p->scrollVertical(scroll_y));
+    background(*p, width, height);
+  }
+
+  // an image with every so often a transparent pixel, as RGB565 and as RGB888
+  srand(5);
+  std::vector<uint16_t> image565(sw * sh);
+  std::vector<uint8_t> image888;
+  for (uint16_t &c : image565)
+  {
+    c = (rand() % 7) ? (uint16_t)rand() : KEY;
+    c = (c == KEY && image888.size() % 2) ? 0 : c; // some black too, which is drawn
+    uint8_t r, g, b;
+    MatrixPanel_I2S_DMA::color565to888(c, r, g, b);
+    image888.insert(image888.end(), {r, g, b});
+  }
+
+  BitplaneSprite opaque, keyed;
+  CHECK(panel.encodeSprite(opaque, image888.data(), sw, sh));
+  CHECK(panel.encodeSprite(keyed, image565.data(), sw, sh, KEY));
+  CHECK(opaque.depth == cfg.getPixelColorDepthBits() && opaque.storage.size() == (size_t)sw * sh * opaque.depth);
+
+  const std::vector<uint16_t> ctrl = controlBits(panel);
+
+  int matched = 0;
+  for (const place_t &at : PLACES)
+  {
+    const bool use_key = (&at - PLACES) % 2;
+
+    panel.drawSprite(use_key ? keyed : opaque, at.x, at.y);
+    for (int j = 0; j < sh; j++)
+      for (int i = 0; i < sw; i++)
+        if (!use_key || image565[j * sw + i] != KEY)
+          model.drawPixelRGB888(at.x + i, at.y + j, image888[(j * sw + i) * 3], image888[(j * sw + i) * 3 + 1], image888[(j * sw + i) * 3 + 2]);
+
+    bool same = (rawFrame(panel, width, height) == rawFrame(model, width, height)) && (controlBits(panel) == ctrl);
+    if (!same)
+      printf("%s: drawSprite(%d, %d)%s doesn't match\n", name, at.x, at.y, use_key ? " with transparency" : "");
+    matched += same;
+  }
+  CHECK(matched == (int)(sizeof(PLACES) / sizeof(PLACES[0])));
+
+  // drawIcon() as a whole lot of drawPixel()s
+  std::vector<int> icon(image565.begin(), image565.end());
+  panel.drawIcon(icon.data(), 30, 9, sw, sh);
+  for (int j = 0; j < sh; j++)
+    for (int i = 0; i < sw; i++)
+      model.drawPixel(30 + i, 9 + j, image565[j * sw + i]);
+  CHECK(rawFrame(panel, width, height) == rawFrame(model, width, height));
+
+#if defined(USE_SHADOW_BUFFER) && SHADOW_BYTES_PER_PIXEL == 3
+  // the shadow buffer encodes to the same frame again (an RGB565 one only to about the same)
+  const std::vector<uint16_t> drawn = rawFrame(panel, width, height);
+  panel.reencode();
+  CHECK(rawFrame(panel, width, height) == drawn);
+#endif
+
+  // the same bytes from an array of the sketch's, and not drawn if they're for another colour depth
+  const BitplaneSprite offline(sw, sh, opaque.depth, opaque.data), other(sw, sh, opaque.depth - 1, opaque.data);
+  panel.drawSprite(offline, 17, 6);
+  model.drawSprite(opaque, 17, 6);
+  panel.drawSprite(other, 0, 0);
+  CHECK(rawFrame(panel, width, height) == rawFrame(model, width, height));
+
+  // setColorDepth() only leaves bitplanes out, the sprite still draws
+  CHECK(panel.setColorDepth(cfg.getPixelColorDepthBits() - 1) && model.setColorDepth(cfg.getPixelColorDepthBits() - 1));
+  panel.drawSprite(keyed, 50, 1);
+  model.drawSprite(keyed, 50, 1);
+  CHECK(rawFrame(panel, width, height) == rawFrame(model, width, height));
+
+  printf("%-10s %dx%d, scrolled %d,%d: %d sprites\n", name, width, height, scroll_x, scroll_y, matched);
+}
+
+int main()
+{
+  for (const test_cfg_t &t : depthConfigs())
+  {
+    run(t.name, t.cfg, 0, 0);
+    run(t.name, t.cfg, 38, t.cfg.mx_height / 3); // even, for the ESP32 FIFO order
+  }
+
+  // nothing before begin()
+  MatrixPanel_I2S_DMA panel(HUB75_I2S_CFG(64, 32, 1));
+  BitplaneSprite sprite;
+  const uint16_t pixel = 0xFFFF;
+  CHECK(!panel.encodeSprite(sprite, &pixel, 1, 1) && sprite.data == nullptr);
+  panel.drawSprite(sprite, 0, 0);
+
+  return report();
+}
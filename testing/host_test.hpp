@@ -0,0 +1,85 @@
+// What the host_*.cpp tests share: CHECK(), reading back what a panel holds and sends, the panel setups most of them
+// run on, and the summary line their main() ends with. Include it after the library headers the test needs.
+
+#ifndef HOST_TEST_HPP
+#define HOST_TEST_HPP
+
+#include <cstdio>
+#include <vector>
+
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+
+static int failures = 0;
+
+#define CHECK(x) do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); failures++; } } while (0)
+
+static const uint16_t RGB_BITS = 0x3F;   // R1 G1 B1 R2 G2 B2
+static const uint16_t LAT_BIT  = 1 << 6;
+
+// the colour depth values of every pixel, three per pixel
+static inline std::vector<uint16_t> rawFrame(MatrixPanel_I2S_DMA &panel, int width, int height)
+{
+  std::vector<uint16_t> raw;
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+      uint16_t r = 0, g = 0, b = 0;
+      panel.getPixelRaw(x, y, r, g, b);
+      raw.insert(raw.end(), {r, g, b});
+    }
+  return raw;
+}
+
+// every word of the next frame sent
+static inline std::vector<uint16_t> frameWords(MatrixPanel_I2S_DMA &panel)
+{
+  std::vector<uint16_t> words;
+  panel.getHostBus().output_frame(&words);
+  return words;
+}
+
+// the control bits of every word of the next frame sent
+static inline std::vector<uint16_t> controlBits(MatrixPanel_I2S_DMA &panel)
+{
+  std::vector<uint16_t> words = frameWords(panel);
+  for (uint16_t &w : words)
+    w &= ~RGB_BITS;
+  return words;
+}
+
+struct test_cfg_t
+{
+  const char *name;
+  HUB75_I2S_CFG cfg;
+};
+
+// two panels chained at the default and the most colour depth, and one 1/32 scan panel at a few bitplanes
+static inline std::vector<test_cfg_t> depthConfigs()
+{
+  HUB75_I2S_CFG deep(64, 32, 2), shallow(64, 64, 1);
+  deep.setPixelColorDepthBits(12);
+  shallow.setPixelColorDepthBits(5);
+  return {{"8 bit", HUB75_I2S_CFG(64, 32, 2)}, {"12 bit", deep}, {"5 bit", shallow}};
+}
+
+// the driver / line decoder setups with the panel simulator's golden images, named after them
+static inline std::vector<test_cfg_t> driverConfigs()
+{
+  HUB75_I2S_CFG fm6126a(64, 32, 2), dp3246(64, 32, 2), sm5266p(64, 32, 1), scan32(64, 64, 1);
+  fm6126a.driver = HUB75_I2S_CFG::FM6126A;
+  dp3246.driver = HUB75_I2S_CFG::DP3246;
+  dp3246.line_decoder = HUB75_I2S_CFG::SM5368;
+  sm5266p.line_decoder = HUB75_I2S_CFG::SM5266P;
+  scan32.latch_blanking = 2; // 1/32 scan, with the E address line
+  return {{"shiftreg_138", HUB75_I2S_CFG(64, 32, 2)}, {"fm6126a_138", fm6126a}, {"dp3246_sm5368", dp3246},
+          {"shiftreg_sm5266p", sm5266p}, {"shiftreg_138_64", scan32}};
+}
+
+// the last line of every test, and its exit code
+static inline int report()
+{
+  printf(failures ? "%d check(s) failed\n" : "ok\n", failures);
+  return failures ? 1 : 0;
+}
+
+#endif
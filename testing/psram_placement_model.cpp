@@ -0,0 +1,134 @@
+// Host model of the PSRAM read bandwidth the DMA needs for each HUB75_I2S_CFG::psram_placement policy (SPIRAM_DMA_BUFFER)
+//
+// Per row, setupDMA() links every bitplane once, then each bitplane i above the lsbMsbTransitionBit another
+// 2^(i - lsbMsbTransitionBit - 1) times. So the DMA reads bitplane i (1 + that) times per row, and the few most
+// significant bitplanes make up nearly all of the data read.
+//
+// For a bitplane placement this works out:
+//  sram KB   : internal SRAM the bitplanes in SRAM take, for all the framebuffers
+//  psram %   : share of the output time the DMA is reading from PSRAM
+//  avg MB/s  : PSRAM read bandwidth that works out to, averaged over a frame
+//  gdma %    : avg MB/s against the half of the Octal PSRAM bandwidth the GDMA is sure to get when the CPUs use PSRAM too
+//
+// While a PSRAM bitplane is being sent the DMA still reads it at the full output rate, so the output clock limit
+// in the S3 backend stays. What drops is the time spent reading PSRAM, i.e. what is left of it for the CPUs.
+//
+// g++ -O2 -I../src -o psram_placement_model.exe psram_placement_model.cpp
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "HUB75Planner.hpp"
+
+static const double OUTPUT_CLOCK_HZ = 160000000.0 / 12; // LCD_CAM clock with the DMA buffer in PSRAM, see gdma_lcd_parallel16.cpp
+static const double PSRAM_MB_S = 160.0;                 // Octal PSRAM, 80MHz DDR x 8 bits
+static const double GDMA_MB_S = PSRAM_MB_S / 2;         // worst case GDMA share, round robin with the CPUs
+
+struct Panel
+{
+  int width, height, chain, depth, fbs;
+};
+
+// The lsbMsbTransitionBit begin() picks, at the HZ_8M clock it sets with SPIRAM_DMA_BUFFER
+static int transitionBit(const Panel &p, int min_refresh_rate)
+{
+  HUB75Planner::Config cfg;
+  cfg.mx_width = p.width;
+  cfg.mx_height = p.height;
+  cfg.chain_length = p.chain;
+  cfg.min_refresh_rate = min_refresh_rate;
+  cfg.setPixelColorDepthBits(p.depth);
+  cfg.spiram_dma_buffer = true;
+  return HUB75Planner::plan(cfg).transition_bit;
+}
+
+// How often each bitplane is sent per row
+static std::vector<int> planeSends(int depth, int t)
+{
+  std::vector<int> sends(depth, 1);
+  for (int i = t + 1; i < depth; i++)
+    sends[i] += 1 << (i - t - 1);
+  return sends;
+}
+
+struct Result
+{
+  double sram_kb, psram_share, avg_mb_s;
+};
+
+// 'sram_planes' most (msb) or least (!msb) significant bitplanes in SRAM, the rest in PSRAM
+static Result model(const Panel &p, const std::vector<int> &sends, int sram_planes, bool msb)
+{
+  const double frame_plane_bytes = (double)p.width * p.chain * 2 * (p.height / 2);
+
+  int total = 0, from_psram = 0;
+  for (int i = 0; i < p.depth; i++)
+  {
+    bool in_sram = msb ? (i >= p.depth - sram_planes) : (i < sram_planes);
+    total += sends[i];
+    if (!in_sram)
+      from_psram += sends[i];
+  }
+
+  Result r;
+  r.sram_kb = sram_planes * frame_plane_bytes * p.fbs / 1024;
+  r.psram_share = (double)from_psram / total;
+  r.avg_mb_s = r.psram_share * OUTPUT_CLOCK_HZ * 2 / 1e6;
+  return r;
+}
+
+static void printPolicies(const Panel &p, int min_refresh_rate)
+{
+  int t = transitionBit(p, min_refresh_rate);
+  std::vector<int> sends = planeSends(p.depth, t);
+
+  printf("\n%dx%d x%d, %d bit, %d framebuffer(s), lsbMsbTransitionBit %d, sends per row:", p.width, p.height, p.chain, p.depth, p.fbs, t);
+  for (int s : sends)
+    printf(" %d", s);
+  printf("\n");
+
+  printf("sram planes|sram KB|PSRAM_LSB_PLANES psram %%|avg MB/s|gdma %%|PSRAM_MSB_PLANES psram %%|avg MB/s|gdma %%\n");
+  for (int n = 0; n <= p.depth; n++)
+  {
+    Result lsb = model(p, sends, n, true), msb = model(p, sends, n, false);
+    printf("%d|%.1f|%.1f|%.1f|%.0f|%.1f|%.1f|%.0f\n", n, lsb.sram_kb,
+           lsb.psram_share * 100, lsb.avg_mb_s, lsb.avg_mb_s / GDMA_MB_S * 100,
+           msb.psram_share * 100, msb.avg_mb_s, msb.avg_mb_s / GDMA_MB_S * 100);
+  }
+}
+
+// With a fixed internal SRAM budget for the bitplanes, as setupDMA() would place them for PSRAM_LSB_PLANES
+static void printChains(int width, int height, int depth, int fbs, double sram_budget_kb, int min_refresh_rate)
+{
+  printf("\n%dx%d panels, %d bit, %d framebuffer(s), %.0f KB of SRAM for bitplanes\n", width, height, depth, fbs, sram_budget_kb);
+  printf("chain|bitplanes KB|all in SRAM|sram planes|psram %% all|psram %% hybrid|avg MB/s all|avg MB/s hybrid\n");
+
+  for (int chain = 1; chain <= 8; chain++)
+  {
+    Panel p{width, height, chain, depth, fbs};
+    std::vector<int> sends = planeSends(depth, transitionBit(p, min_refresh_rate));
+
+    double frame_plane_kb = (double)width * chain * 2 * (height / 2) * fbs / 1024;
+    int n = (int)(sram_budget_kb / frame_plane_kb);
+    n = (n > depth) ? depth : n;
+
+    Result all = model(p, sends, 0, true), hybrid = model(p, sends, n, true);
+    printf("%d|%.0f|%s|%d|%.1f|%.1f|%.1f|%.1f\n", chain, frame_plane_kb * depth, (n == depth) ? "yes" : "no", n,
+           all.psram_share * 100, hybrid.psram_share * 100, all.avg_mb_s, hybrid.avg_mb_s);
+  }
+}
+
+int main()
+{
+  printf("Output clock %.2f MHz, %.1f MB/s while reading a bitplane, GDMA worst case share of PSRAM %.0f MB/s\n",
+         OUTPUT_CLOCK_HZ / 1e6, OUTPUT_CLOCK_HZ * 2 / 1e6, GDMA_MB_S);
+
+  printPolicies(Panel{64, 64, 4, 8, 1}, 60);
+  printPolicies(Panel{64, 64, 4, 10, 2}, 60);
+
+  printChains(64, 64, 8, 1, 160, 60);
+  printChains(64, 64, 10, 2, 160, 60);
+
+  return 0;
+}
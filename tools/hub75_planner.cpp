@@ -0,0 +1,121 @@
+// Command line front end to src/HUB75Planner.hpp: refresh rate, effective colour depth and DMA memory
+// of a panel setup for every colour depth and clock, and the best one for a RAM budget.
+//
+// g++ -O2 -I../src -o hub75_planner hub75_planner.cpp
+//
+// hub75_planner <panel width> <panel height> <chain length> [options]
+//   -d <bits>     colour depth to show the plan for (default 8)
+//   -r <hz>       min_refresh_rate (default 60)
+//   -c <hz>       output clock (default 8000000)
+//   -b <bytes>    RAM budget, adds the best colour depth / clock within it
+//   -2 / -3       double / triple buffering
+//   -h            hscroll
+//   -p <policy>   bitplanes in PSRAM (SPIRAM_DMA_BUFFER, the clock is 8 MHz then), psram_placement all, lsb or msb
+//   -a            table of every colour depth and clock
+//
+// e.g. hub75_planner 64 64 4 -2 -b 150000 -a
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "HUB75Planner.hpp"
+
+static void usage()
+{
+  fprintf(stderr, "usage: hub75_planner <panel width> <panel height> <chain length> [-d bits] [-r hz] [-c hz] [-b bytes] [-2|-3] [-h] [-p all|lsb|msb] [-a]\n");
+  exit(1);
+}
+
+static void printHeader()
+{
+  printf("depth|clock MHz|transition bit|effective depth|refresh Hz|meets min|framebuffers|framebuffer bytes|descriptors|descriptor bytes|total bytes\n");
+}
+
+static void printPlan(const HUB75Planner::plan_t &p)
+{
+  printf("%d|%.0f|%d|%d|%d|%s|%d|%zu|%zu|%zu|%zu\n", p.colour_depth, p.clock_hz / 1e6, p.transition_bit, p.effective_colour_depth,
+         p.refresh_rate, p.meets_min_refresh_rate ? "yes" : "no", p.framebuffers, p.framebuffer_bytes, p.dma_descriptors, p.dma_descriptor_bytes, p.total_bytes);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 4)
+    usage();
+
+  HUB75Planner::Config cfg;
+  cfg.mx_width = atoi(argv[1]);
+  cfg.mx_height = atoi(argv[2]);
+  cfg.chain_length = atoi(argv[3]);
+
+  long budget = -1;
+  bool all = false;
+
+  for (int i = 4; i < argc; i++)
+  {
+    const char *opt = argv[i];
+    const bool has_value = (i + 1 < argc);
+
+    if (!strcmp(opt, "-d") && has_value)
+      cfg.pixel_color_depth_bits = atoi(argv[++i]);
+    else if (!strcmp(opt, "-r") && has_value)
+      cfg.min_refresh_rate = atoi(argv[++i]);
+    else if (!strcmp(opt, "-c") && has_value)
+      cfg.i2sspeed = atol(argv[++i]);
+    else if (!strcmp(opt, "-b") && has_value)
+      budget = atol(argv[++i]);
+    else if (!strcmp(opt, "-2"))
+      cfg.double_buff = true;
+    else if (!strcmp(opt, "-3"))
+      cfg.double_buff = cfg.triple_buff = true;
+    else if (!strcmp(opt, "-h"))
+      cfg.hscroll = true;
+    else if (!strcmp(opt, "-p") && has_value)
+    {
+      const char *policy = argv[++i];
+      cfg.spiram_dma_buffer = true;
+      cfg.psram_placement = !strcmp(policy, "lsb") ? 1 : !strcmp(policy, "msb") ? 2 : 0; // HUB75_I2S_CFG::psram_policy
+      if (strcmp(policy, "all") && cfg.psram_placement == 0)
+        usage();
+    }
+    else if (!strcmp(opt, "-a"))
+      all = true;
+    else
+      usage();
+  }
+
+  if (cfg.mx_width == 0 || cfg.chain_length == 0 || cfg.mx_height < HUB75Planner::ROWS_IN_PARALLEL || cfg.mx_height % HUB75Planner::ROWS_IN_PARALLEL ||
+      cfg.pixel_color_depth_bits < HUB75Planner::MIN_COLOUR_DEPTH || cfg.pixel_color_depth_bits > HUB75Planner::MAX_COLOUR_DEPTH || cfg.i2sspeed == 0)
+    usage();
+
+  printf("%dx%d px (%d x %dx%d panels), min refresh rate %d Hz\n\n", cfg.mx_width * cfg.chain_length, cfg.mx_height, cfg.chain_length,
+         cfg.mx_width, cfg.mx_height, cfg.min_refresh_rate);
+
+  printHeader();
+  printPlan(HUB75Planner::plan(cfg));
+
+  if (all)
+  {
+    printf("\nAll colour depths and clocks:\n");
+    printHeader();
+    for (const HUB75Planner::plan_t &p : HUB75Planner::planAll(cfg))
+      printPlan(p);
+  }
+
+  if (budget >= 0)
+  {
+    HUB75Planner::plan_t best;
+    printf("\nBest within %ld bytes:\n", budget);
+
+    if (!HUB75Planner::best(cfg, budget, best))
+    {
+      printf("nothing fits\n");
+      return 2;
+    }
+
+    printHeader();
+    printPlan(best);
+  }
+
+  return 0;
+}